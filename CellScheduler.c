@@ -0,0 +1,47 @@
+/*
+ * CellScheduler.c
+ *
+ * Cost ordered dynamic scheduling of the grid cells in the time loop, see CellScheduler.h.
+ */
+
+#include <algorithm>
+#include "vicNl.h"
+
+#define CELL_SCHEDULE_INTERVAL 24  /* time steps between re-orderings of the cells */
+
+// Relative cost of one time step of a cell, until it has been timed.
+static double estimate_cell_cost(const cell_info_struct& cell, const ProgramState* state) {
+  if (!cell.isValid) return 0;
+  double cost = 0;
+  for (unsigned int i = 0; i < cell.prcp.activeHRUs.size(); i++) {
+    // The soil thermal nodes dominate an HRU with frozen soil.
+    cost += (state->options.FROZEN_SOIL && cell.soil_con.FS_ACTIVE) ? state->options.Nnode : 1;
+  }
+  cost += cell.prcp.glacierHRUs.size();
+  if (state->options.LAKES && cell.lake_con.lake_idx >= 0) cost += state->options.Nlakenode;
+  return cost;
+}
+
+CellScheduler::CellScheduler(const std::vector<cell_info_struct>& cells, const ProgramState* state)
+    : order(cells.size()), cost(cells.size()), elapsed(cells.size(), 0.), nextUpdate(0) {
+  for (unsigned int cellidx = 0; cellidx < cells.size(); cellidx++) {
+    cost[cellidx] = estimate_cell_cost(cells[cellidx], state);
+  }
+  sort();
+}
+
+void CellScheduler::update(int rec) {
+  if (rec < nextUpdate) return;
+  nextUpdate = (rec / CELL_SCHEDULE_INTERVAL + 1) * CELL_SCHEDULE_INTERVAL;
+  cost.swap(elapsed);
+  std::fill(elapsed.begin(), elapsed.end(), 0.);
+  sort();
+}
+
+void CellScheduler::sort() {
+  // Ties keep the cells in their original order, for a stable order between runs.
+  for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return cost[a] > cost[b]; });
+}
+
+#undef CELL_SCHEDULE_INTERVAL
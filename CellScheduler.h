@@ -0,0 +1,40 @@
+/*
+ * CellScheduler.h
+ *
+ * Order in which the time loop hands the grid cells to the OpenMP threads. The cost of a
+ * time step differs by orders of magnitude between cells (number of HRUs and snow bands,
+ * glaciers, lakes, frozen soil), so a static split of the cells leaves most threads waiting
+ * for the one with the expensive cells. Instead the cells are handed out with a dynamic
+ * schedule, the most expensive first (longest processing time first), so that the threads
+ * finish each time step together.
+ *
+ * Until the cells have been timed their cost is estimated from their HRUs. After that the
+ * wall time of each cell, summed over CELL_SCHEDULE_INTERVAL time steps, is used, so the order
+ * follows the seasons (e.g. snow cover). The order does not affect the results.
+ */
+
+#ifndef CELLSCHEDULER_H_
+#define CELLSCHEDULER_H_
+
+#include <vector>
+
+class CellScheduler {
+public:
+  CellScheduler(const std::vector<cell_info_struct>& cells, const ProgramState* state);
+  int size() const { return order.size(); }
+  // Index (into the cells) of the i-th cell to process.
+  int cell(int i) const { return order[i]; }
+  // Adds the wall time of one time step of a cell. Cells are timed by the thread which ran them.
+  void record(int cellidx, double seconds) { elapsed[cellidx] += seconds; }
+  // Called after all cells have completed time step rec (the last step of a TIME_BLOCK): re-orders
+  // the cells by their measured cost after the first step, and every CELL_SCHEDULE_INTERVAL steps after that.
+  void update(int rec);
+private:
+  void sort();
+  std::vector<int> order;
+  std::vector<double> cost;
+  std::vector<double> elapsed;  // wall time of each cell since the last update
+  int nextUpdate;  // first time step after which the cells are re-ordered again
+};
+
+#endif /* CELLSCHEDULER_H_ */
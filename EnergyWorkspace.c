@@ -0,0 +1,17 @@
+#include "vicNl.h"
+
+thread_local EnergyWorkspace EnergyWorkspace::current;
+
+energy_bal_struct& EnergyWorkspace::energy_copy(int i, int Nnode) {
+  if (Nnode > energyCopyNodes) {
+    // Nnode is the same for all cells, so this only happens on the first call of each thread.
+    energyCopyNodes = Nnode;
+    const size_t bytes = energy_nodes_size(Nnode);
+    energyCopyStorage.assign(NUM_ENERGY_COPIES * bytes / sizeof(double), 0.);
+    char* storage = (char*) energyCopyStorage.data();
+    for (int copy = 0; copy < NUM_ENERGY_COPIES; copy++) {
+      storage = attach_energy_nodes(&energyCopies[copy], storage, Nnode);
+    }
+  }
+  return energyCopies[i];
+}
@@ -0,0 +1,53 @@
+/*
+ * EnergyWorkspace.h
+ *
+ * Scratch space of full_energy() and the surface flux routines it calls. It is
+ * kept per thread in EnergyWorkspace::current and reused from one call to the
+ * next, so that the time loop does not allocate.
+ */
+
+#ifndef ENERGYWORKSPACE_H_
+#define ENERGYWORKSPACE_H_
+
+#include <vector>
+
+class EnergyWorkspace {
+public:
+  EnergyWorkspace() : numHRUs(0), energyCopyNodes(0) {}
+
+  // Makes room for cells of up to maxHRUs HRUs (state->max_num_HRUs). The buffers
+  // only grow, so this is a no-op once the largest cell has been seen.
+  void reserve(int maxHRUs) {
+    if (maxHRUs > numHRUs) {
+      numHRUs = maxHRUs;
+      moistPrior.assign(2 * numHRUs * MAX_LAYERS, 0.);
+      evapPrior.assign(2 * numHRUs * MAX_LAYERS, 0.);
+    }
+  }
+
+  // Soil layer moisture and evaporation of an HRU at the start of the time step
+  // (mm), for the subsidence calculations. dist is WET or DRY.
+  double* moist_prior(int dist, int hruIndex) { return &moistPrior[(dist * numHRUs + hruIndex) * MAX_LAYERS]; }
+  double* evap_prior(int dist, int hruIndex) { return &evapPrior[(dist * numHRUs + hruIndex) * MAX_LAYERS]; }
+
+  // Copy i (of NUM_ENERGY_COPIES) of an energy balance structure in surface_fluxes() and
+  // surface_fluxes_glac(), with node storage for Nnode soil thermal nodes.
+  energy_bal_struct& energy_copy(int i, int Nnode);
+
+  VegConditions  aero_resist[N_PET_TYPES + 1];   // full_energy(): current veg is last
+  AeroResistUsed step_aero_resist[N_PET_TYPES];  // surface_fluxes(), surface_fluxes_glac()
+
+  // Workspace of the calling thread.
+  static thread_local EnergyWorkspace current;
+
+private:
+  int numHRUs;
+  std::vector<double> moistPrior;
+  std::vector<double> evapPrior;
+  static const int NUM_ENERGY_COPIES = 4;
+  energy_bal_struct energyCopies[NUM_ENERGY_COPIES];
+  int energyCopyNodes;
+  std::vector<double> energyCopyStorage;
+};
+
+#endif /* ENERGYWORKSPACE_H_ */
@@ -40,7 +40,7 @@ public:
   double *SensibleHeat,           /* Sensible heat exchange at surface (W/m2) */
   double *vapor_flux             /* Mass flux of water vapor to or from the intercepted snow (m/timestep) */
   ) :
-      Dt(Dt), Ra(Ra), Ra_used(Ra_used), Displacement(Displacement), Z(Z),
+      RootBrent(SOLVER_TGLACSURF), Dt(Dt), Ra(Ra), Ra_used(Ra_used), Displacement(Displacement), Z(Z),
       roughness(roughness), AirDens(AirDens), EactAir(EactAir), LongSnowIn(LongSnowIn),
       Lv(Lv), Press(Press), Rain(Rain), NetShortUnder(NetShortUnder), Vpd(Vpd),
       Wind(Wind), OldTSurf(OldTSurf), IceDepth(IceDepth), IceWE(IceWE),
@@ -41,7 +41,7 @@ public:
                     double* LatentHeatSub,       /* Latent heat exchange at surface (W/m2) due to sublimation */
                     double* SensibleHeat,        /* Sensible heat exchange at surface (W/m2) */
                     double* LongRadOut) :
-      Dt(Dt), Ra(Ra), Ra_used(Ra_used), Z(Z), Displacement(Displacement), Z0(Z0), Wind(Wind), ShortRad(ShortRad),
+      RootBrent(SOLVER_TICESURF), Dt(Dt), Ra(Ra), Ra_used(Ra_used), Z(Z), Displacement(Displacement), Z0(Z0), Wind(Wind), ShortRad(ShortRad),
       LongRadIn(LongRadIn), AirDens(AirDens), Lv(Lv), Tair(Tair), Press(Press), Vpd(Vpd), EactAir(EactAir), Rain(Rain),
       SweSurfaceLayer(SweSurfaceLayer), SurfaceLiquidWater(SurfaceLiquidWater), OldTSurf(OldTSurf), RefreezeEnergy(RefreezeEnergy),
       vapor_flux(vapor_flux), blowing_flux(blowing_flux), surface_flux(surface_flux), AdvectedEnergy(AdvectedEnergy),
@@ -0,0 +1,291 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <netcdf.h>
+
+#include "vicNl.h"
+#include "NetCDFForcingReader.h"
+
+static char vcid[] = "$Id$";
+
+// Upper limit on the memory used by one block of forcing values.
+static const size_t MAX_BLOCK_BYTES = 256 * 1024 * 1024;
+
+static void checkNetCDF(int ncerr, const char* what, const char* name) {
+  if (ncerr != NC_NOERR) {
+    char ErrStr[MAXSTRING];
+    sprintf(ErrStr, "Error reading NetCDF forcing file, %s %s: %s", what, name, nc_strerror(ncerr));
+    nrerror(ErrStr);
+  }
+}
+
+// Reads a one dimensional coordinate variable, and sorts its values (keeping their indices) for searching.
+static size_t readCoordinate(int ncid, const char* name, std::vector<std::pair<double, int> >& sorted) {
+  int varid, ndims, dimid;
+  size_t length, start = 0;
+  checkNetCDF(nc_inq_varid(ncid, name, &varid), "finding variable", name);
+  checkNetCDF(nc_inq_varndims(ncid, varid, &ndims), "checking variable", name);
+  if (ndims != 1) {
+    checkNetCDF(NC_EINVAL, "coordinate variable is not one dimensional:", name);
+  }
+  checkNetCDF(nc_inq_vardimid(ncid, varid, &dimid), "checking variable", name);
+  checkNetCDF(nc_inq_dimlen(ncid, dimid, &length), "checking variable", name);
+  std::vector<double> values(length);
+  if (length > 0) {
+    checkNetCDF(nc_get_vara_double(ncid, varid, &start, &length, &values[0]), "reading variable", name);
+  }
+  sorted.clear();
+  for (size_t i = 0; i < length; i++) {
+    sorted.push_back(std::make_pair(values[i], (int) i));
+  }
+  std::sort(sorted.begin(), sorted.end());
+  return length;
+}
+
+NetCDFForcingReader::NetCDFForcingReader(const char* filename, int file_num, const std::vector<cell_info_struct>& cells, const ProgramState* state)
+  : state(state), file_num(file_num) {
+  char ErrStr[MAXSTRING];
+  int ndims, timedimid, dimids[3];
+
+  if (nc_open(filename, NC_NOWRITE, &ncid) != NC_NOERR) {
+    sprintf(ErrStr, "Unable to open NetCDF forcing file %s", filename);
+    nrerror(ErrStr);
+  }
+
+  /* time steps of the simulation, see read_atmos_data() */
+  size_t skip = (size_t) ((int) ((float) (state->global_param.dt * state->global_param.forceskip[file_num])) / (float) state->param_set.FORCE_DT[file_num]);
+  int nsteps = state->global_param.nrecs * state->global_param.dt / state->param_set.FORCE_DT[file_num];
+
+  int timevarid;
+  checkNetCDF(nc_inq_varid(ncid, "time", &timevarid), "finding variable", "time");
+  checkNetCDF(nc_inq_varndims(ncid, timevarid, &ndims), "checking variable", "time");
+  checkNetCDF(nc_inq_vardimid(ncid, timevarid, &timedimid), "checking variable", "time");
+  checkNetCDF(nc_inq_dimlen(ncid, timedimid, &ntimes), "checking variable", "time");
+  if (skip + nsteps > ntimes) {
+    sprintf(ErrStr, "Not enough records in NetCDF forcing file %i (%i) to run the number of records defined in the global file (%i from record %i).  Check forcing file time step, and global file",
+        file_num + 1, (int) ntimes, nsteps, (int) skip);
+    nrerror(ErrStr);
+  }
+
+  size_t nlats = readCoordinate(ncid, "lat", sortedLats);
+  readCoordinate(ncid, "lon", sortedLons);
+
+  // The soil file coordinates are given to GRID_DECIMAL places, and the file coordinates may be stored as floats.
+  tolerance = std::max(0.5 * pow(10.0, -state->options.GRID_DECIMAL), 1e-5);
+
+  /* find and check the forcing variables */
+  nfields = state->param_set.N_TYPES[file_num];
+  varids.resize(nfields);
+  for (int varidx = 0; varidx < nfields; varidx++) {
+    std::string variableKey = std::string(state->param_set.TYPE[state->param_set.FORCE_INDEX[file_num][varidx]].varname);
+    if (state->forcing_mapping.find(variableKey) == state->forcing_mapping.end()) {
+      throw VICException("Error: could not find forcing variable in forcing_mapping: " + variableKey);
+    }
+    std::string varName = state->forcing_mapping.at(variableKey);
+    checkNetCDF(nc_inq_varid(ncid, varName.c_str(), &varids[varidx]), "finding variable", varName.c_str());
+    checkNetCDF(nc_inq_varndims(ncid, varids[varidx], &ndims), "checking variable", varName.c_str());
+    if (ndims != 3) {
+      checkNetCDF(NC_EINVAL, "variable is not dimensioned (time, lat, lon):", varName.c_str());
+    }
+    checkNetCDF(nc_inq_vardimid(ncid, varids[varidx], dimids), "checking variable", varName.c_str());
+    if (dimids[0] != timedimid) {
+      checkNetCDF(NC_EINVAL, "variable is not dimensioned (time, lat, lon):", varName.c_str());
+    }
+  }
+
+  /* group the rows that contain cells into blocks */
+  std::map<size_t, std::pair<size_t, size_t> > rowLons; // lat index -> lon index range of its cells
+  std::map<size_t, int> rowCells;
+  for (unsigned int i = 0; i < cells.size(); i++) {
+    int latidx = findIndex(sortedLats, cells[i].soil_con.lat);
+    int lonidx = findIndex(sortedLons, cells[i].soil_con.lng);
+    if (latidx < 0 || lonidx < 0) {
+      continue; // reported when the cell is read
+    }
+    if (rowLons.find(latidx) == rowLons.end()) {
+      rowLons[latidx] = std::make_pair((size_t) lonidx, (size_t) lonidx);
+    }
+    rowLons[latidx].first = std::min(rowLons[latidx].first, (size_t) lonidx);
+    rowLons[latidx].second = std::max(rowLons[latidx].second, (size_t) lonidx);
+    rowCells[latidx]++;
+  }
+  blockOfRow.assign(nlats, -1);
+  int stepsPerLoad = nsteps;
+  if (state->global_param.forcing_window > 0) {
+    stepsPerLoad = std::min(nsteps, (state->global_param.forcing_window + 2 * FORCING_WINDOW_MARGIN) * 24 / state->param_set.FORCE_DT[file_num]);
+  }
+  size_t bytesPerValue = sizeof(double) * nfields * stepsPerLoad;
+  for (std::map<size_t, std::pair<size_t, size_t> >::iterator it = rowLons.begin(); it != rowLons.end(); ++it) {
+    if (!blocks.empty()) {
+      Block& last = blocks.back();
+      size_t firstLon = std::min(last.firstLon, it->second.first);
+      size_t lastLon = std::max(last.firstLon + last.numLons - 1, it->second.second);
+      size_t numLats = it->first - last.firstLat + 1;
+      if (numLats * (lastLon - firstLon + 1) * bytesPerValue <= MAX_BLOCK_BYTES) {
+        last.numLats = numLats;
+        last.firstLon = firstLon;
+        last.numLons = lastLon - firstLon + 1;
+        last.numCells += rowCells[it->first];
+        blockOfRow[it->first] = blocks.size() - 1;
+        continue;
+      }
+    }
+    Block block;
+    block.firstLat = it->first;
+    block.numLats = 1;
+    block.firstLon = it->second.first;
+    block.numLons = it->second.second - it->second.first + 1;
+    block.numCells = rowCells[it->first];
+    blocks.push_back(block);
+    blockOfRow[it->first] = blocks.size() - 1;
+  }
+}
+
+NetCDFForcingReader::~NetCDFForcingReader() {
+  nc_close(ncid);
+}
+
+// Index of the coordinate nearest to value, or -1 if none is within the tolerance.
+int NetCDFForcingReader::findIndex(const std::vector<std::pair<double, int> >& sorted, double value) const {
+  std::vector<std::pair<double, int> >::const_iterator it =
+      std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(value, -1));
+  int best = -1;
+  double bestDiff = tolerance;
+  if (it != sorted.end() && fabs(it->first - value) <= bestDiff) {
+    best = it->second;
+    bestDiff = fabs(it->first - value);
+  }
+  if (it != sorted.begin() && fabs((it - 1)->first - value) <= bestDiff) {
+    best = (it - 1)->second;
+  }
+  return best;
+}
+
+// Reads numSteps time steps of one variable for all rows and columns of the block into values (time, lat, lon).
+void NetCDFForcingReader::readVariable(int varidx, const Block& block, size_t firstStep, int numSteps, double* values) {
+  int storage;
+  nc_type vartype;
+  size_t chunksizes[3];
+  float scale_factor = NAN, inverse_scale_factor = NAN;
+  int has_inverse_scale_factor = 0;
+  const char* name = state->param_set.TYPE[state->param_set.FORCE_INDEX[file_num][varidx]].varname;
+
+  checkNetCDF(nc_inq_vartype(ncid, varids[varidx], &vartype), "checking variable", name);
+  if (vartype == NC_SHORT || vartype == NC_USHORT) {
+    // Legacy VIC integer type input with scaling factors, for backward compatibility
+    if (nc_get_att_float(ncid, varids[varidx], "inverse_scale_factor", &inverse_scale_factor) == NC_NOERR)
+      has_inverse_scale_factor = 1;
+    else
+      checkNetCDF(nc_get_att_float(ncid, varids[varidx], "scale_factor", &scale_factor), "reading scale_factor of", name);
+  } else if (vartype != NC_FLOAT && vartype != NC_DOUBLE) {
+    checkNetCDF(NC_EBADTYPE, "type not supported for variable", name);
+  }
+
+  // Read one time chunk of the file at a time, so that each read maps onto whole chunks.
+  size_t timeChunk = numSteps;
+  if (nc_inq_var_chunking(ncid, varids[varidx], &storage, chunksizes) == NC_NOERR && storage == NC_CHUNKED && chunksizes[0] > 0) {
+    timeChunk = chunksizes[0];
+  }
+
+  size_t endStep = firstStep + numSteps;
+  size_t stepValues = block.numLats * block.numLons;
+  std::vector<short> shortData;
+  std::vector<unsigned short> ushortData;
+  std::vector<float> floatData;
+  for (size_t t = firstStep; t < endStep; ) {
+    size_t tEnd = std::min((t / timeChunk + 1) * timeChunk, endStep);
+    size_t starts[3] = { t, block.firstLat, block.firstLon };
+    size_t counts[3] = { tEnd - t, block.numLats, block.numLons };
+    size_t n = counts[0] * stepValues;
+    double* out = values + (t - firstStep) * stepValues;
+    switch (vartype) {
+    case NC_SHORT:
+      shortData.resize(n);
+      checkNetCDF(nc_get_vara_short(ncid, varids[varidx], starts, counts, &shortData[0]), "reading variable", name);
+      /* Implemented for numerically-identical operation to classic VIC input */
+      for (size_t i = 0; i < n; i++)
+        out[i] = has_inverse_scale_factor ? (double) shortData[i] / inverse_scale_factor : (double) shortData[i] * scale_factor;
+      break;
+    case NC_USHORT:
+      ushortData.resize(n);
+      checkNetCDF(nc_get_vara_ushort(ncid, varids[varidx], starts, counts, &ushortData[0]), "reading variable", name);
+      for (size_t i = 0; i < n; i++)
+        out[i] = has_inverse_scale_factor ? (double) ushortData[i] / inverse_scale_factor : (double) ushortData[i] * scale_factor;
+      break;
+    case NC_FLOAT:
+      floatData.resize(n);
+      checkNetCDF(nc_get_vara_float(ncid, varids[varidx], starts, counts, &floatData[0]), "reading variable", name);
+      for (size_t i = 0; i < n; i++)
+        out[i] = (double) floatData[i];
+      break;
+    case NC_DOUBLE:
+      checkNetCDF(nc_get_vara_double(ncid, varids[varidx], starts, counts, out), "reading variable", name);
+      break;
+    }
+    t = tEnd;
+  }
+}
+
+void NetCDFForcingReader::readBlock(const Block& block, LoadedBlock& loaded) {
+  size_t fieldValues = (size_t) loaded.numSteps * block.numLats * block.numLons;
+  loaded.values.resize(nfields * fieldValues);
+  fprintf(stderr, "Reading NetCDF forcing file %i, slice [%d..%d,%d..%d,%d..%d] ... ", file_num + 1,
+      (int) loaded.firstStep, (int) (loaded.firstStep + loaded.numSteps - 1),
+      (int) block.firstLat, (int) (block.firstLat + block.numLats - 1),
+      (int) block.firstLon, (int) (block.firstLon + block.numLons - 1));
+  for (int varidx = 0; varidx < nfields; varidx++) {
+    readVariable(varidx, block, loaded.firstStep, loaded.numSteps, &loaded.values[varidx * fieldValues]);
+  }
+  fprintf(stderr, "done\n");
+}
+
+void NetCDFForcingReader::readCell(const soil_con_struct* soil_con, double** forcing_data, size_t firstStep, int numSteps) {
+  char ErrStr[MAXSTRING];
+  int latidx = findIndex(sortedLats, soil_con->lat);
+  int lonidx = findIndex(sortedLons, soil_con->lng);
+  int blockidx = latidx < 0 ? -1 : blockOfRow[latidx];
+  if (lonidx < 0 || blockidx < 0) {
+    sprintf(ErrStr, "Unable to find cell %i (lat %f, lon %f) in NetCDF forcing file %i", soil_con->gridcel, soil_con->lat, soil_con->lng, file_num + 1);
+    nrerror(ErrStr);
+  }
+  if (firstStep + numSteps > ntimes) {
+    sprintf(ErrStr, "Not enough records in NetCDF forcing file %i (%i) to read records %i to %i", file_num + 1, (int) ntimes, (int) firstStep, (int) (firstStep + numSteps - 1));
+    nrerror(ErrStr);
+  }
+  const Block& block = blocks[blockidx];
+
+#if PARALLEL_AVAILABLE
+#pragma omp critical(netcdf_forcing)
+#endif
+  {
+    // A block loaded for other time steps is left over from the previous forcing window.
+    std::map<int, LoadedBlock>::iterator loaded = loadedBlocks.find(blockidx);
+    if (loaded != loadedBlocks.end() && (loaded->second.firstStep != firstStep || loaded->second.numSteps != numSteps)) {
+      loadedBlocks.erase(loaded);
+      loaded = loadedBlocks.end();
+    }
+    if (loaded == loadedBlocks.end()) {
+      loaded = loadedBlocks.insert(std::make_pair(blockidx, LoadedBlock())).first;
+      loaded->second.firstStep = firstStep;
+      loaded->second.numSteps = numSteps;
+      loaded->second.cellsRead = 0;
+      readBlock(block, loaded->second);
+    }
+
+    size_t stepValues = block.numLats * block.numLons;
+    size_t offset = (latidx - block.firstLat) * block.numLons + (lonidx - block.firstLon);
+    for (int varidx = 0; varidx < nfields; varidx++) {
+      const double* values = &loaded->second.values[(size_t) varidx * numSteps * stepValues + offset];
+      double* out = forcing_data[state->param_set.FORCE_INDEX[file_num][varidx]];
+      for (int rec = 0; rec < numSteps; rec++) {
+        out[rec] = values[rec * stepValues];
+      }
+    }
+
+    // Free the block once all of its cells have been read.
+    if (++loaded->second.cellsRead >= block.numCells) {
+      loadedBlocks.erase(loaded);
+    }
+  }
+}
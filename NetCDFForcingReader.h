@@ -0,0 +1,56 @@
+#ifndef NETCDFFORCINGREADER_H_
+#define NETCDFFORCINGREADER_H_
+
+#include <map>
+#include <vector>
+
+#include "vicNl_def.h"
+
+/*
+ * Reads the forcings of all cells from one NetCDF forcing file (variables dimensioned time, lat, lon).
+ * The file is opened once, and the lat/lon coordinates are read once and matched to the cells with a
+ * tolerance (rather than exact floating point comparison). The cells are grouped into blocks of
+ * neighbouring latitude rows; the first time a cell of a block asks for its forcings, every variable
+ * is read for the whole block (all rows and the lon range spanned by its cells) with a few large
+ * hyperslab reads, following the time chunking of the file. The other cells of the block are then
+ * served from memory, and the block is freed once all of its cells have been served. When the
+ * forcings are streamed (FORCING_WINDOW), this happens again for each window of time steps.
+ */
+class NetCDFForcingReader {
+public:
+  NetCDFForcingReader(const char* filename, int file_num, const std::vector<cell_info_struct>& cells, const ProgramState* state);
+  ~NetCDFForcingReader();
+  // Copies numSteps forcing values from time index firstStep of the cell at the location of soil_con
+  // into forcing_data, in the same way as read_atmos_data().
+  void readCell(const soil_con_struct* soil_con, double** forcing_data, size_t firstStep, int numSteps);
+private:
+  struct Block {
+    size_t firstLat, numLats;
+    size_t firstLon, numLons;
+    int numCells;
+  };
+  struct LoadedBlock {
+    size_t firstStep;
+    int numSteps;
+    int cellsRead;
+    std::vector<double> values;  // (field, time, lat, lon)
+  };
+  int findIndex(const std::vector<std::pair<double, int> >& sorted, double value) const;
+  void readBlock(const Block& block, LoadedBlock& loaded);
+  void readVariable(int varidx, const Block& block, size_t firstStep, int numSteps, double* values);
+
+  const ProgramState* state;
+  int ncid;
+  int file_num;
+  size_t ntimes;
+  int nfields;
+  std::vector<int> varids;
+  double tolerance;  // Maximum difference between a cell's coordinates and the file coordinates.
+  std::vector<std::pair<double, int> > sortedLats;
+  std::vector<std::pair<double, int> > sortedLons;
+  std::vector<Block> blocks;
+  std::vector<int> blockOfRow;                       // Block for each lat index, or -1.
+  std::map<int, LoadedBlock> loadedBlocks;
+};
+
+#endif /* NETCDFFORCINGREADER_H_ */
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "vicNl.h"
+#include "ParamFileIndex.h"
+
+static char vcid[] = "$Id$";
+
+// Advances the file past the end of the current line. Returns false if already at the end of the file.
+static bool skipLine(FILE* file) {
+  int c = getc(file);
+  if (c == EOF) {
+    return false;
+  }
+  while (c != '\n' && c != EOF) {
+    c = getc(file);
+  }
+  return true;
+}
+
+void ParamFileIndex::addCell(int gridcel, long offset) {
+  // insert() does not overwrite an existing entry, so the first record for a cell is the one that is used.
+  offsets.insert(std::make_pair(gridcel, offset));
+}
+
+void ParamFileIndex::buildVegParam(int linesPerHRU) {
+  char ErrStr[MAXSTRING];
+  int  vegcel, numHRUs;
+
+  rewind(file);
+  offsets.clear();
+  long offset = ftell(file);
+  while (fscanf(file, "%d %d", &vegcel, &numHRUs) == 2) {
+    if (numHRUs < 0) {
+      sprintf(ErrStr,"ERROR number of vegetation tiles (%i) given for cell %i is < 0.\n",numHRUs,vegcel);
+      nrerror(ErrStr);
+    }
+    addCell(vegcel, offset);
+    // The first line skipped is the remainder of the "<cell> <numHRUs>" line.
+    for (int i = 0; i <= numHRUs * linesPerHRU; i++) {
+      if (!skipLine(file)) {
+        sprintf(ErrStr,"ERROR unexpected EOF for cell %i while reading root zones and LAI\n",vegcel);
+        nrerror(ErrStr);
+      }
+    }
+    offset = ftell(file);
+  }
+}
+
+void ParamFileIndex::buildSnowBand() {
+  int cell;
+
+  rewind(file);
+  offsets.clear();
+  long offset = ftell(file);
+  while (fscanf(file, "%d", &cell) == 1) {
+    addCell(cell, offset);
+    skipLine(file);
+    offset = ftell(file);
+  }
+}
+
+void ParamFileIndex::buildLakeParam() {
+  int lakecel;
+
+  rewind(file);
+  offsets.clear();
+  long offset = ftell(file);
+  while (fscanf(file, "%d", &lakecel) == 1) {
+    addCell(lakecel, offset);
+    skipLine(file); // grid cell number, etc.
+    skipLine(file); // lake depth-area relationship
+    offset = ftell(file);
+  }
+}
+
+bool ParamFileIndex::seekToCell(int gridcel) const {
+  std::unordered_map<int, long>::const_iterator it = offsets.find(gridcel);
+  if (it == offsets.end()) {
+    return false;
+  }
+  clearerr(file);
+  return fseek(file, it->second, SEEK_SET) == 0;
+}
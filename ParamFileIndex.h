@@ -0,0 +1,33 @@
+#ifndef PARAMFILEINDEX_H_
+#define PARAMFILEINDEX_H_
+
+#include <stdio.h>
+#include <unordered_map>
+
+/*
+ * Maps grid cell numbers to the byte offset of that cell's record in one of the
+ * per-cell parameter files (vegetation parameters, snow bands, lake parameters).
+ * Each file is scanned once when it is opened, so that the per-cell readers can
+ * seek straight to their record instead of rewinding and scanning the whole file
+ * for every cell. If a cell number appears more than once, the first record wins
+ * (this matches the behaviour of the old rewind and scan search).
+ */
+class ParamFileIndex {
+public:
+  ParamFileIndex(FILE* file) : file(file) {}
+  // Each record starts with "<cell> <numHRUs>" followed by linesPerHRU lines for every HRU.
+  void buildVegParam(int linesPerHRU);
+  // Each record is a single line starting with the cell number.
+  void buildSnowBand();
+  // Each record is two lines, the first of which starts with the cell number.
+  void buildLakeParam();
+  // Positions the file at the start of the record for gridcel. Returns false if the cell is not in the file.
+  bool seekToCell(int gridcel) const;
+  size_t size() const { return offsets.size(); }
+private:
+  void addCell(int gridcel, long offset);
+  FILE* file;
+  std::unordered_map<int, long> offsets;
+};
+
+#endif /* PARAMFILEINDEX_H_ */
@@ -42,7 +42,7 @@ public:
       double* blowing_flux,               /* Mass flux of water vapor from blowing snow. (m/timestep) */
       double* surface_flux                /* Mass flux of water vapor from pack snow. (m/timestep) */
   ) :
-      Dt(Dt), Ra(Ra), Ra_used(Ra_used), Displacement(Displacement), Z(Z), roughness(roughness), AirDens(AirDens),
+      RootBrent(SOLVER_TSNOWSURF), Dt(Dt), Ra(Ra), Ra_used(Ra_used), Displacement(Displacement), Z(Z), roughness(roughness), AirDens(AirDens),
       EactAir(EactAir), LongSnowIn(LongSnowIn), Lv(Lv), Press(Press), Rain(Rain), NetShortUnder(NetShortUnder),
       Vpd(Vpd), Wind(Wind), OldTSurf(OldTSurf), SnowCoverFract(SnowCoverFract), SnowDepth(SnowDepth),
       SnowDensity(SnowDensity), SurfaceLiquidWater(SurfaceLiquidWater), SweSurfaceLayer(SweSurfaceLayer), Tair(Tair),
@@ -0,0 +1,85 @@
+/*
+ * SolverStats.c
+ *
+ * Per thread solver counters, and the end of run summary of the solver counts
+ * collected for each grid cell.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include "vicNl.h"
+
+#define SOLVER_HOTSPOT_CELLS 10  /* number of cells listed in the solver summary */
+
+thread_local SolverStats SolverStats::current;
+thread_local int SolverCall::depth = 0;
+
+const char* SolverStats::name(SolverType type) {
+  switch (type) {
+    case SOLVER_TSURF:        return "Tsurf";
+    case SOLVER_TSNOWSURF:    return "Tsnowsurf";
+    case SOLVER_TICESURF:     return "Tice_surf";
+    case SOLVER_TGLACSURF:    return "Tglac_surf";
+    case SOLVER_TFOLIAGE:     return "Tfoliage";
+    case SOLVER_TCANOPY:      return "Tcanopy";
+    case SOLVER_TSOIL_NODE:   return "Tsoil (explicit)";
+    case SOLVER_TSOIL_NEWTON: return "Tsoil (Newton)";
+    case SOLVER_SURF_FLUXES:  return "surface_fluxes";
+    default:                  return "unknown";
+  }
+}
+
+static bool more_solver_time(const cell_info_struct* a, const cell_info_struct* b) {
+  return a->solverStats.seconds > b->solverStats.seconds;
+}
+
+/****************************************************************************
+  print_solver_summary()
+
+  Prints the solver counts of all grid cells for each solver, and the cells
+  which spent the most time in the solvers (the hotspots), to stderr.
+  Wall times of a solver include the solvers it calls, e.g. Tsurf includes
+  Tsoil; the cell times count nested solves once.
+****************************************************************************/
+void print_solver_summary(const std::vector<cell_info_struct>& cells) {
+
+  SolverStats total;
+  std::vector<const cell_info_struct*> ranked;
+  for (unsigned int cellidx = 0; cellidx < cells.size(); cellidx++) {
+    total.add(cells[cellidx].solverStats);
+    ranked.push_back(&cells[cellidx]);
+  }
+
+  fprintf(stderr, "\nSolver summary for %d cells (%.3f seconds in solvers):\n", (int)cells.size(), total.seconds);
+  fprintf(stderr, "%-18s %14s %14s %10s %10s %10s %12s\n", "solver", "calls", "iterations", "iter/call", "failures", "fallbacks", "time [s]");
+  for (int type = 0; type < N_SOLVER_TYPES; type++) {
+    const SolverCounter& counter = total.counters[type];
+    if (counter.calls == 0) continue;
+    fprintf(stderr, "%-18s %14ld %14ld %10.2f %10ld %10ld %12.3f\n", SolverStats::name((SolverType)type),
+        counter.calls, counter.iterations, (double)counter.iterations / counter.calls,
+        counter.failures, counter.fallbacks, counter.seconds);
+  }
+
+  int nhotspots = std::min((int)ranked.size(), SOLVER_HOTSPOT_CELLS);
+  std::partial_sort(ranked.begin(), ranked.begin() + nhotspots, ranked.end(), more_solver_time);
+
+  fprintf(stderr, "\nCells with the most time in solvers:\n");
+  fprintf(stderr, "%10s %10s %10s %12s %14s %10s  %s\n", "cell", "lat", "lon", "time [s]", "iterations", "failures", "most iterations");
+  for (int i = 0; i < nhotspots; i++) {
+    const cell_info_struct* cell = ranked[i];
+    long iterations = 0;
+    long failures = 0;
+    int busiest = 0;
+    for (int type = 0; type < N_SOLVER_TYPES; type++) {
+      const SolverCounter& counter = cell->solverStats.counters[type];
+      iterations += counter.iterations;
+      failures += counter.failures;
+      // Compare iterations rather than times, which include those of nested solvers.
+      if (counter.iterations > cell->solverStats.counters[busiest].iterations) busiest = type;
+    }
+    fprintf(stderr, "%10d %10.4f %10.4f %12.3f %14ld %10ld  %s\n", cell->soil_con.gridcel, cell->soil_con.lat, cell->soil_con.lng,
+        cell->solverStats.seconds, iterations, failures, SolverStats::name((SolverType)busiest));
+  }
+}
+
+#undef SOLVER_HOTSPOT_CELLS
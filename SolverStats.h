@@ -0,0 +1,90 @@
+/*
+ * SolverStats.h
+ *
+ * Counters of the work done by the iterative solvers of the model (calls, iterations,
+ * failures and wall time). They are kept per thread in SolverStats::current while a
+ * cell is being solved, collected per grid cell in put_data(), written as the
+ * OUT_SOLVER_* output variables, and summarized at the end of the run by
+ * print_solver_summary().
+ */
+
+#ifndef SOLVERSTATS_H_
+#define SOLVERSTATS_H_
+
+#include <chrono>
+
+/* The solvers which are counted. Nested solvers are counted in their own right,
+   so the wall time of a solver includes that of the solvers it calls. */
+enum SolverType {
+  SOLVER_TSURF,         // surface temperature (SurfEnergyBal, root_brent)
+  SOLVER_TSNOWSURF,     // snow pack surface temperature (SnowPackEnergyBalance, root_brent)
+  SOLVER_TICESURF,      // lake ice surface temperature (IceEnergyBalance, root_brent)
+  SOLVER_TGLACSURF,     // glacier surface temperature (GlacierEnergyBalance, root_brent)
+  SOLVER_TFOLIAGE,      // canopy foliage temperature (CanopyEnergyBal, root_brent)
+  SOLVER_TCANOPY,       // canopy air temperature (AtmosEnergyBal, root_brent)
+  SOLVER_TSOIL_NODE,    // soil thermal node temperature, explicit scheme (SoilThermalEqn, root_brent)
+  SOLVER_TSOIL_NEWTON,  // soil temperature profile, implicit scheme (NewtonRaphsonMethod)
+  SOLVER_SURF_FLUXES,   // over/understory energy balance iteration in surface_fluxes()
+  N_SOLVER_TYPES
+};
+
+struct SolverCounter {
+  SolverCounter() : calls(0), iterations(0), failures(0), fallbacks(0), seconds(0) {}
+  long   calls;       // number of solves
+  long   iterations;  // function evaluations (root_brent) or iterations (others)
+  long   failures;    // solves which did not converge, or could not bracket the root
+  long   fallbacks;   // warm started solves which fell back to Brent's method (see RootBrent::root_warm_start())
+  double seconds;     // wall time spent in the solver
+  void add(const SolverCounter& other) {
+    calls += other.calls;
+    iterations += other.iterations;
+    failures += other.failures;
+    fallbacks += other.fallbacks;
+    seconds += other.seconds;
+  }
+};
+
+struct SolverStats {
+  SolverStats() : seconds(0) {}
+  SolverCounter counters[N_SOLVER_TYPES];
+  double seconds;  // wall time spent in all solvers, counting nested solves once
+  void add(const SolverStats& other) {
+    for (int type = 0; type < N_SOLVER_TYPES; type++) counters[type].add(other.counters[type]);
+    seconds += other.seconds;
+  }
+  void reset() { *this = SolverStats(); }
+  // Counts of the calling thread since they were last reset.
+  static thread_local SolverStats current;
+  static const char* name(SolverType type);
+};
+
+/* Counts one call of a solver in SolverStats::current, and times it from construction
+   until stop() or destruction (whichever comes first). */
+class SolverCall {
+public:
+  SolverCall(SolverType type) : counter(SolverStats::current.counters[type]), running(true),
+      outermost(depth++ == 0), start(std::chrono::steady_clock::now()) {
+    counter.calls++;
+  }
+  ~SolverCall() { stop(); }
+  void iteration() { counter.iterations++; }
+  void failure() { counter.failures++; }
+  void fallback() { counter.fallbacks++; }
+  void stop() {
+    if (running) {
+      double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      counter.seconds += elapsed;
+      if (outermost) SolverStats::current.seconds += elapsed;
+      depth--;
+      running = false;
+    }
+  }
+private:
+  static thread_local int depth;  // number of solver calls in progress on this thread
+  SolverCounter& counter;
+  bool running;
+  bool outermost;
+  std::chrono::steady_clock::time_point start;
+};
+
+#endif /* SOLVERSTATS_H_ */
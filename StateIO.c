@@ -1,4 +1,5 @@
 #include "StateIO.h"
+#include "StateIOBuffer.h"
 
 StateIO::StateIO(std::string filename, IOType type, const ProgramState* state) : filename(filename), state(state), ioType(type) {
 }
@@ -10,6 +11,13 @@ int StateIO::processNewline() {
   return 0;
 }
 
+void StateIO::writeBuffered(const std::vector<const StateIOBuffer*>& buffers) {
+  std::vector<StateIOBuffer::CellRef> cells = StateIOBuffer::orderedCells(buffers);
+  for (unsigned int i = 0; i < cells.size(); i++) {
+    cells[i].first->replayCell(*cells[i].second, this);
+  }
+}
+
 int StateIO::process(int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
   if (ioType == StateIO::Reader) {
     return read(data, numValues, id);
@@ -530,6 +530,8 @@ public:
   bool isValid() { return (year > 0 && month > 0 && day > 0); }
 };
 
+class StateIOBuffer;
+
 class StateIO {
 public:
   enum IOType { Reader, Writer };
@@ -547,6 +549,10 @@ public:
   int process(const char* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
 
   virtual void initializeOutput() = 0;
+  // Called once after all cells have been written, for formats that append a cell index to the file.
+  virtual void finalizeOutput() {}
+  // Writes all cells gathered in the buffers, in cell order. By default every recorded call is replayed.
+  virtual void writeBuffered(const std::vector<const StateIOBuffer*>& buffers);
   virtual int write(const int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) = 0;
   virtual int write(const double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) = 0;
   virtual int write(const float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) = 0;
@@ -2,9 +2,27 @@
 
 #include <cstdio>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
 
 #include "vicNl.h"
 
+/*
+ * Binary state files end with a cell index so that readers can seek straight to a cell instead of
+ * scanning every preceding cell. The index is stored as one extra record with the usual
+ * cellNum, numVeg, numBands, numBytes header (cellNum is CELL_INDEX_RECORD_ID), so older readers
+ * just skip over it. Its payload is: numCells, numCells x (int cellNum, int64 offset), followed by
+ * the int64 offset of the index record itself and CELL_INDEX_MAGIC, which therefore always sit at
+ * the very end of the file. Files without an index are still read (they are scanned once instead).
+ */
+static const int CELL_INDEX_RECORD_ID = -1;
+static const char CELL_INDEX_MAGIC[8] = { 'V', 'I', 'C', 'C', 'I', 'D', 'X', '1' };
+static const long STATE_HEADER_BYTES = 5 * sizeof(int); // year, month, day, nLayer, nNode
+
+// The reader is reopened for every cell, so indices are kept for the lifetime of the program, by file name.
+static std::map<std::string, std::unordered_map<int, long> > cellIndexCache;
+
 StateIOBinary::StateIOBinary(std::string filename, IOType ioType, const ProgramState* state) : StateIO(filename, ioType, state) {
   std::string openType = "rb";
   if (ioType == StateIO::Writer) {
@@ -38,6 +56,31 @@ void StateIOBinary::initializeOutput() {
   fflush(file);
 }
 
+// Appends the cell index (see above) after the records of all cells that have been written.
+void StateIOBinary::finalizeOutput() {
+  std::vector<std::pair<int, long> > records;
+  FILE* in = open_file(filename.c_str(), "rb");
+  scanCellRecords(in, records);
+  fclose(in);
+
+  fseek(file, 0, SEEK_END);
+  int64_t indexStart = ftell(file);
+  int numCells = records.size();
+  int header[4] = { CELL_INDEX_RECORD_ID, 0, 0, 0 };
+  header[3] = sizeof(int) + numCells * (sizeof(int) + sizeof(int64_t)) + sizeof(int64_t) + sizeof(CELL_INDEX_MAGIC);
+  fwrite(header, sizeof(int), 4, file);
+  fwrite(&numCells, sizeof(int), 1, file);
+  for (unsigned int i = 0; i < records.size(); i++) {
+    int cellNum = records[i].first;
+    int64_t offset = records[i].second;
+    fwrite(&cellNum, sizeof(int), 1, file);
+    fwrite(&offset, sizeof(int64_t), 1, file);
+  }
+  fwrite(&indexStart, sizeof(int64_t), 1, file);
+  fwrite(CELL_INDEX_MAGIC, sizeof(char), sizeof(CELL_INDEX_MAGIC), file);
+  fflush(file);
+}
+
 int StateIOBinary::write(const int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
   //return fwrite(data, sizeof(int), numValues, file);
   int dataLength = numValues * sizeof(int);
@@ -123,30 +166,100 @@ StateHeader StateIOBinary::readHeader() {
   return StateHeader(year, month, day, nLayer, nNode);
 }
 
+// Reads the offset of every cell record by hopping over the payloads using their numBytes fields.
+// Any previous cell index records are skipped.
+void StateIOBinary::scanCellRecords(FILE* file, std::vector<std::pair<int, long> >& records) {
+  int cellHeader[4]; // cellNum, numVeg, numBands, numBytes
+  fseek(file, STATE_HEADER_BYTES, SEEK_SET);
+  long offset = ftell(file);
+  while (fread(cellHeader, sizeof(int), 4, file) == 4) {
+    if (cellHeader[0] != CELL_INDEX_RECORD_ID) {
+      records.push_back(std::make_pair(cellHeader[0], offset));
+    }
+    if (cellHeader[3] < 0 || fseek(file, cellHeader[3], SEEK_CUR) != 0) {
+      break;
+    }
+    offset = ftell(file);
+  }
+  clearerr(file);
+}
+
+// Reads the trailing cell index. Returns false if the file does not have one.
+bool StateIOBinary::readCellIndex(std::unordered_map<int, long>& index) {
+  int64_t indexStart;
+  char magic[sizeof(CELL_INDEX_MAGIC)];
+  int cellHeader[4];
+  int numCells;
+
+  if (fseek(file, -(long)(sizeof(int64_t) + sizeof(magic)), SEEK_END) != 0
+      || fread(&indexStart, sizeof(int64_t), 1, file) != 1
+      || fread(magic, sizeof(char), sizeof(magic), file) != sizeof(magic)
+      || memcmp(magic, CELL_INDEX_MAGIC, sizeof(magic)) != 0) {
+    return false;
+  }
+  if (fseek(file, indexStart, SEEK_SET) != 0
+      || fread(cellHeader, sizeof(int), 4, file) != 4 || cellHeader[0] != CELL_INDEX_RECORD_ID
+      || fread(&numCells, sizeof(int), 1, file) != 1 || numCells < 0) {
+    return false;
+  }
+  for (int i = 0; i < numCells; i++) {
+    int cellNum;
+    int64_t offset;
+    if (fread(&cellNum, sizeof(int), 1, file) != 1 || fread(&offset, sizeof(int64_t), 1, file) != 1) {
+      index.clear();
+      return false;
+    }
+    index.insert(std::make_pair(cellNum, (long)offset));
+  }
+  return true;
+}
+
+const std::unordered_map<int, long>& StateIOBinary::getCellIndex() {
+  std::unordered_map<int, long>* index = NULL;
+#if PARALLEL_AVAILABLE
+#pragma omp critical(state_cell_index)
+#endif
+  {
+    std::map<std::string, std::unordered_map<int, long> >::iterator it = cellIndexCache.find(filename);
+    if (it == cellIndexCache.end()) {
+      index = &cellIndexCache[filename];
+      if (!readCellIndex(*index)) {
+        // Older state file without an index, scan it once. As before, the first record for a cell is used.
+        std::vector<std::pair<int, long> > records;
+        scanCellRecords(file, records);
+        for (unsigned int i = 0; i < records.size(); i++) {
+          index->insert(records[i]);
+        }
+      }
+      clearerr(file);
+    } else {
+      index = &it->second;
+    }
+  }
+  return *index;
+}
+
 int StateIOBinary::seekToCell(int cellid, int* nVeg, int* nBand) {
   int tmpCellNum, tmpNVeg, tmpNBand, tmpNBytes;
-  char tmpByte;
+
+  const std::unordered_map<int, long>& index = getCellIndex();
+  std::unordered_map<int, long>::const_iterator it = index.find(cellid);
+  if (it == index.end()) {
+    return -1;
+  }
+
   /* read cell information */
+  clearerr(file);
+  fseek(file, it->second, SEEK_SET);
   fread(&tmpCellNum, sizeof(int), 1, file);
   fread(&tmpNVeg, sizeof(int), 1, file);
   fread(&tmpNBand, sizeof(int), 1, file);
   fread(&tmpNBytes, sizeof(int), 1, file);
-  // Skip over unused cell information
-  while (tmpCellNum != cellid && !feof(file)) {
-    // skip rest of current cells info
-    for (int byte = 0; byte < tmpNBytes; byte++)
-      fread(&tmpByte, 1, 1, file);
-    // read info for next cell
-    fread(&tmpCellNum, sizeof(int), 1, file);
-    fread(&tmpNVeg, sizeof(int), 1, file);
-    fread(&tmpNBand, sizeof(int), 1, file);
-    fread(&tmpNBytes, sizeof(int), 1, file);
-  } //end while
 
   *nVeg = tmpNVeg;
   *nBand = tmpNBand;
 
-  if (feof(file)) {
+  if (feof(file) || tmpCellNum != cellid) {
     return -1;
   }
 
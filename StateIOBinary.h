@@ -1,7 +1,11 @@
 #ifndef STATEIOBINARY_H_
 #define STATEIOBINARY_H_
 
+#include <stdio.h>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "StateIO.h"
 
@@ -10,6 +14,7 @@ public:
   StateIOBinary(std::string filename, IOType ioType, const ProgramState* state);
   virtual ~StateIOBinary();
   void initializeOutput();
+  void finalizeOutput();
   int write(const int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
   int write(const double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
   int write(const float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
@@ -25,6 +30,9 @@ public:
   void flush();
   void rewindFile();
 private:
+  static void scanCellRecords(FILE* file, std::vector<std::pair<int, long> >& records);
+  bool readCellIndex(std::unordered_map<int, long>& index);
+  const std::unordered_map<int, long>& getCellIndex();
   FILE* file;
   std::string dataToWrite;
 };
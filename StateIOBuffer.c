@@ -0,0 +1,175 @@
+#include "StateIOBuffer.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "vicNl.h"
+
+// Values are stored at offsets that are a multiple of this, so they can be read back in place.
+static const size_t VALUE_ALIGNMENT = sizeof(double);
+
+StateIOBuffer::StateIOBuffer(const ProgramState* state) : StateIO("", StateIO::Writer, state) {
+}
+
+StateIOBuffer::~StateIOBuffer() {
+}
+
+void StateIOBuffer::beginCell(int order) {
+  Cell cell;
+  cell.order = order;
+  cell.firstRecord = records.size();
+  cell.endRecord = records.size();
+  cells.push_back(cell);
+}
+
+void StateIOBuffer::clear() {
+  cells.clear();
+  records.clear();
+  data.clear();
+}
+
+void StateIOBuffer::addRecord(RecordType type, int id, int numValues, const void* values, size_t valueSize) {
+  if (cells.empty()) {
+    throw VICException("Error in StateIOBuffer: beginCell() must be called before writing any state values.\n");
+  }
+  Record record;
+  record.type = type;
+  record.id = id;
+  record.numValues = numValues;
+  record.offset = (data.size() + VALUE_ALIGNMENT - 1) / VALUE_ALIGNMENT * VALUE_ALIGNMENT;
+  if (values != NULL && numValues > 0) {
+    data.resize(record.offset + numValues * valueSize);
+    memcpy(&data[record.offset], values, numValues * valueSize);
+  }
+  records.push_back(record);
+  cells.back().endRecord = records.size();
+}
+
+void StateIOBuffer::replayCell(const Cell& cell, StateIO* stream) const {
+  for (size_t i = cell.firstRecord; i < cell.endRecord; i++) {
+    const Record& record = records[i];
+    StateVariables::StateMetaDataVariableIndices id = (StateVariables::StateMetaDataVariableIndices) record.id;
+    switch (record.type) {
+    case INT_DATA:
+      stream->write((const int*) getValues(record), record.numValues, id);
+      break;
+    case DOUBLE_DATA:
+      stream->write((const double*) getValues(record), record.numValues, id);
+      break;
+    case FLOAT_DATA:
+      stream->write((const float*) getValues(record), record.numValues, id);
+      break;
+    case BOOL_DATA:
+      stream->write((const bool*) getValues(record), record.numValues, id);
+      break;
+    case CHAR_DATA:
+      stream->write((const char*) getValues(record), record.numValues, id);
+      break;
+    case NEWLINE:
+      stream->processNewline();
+      break;
+    case FLUSH:
+      stream->flush();
+      break;
+    case DIMENSION_UPDATE:
+      stream->notifyDimensionUpdate((StateVariables::StateVariableDimensionId) record.id, record.numValues);
+      break;
+    case DIMENSION_RESET:
+      stream->initializeDimensionIndices();
+      break;
+    }
+  }
+}
+
+static bool compareCellOrder(const StateIOBuffer::CellRef& a, const StateIOBuffer::CellRef& b) {
+  return a.second->order < b.second->order;
+}
+
+std::vector<StateIOBuffer::CellRef> StateIOBuffer::orderedCells(const std::vector<const StateIOBuffer*>& buffers) {
+  std::vector<CellRef> ordered;
+  for (unsigned int b = 0; b < buffers.size(); b++) {
+    for (unsigned int c = 0; c < buffers[b]->cells.size(); c++) {
+      ordered.push_back(CellRef(buffers[b], &buffers[b]->cells[c]));
+    }
+  }
+  std::sort(ordered.begin(), ordered.end(), compareCellOrder);
+  return ordered;
+}
+
+void StateIOBuffer::initializeOutput() {
+  // Nothing to do, the header is written by the real writer.
+}
+
+int StateIOBuffer::write(const int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  addRecord(INT_DATA, id, numValues, data, sizeof(int));
+  return numValues;
+}
+
+int StateIOBuffer::write(const double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  addRecord(DOUBLE_DATA, id, numValues, data, sizeof(double));
+  return numValues;
+}
+
+int StateIOBuffer::write(const float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  addRecord(FLOAT_DATA, id, numValues, data, sizeof(float));
+  return numValues;
+}
+
+int StateIOBuffer::write(const bool* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  addRecord(BOOL_DATA, id, numValues, data, sizeof(bool));
+  return numValues;
+}
+
+int StateIOBuffer::write(const char* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  addRecord(CHAR_DATA, id, numValues, data, sizeof(char));
+  return numValues;
+}
+
+int StateIOBuffer::processNewline() {
+  addRecord(NEWLINE, StateVariables::NONE, 0, NULL, 0);
+  return 0;
+}
+
+void StateIOBuffer::notifyDimensionUpdate(StateVariables::StateVariableDimensionId dimension, int value) {
+  addRecord(DIMENSION_UPDATE, dimension, value, NULL, 0);
+}
+
+void StateIOBuffer::initializeDimensionIndices() {
+  addRecord(DIMENSION_RESET, StateVariables::NONE, 0, NULL, 0);
+}
+
+void StateIOBuffer::flush() {
+  addRecord(FLUSH, StateVariables::NONE, 0, NULL, 0);
+}
+
+StateHeader StateIOBuffer::readHeader() {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::seekToCell(int cellid, int* nVeg, int* nBand) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::read(int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::read(double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::read(float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::read(bool* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+int StateIOBuffer::read(char* data, int numValues, const StateVariables::StateMetaDataVariableIndices id) {
+  throw VICException("Error: StateIOBuffer can only be used to write model states.\n");
+}
+
+void StateIOBuffer::rewindFile() {
+  // Not applicable.
+}
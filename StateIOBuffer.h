@@ -0,0 +1,72 @@
+#ifndef STATEIOBUFFER_H_
+#define STATEIOBUFFER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "StateIO.h"
+
+/*
+ * An in-memory StateIO writer. It records every call that processCellForStateFile() (or write_model_state())
+ * makes, so that the state of many cells can be gathered in parallel (one buffer per thread) and then
+ * written through a single real StateIO writer by StateIO::writeBuffered(). Each cell's calls are kept
+ * together, tagged with the position of the cell in the domain so that the cells are written in the
+ * same order regardless of which thread gathered them.
+ */
+class StateIOBuffer: public StateIO {
+public:
+  enum RecordType { INT_DATA, DOUBLE_DATA, FLOAT_DATA, BOOL_DATA, CHAR_DATA, NEWLINE, FLUSH, DIMENSION_UPDATE, DIMENSION_RESET };
+  struct Record {
+    RecordType type;
+    int id;           // StateMetaDataVariableIndices for data records, StateVariableDimensionId for DIMENSION_UPDATE.
+    int numValues;    // Number of values for data records, the new index for DIMENSION_UPDATE.
+    size_t offset;    // Byte offset of the values in the data pool.
+  };
+  struct Cell {
+    int order;
+    size_t firstRecord;
+    size_t endRecord;
+  };
+  typedef std::pair<const StateIOBuffer*, const Cell*> CellRef;
+
+  StateIOBuffer(const ProgramState* state);
+  virtual ~StateIOBuffer();
+  // Starts recording a new cell. Cells are written in increasing order.
+  void beginCell(int order);
+  void clear();
+  bool empty() const { return cells.empty(); }
+  const std::vector<Cell>& getCells() const { return cells; }
+  const std::vector<Record>& getRecords() const { return records; }
+  const void* getValues(const Record& record) const { return &data[record.offset]; }
+  // Replays the recorded calls of one cell into another StateIO writer.
+  void replayCell(const Cell& cell, StateIO* stream) const;
+  // All cells of all buffers, sorted by their order.
+  static std::vector<CellRef> orderedCells(const std::vector<const StateIOBuffer*>& buffers);
+
+  void initializeOutput();
+  int write(const int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int write(const double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int write(const float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int write(const bool* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int write(const char* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int processNewline();
+  StateHeader readHeader();
+  void notifyDimensionUpdate(StateVariables::StateVariableDimensionId dimension, int value = -1);
+  void initializeDimensionIndices();
+  int seekToCell(int cellid, int* nVeg, int* nBand);
+  int read(int* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int read(double* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int read(float* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int read(bool* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  int read(char* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
+  void flush();
+  void rewindFile();
+private:
+  void addRecord(RecordType type, int id, int numValues, const void* values, size_t valueSize);
+  std::vector<Cell> cells;
+  std::vector<Record> records;
+  std::vector<char> data;
+};
+
+#endif /* STATEIOBUFFER_H_ */
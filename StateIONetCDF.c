@@ -5,8 +5,11 @@
 
 #include <netcdf>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
 
 #include "vicNl_def.h"
+#include "StateIOBuffer.h"
 
 using netCDF::NcFile;
 using netCDF::NcDim;
@@ -31,6 +34,11 @@ const std::string VEG_TYPE_NUM_STR = "VEG_TYPE_NUM";
 const std::string NUM_BANDS_STR = "NUM_BANDS";
 const std::string NUM_GLAC_MASS_BALANCE_EQN_TERMS_STR = "state_nglac_mass_balance_eqn_terms";
 
+// Maps each cell number in a state file to its (lat, lon) index. The reader is reopened for every cell,
+// so the GRID_CELL grid is read once per file name and kept for the lifetime of the program.
+typedef std::unordered_map<int, std::pair<size_t, size_t> > CellIndex;
+static std::map<std::string, CellIndex> cellIndexCache;
+
 StateIONetCDF::StateIONetCDF(std::string filename, IOType ioType, const ProgramState* state) : StateIO(filename, ioType, state), netCDF(NULL) {
   populateMetaData();
   populateMetaDimensions();
@@ -335,30 +343,171 @@ void StateIONetCDF::notifyDimensionUpdate(StateVariables::StateVariableDimension
 }
 
 int StateIONetCDF::seekToCell(int cellid, int* nVeg, int* nBand) {
-  NcDim latDim = netCDF->getDim(LAT_DIM_STR);
-  NcDim lonDim = netCDF->getDim(LON_DIM_STR);
-  int latSize = latDim.getSize();
-  int lonSize = lonDim.getSize();
-  NcVar cellIds = netCDF->getVar(GRID_CELL_STR);
-  // Iterate through the lat/lng grid until the correct cellId is found.
-  // Then read the veg and band vars at this cell.
-  for (int i = 0; i < latSize; i++) {
-    for (int j = 0; j < lonSize; j++) {
-      double cellIdRead = -1;
-      std::vector<size_t> start;
-      start.push_back((size_t)i);
-      start.push_back((size_t)j);
-      cellIds.getVar(start, &cellIdRead);
-      if ((int)cellIdRead == cellid) {
-        NcVar veg = netCDF->getVar(VEG_TYPE_NUM_STR);
-        NcVar band = netCDF->getVar(NUM_BANDS_STR);
-        veg.getVar(start, nVeg);
-        band.getVar(start, nBand);
-        return 0;
+  const CellIndex* index = NULL;
+#if PARALLEL_AVAILABLE
+#pragma omp critical(state_cell_index)
+#endif
+  {
+    std::map<std::string, CellIndex>::iterator it = cellIndexCache.find(filename);
+    if (it == cellIndexCache.end()) {
+      // Read the whole lat/lon grid of cell ids at once and index it.
+      CellIndex& newIndex = cellIndexCache[filename];
+      size_t latSize = netCDF->getDim(LAT_DIM_STR).getSize();
+      size_t lonSize = netCDF->getDim(LON_DIM_STR).getSize();
+      std::vector<int> cellIds(latSize * lonSize);
+      if (!cellIds.empty()) {
+        netCDF->getVar(GRID_CELL_STR).getVar(&cellIds[0]);
+      }
+      for (size_t i = 0; i < latSize; i++) {
+        for (size_t j = 0; j < lonSize; j++) {
+          // insert() keeps the first (lowest lat, then lon index) occurrence, as the old grid search did.
+          newIndex.insert(std::make_pair(cellIds[i * lonSize + j], std::make_pair(i, j)));
+        }
+      }
+      index = &newIndex;
+    } else {
+      index = &it->second;
+    }
+  }
+
+  CellIndex::const_iterator cell = index->find(cellid);
+  if (cell == index->end()) {
+    return -1;
+  }
+  // Read the veg and band vars at this cell.
+  std::vector<size_t> start;
+  start.push_back(cell->second.first);
+  start.push_back(cell->second.second);
+  NcVar veg = netCDF->getVar(VEG_TYPE_NUM_STR);
+  NcVar band = netCDF->getVar(NUM_BANDS_STR);
+  veg.getVar(start, nVeg);
+  band.getVar(start, nBand);
+  return 0;
+}
+
+// A run of values recorded by a StateIOBuffer, and where it goes in the whole lat x lon x ... grid of its variable.
+struct StateIONetCDF::BufferedValues {
+  const StateIOBuffer* buffer;
+  const StateIOBuffer::Record* record;
+  size_t position;
+};
+
+// Position (in elements, row major) of the current dimension indices in the whole grid of a variable.
+size_t StateIONetCDF::gridPosition(const StateVariables::StateMetaDataVariableIndices id) {
+  size_t position = 0;
+  const std::vector<StateVariables::StateVariableDimensionId>& dims = metaData[id].dimensions;
+  for (std::vector<StateVariables::StateVariableDimensionId>::const_iterator it = dims.begin(); it != dims.end(); ++it) {
+    if (*it != StateVariables::NO_DIM) {
+      position = position * metaDimensions[*it].size + curDimensionIndices[*it];
+    }
+  }
+  return position;
+}
+
+// Writes one variable for all buffered cells with a single putVar() call. The slab spans all latitude rows that
+// contain buffered cells; positions without values get the default netCDF fill value, as if never written.
+template<typename T> void StateIONetCDF::writeSlab(const StateVariables::StateMetaDataVariableIndices id,
+    const std::vector<BufferedValues>& values, size_t firstLat, size_t numLats, T fillValue) {
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+  size_t latStride = 1;
+  const std::vector<StateVariables::StateVariableDimensionId>& dims = metaData[id].dimensions;
+  for (std::vector<StateVariables::StateVariableDimensionId>::const_iterator it = dims.begin(); it != dims.end(); ++it) {
+    if (*it == StateVariables::LAT_DIM) {
+      start.push_back(firstLat);
+      count.push_back(numLats);
+    } else if (*it != StateVariables::NO_DIM) {
+      start.push_back(0);
+      count.push_back(metaDimensions[*it].size);
+      latStride *= metaDimensions[*it].size;
+    }
+  }
+
+  std::vector<T> slab(numLats * latStride, fillValue);
+  for (std::vector<BufferedValues>::const_iterator it = values.begin(); it != values.end(); ++it) {
+    const StateIOBuffer::Record& record = *it->record;
+    size_t offset = it->position - firstLat * latStride;
+    if (offset + record.numValues > slab.size()) {
+      std::stringstream ss;
+      ss << "Error writing variable: " << metaData[id].name << ". " << record.numValues << " values do not fit in the variable dimensions.";
+      throw VICException(ss.str());
+    }
+    const void* data = it->buffer->getValues(record);
+    for (int i = 0; i < record.numValues; i++) {
+      switch (record.type) {
+      case StateIOBuffer::INT_DATA:    slab[offset + i] = (T) ((const int*) data)[i]; break;
+      case StateIOBuffer::DOUBLE_DATA: slab[offset + i] = (T) ((const double*) data)[i]; break;
+      case StateIOBuffer::FLOAT_DATA:  slab[offset + i] = (T) ((const float*) data)[i]; break;
+      case StateIOBuffer::BOOL_DATA:   slab[offset + i] = (T) ((const bool*) data)[i]; break;
+      case StateIOBuffer::CHAR_DATA:   slab[offset + i] = (T) ((const char*) data)[i]; break;
+      default: break;
       }
     }
   }
-  return -1;
+
+  try {
+    NcVar variable = netCDF->getVar(metaData[id].name);
+    variable.putVar(start, count, &slab[0]);
+  } catch (std::exception& e) {
+    fprintf(stderr, "Error writing variable: %s for latitude rows %d to %d\n",
+        metaData[id].name.c_str(), (int) firstLat, (int) (firstLat + numLats - 1));
+    throw;
+  }
+}
+
+// Instead of many small writes per cell, gather the values of each variable for all cells and write each
+// variable once.
+void StateIONetCDF::writeBuffered(const std::vector<const StateIOBuffer*>& buffers) {
+  std::map<StateVariables::StateMetaDataVariableIndices, std::vector<BufferedValues> > variables;
+  size_t firstLat = metaDimensions[StateVariables::LAT_DIM].size;
+  size_t lastLat = 0;
+
+  // Replay the dimension updates to find where every run of values belongs.
+  std::vector<StateIOBuffer::CellRef> cells = StateIOBuffer::orderedCells(buffers);
+  for (unsigned int c = 0; c < cells.size(); c++) {
+    const StateIOBuffer* buffer = cells[c].first;
+    const StateIOBuffer::Cell& cell = *cells[c].second;
+    for (size_t r = cell.firstRecord; r < cell.endRecord; r++) {
+      const StateIOBuffer::Record& record = buffer->getRecords()[r];
+      switch (record.type) {
+      case StateIOBuffer::DIMENSION_UPDATE:
+        notifyDimensionUpdate((StateVariables::StateVariableDimensionId) record.id, record.numValues);
+        break;
+      case StateIOBuffer::DIMENSION_RESET:
+        initializeDimensionIndices();
+        break;
+      case StateIOBuffer::NEWLINE:
+      case StateIOBuffer::FLUSH:
+        break;
+      default: {
+        StateVariables::StateMetaDataVariableIndices id = (StateVariables::StateMetaDataVariableIndices) record.id;
+        if (metaData.find(id) == metaData.end()) {
+          std::stringstream ss;
+          ss << "Error: no netCDF metadata for state variable " << id;
+          throw VICException(ss.str());
+        }
+        BufferedValues values;
+        values.buffer = buffer;
+        values.record = &record;
+        values.position = gridPosition(id);
+        variables[id].push_back(values);
+        size_t lat = curDimensionIndices[StateVariables::LAT_DIM];
+        if (lat < firstLat) firstLat = lat;
+        if (lat > lastLat) lastLat = lat;
+        break;
+      }
+      }
+    }
+  }
+
+  for (std::map<StateVariables::StateMetaDataVariableIndices, std::vector<BufferedValues> >::iterator it = variables.begin();
+      it != variables.end(); ++it) {
+    if (metaData[it->first].type == netCDF::NcType::nc_INT) {
+      writeSlab<int>(it->first, it->second, firstLat, lastLat - firstLat + 1, NC_FILL_INT);
+    } else {
+      writeSlab<double>(it->first, it->second, firstLat, lastLat - firstLat + 1, NC_FILL_DOUBLE);
+    }
+  }
 }
 
 void StateIONetCDF::flush() {
@@ -35,8 +35,13 @@ public:
   int seekToCell(int cellid, int* nVeg, int* nBand);
   void flush();
   void rewindFile();
+  void writeBuffered(const std::vector<const StateIOBuffer*>& buffers);
 
 private:
+  struct BufferedValues;
+  template<typename T> void writeSlab(const StateVariables::StateMetaDataVariableIndices id, const std::vector<BufferedValues>& values,
+      size_t firstLat, size_t numLats, T fillValue);
+  size_t gridPosition(const StateVariables::StateMetaDataVariableIndices id);
   template<typename T> int generalWrite(const T* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
   template<typename T> int generalRead(T* data, int numValues, const StateVariables::StateMetaDataVariableIndices id);
   void populateMetaData();
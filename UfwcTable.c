@@ -0,0 +1,39 @@
+/*
+ * UfwcTable.c
+ *
+ * The shared tables of the QUICK_FS option, see UfwcTable.h.
+ */
+
+#include <map>
+#include <utility>
+#include "vicNl.h"
+
+const double UfwcTable::temps[QUICK_FS_TEMPS + 1] = { -1.e-5, -0.075, -0.20, -0.50, -1.00, -2.50, -5, -10 };
+
+/* All tables built so far, keyed by (bubble, expt). Entries of a std::map do not
+   move, so the cells keep pointers to them. */
+static std::map<std::pair<double, double>, UfwcTable> ufwc_tables;
+
+const UfwcTable* UfwcTable::get(double bubble, double expt) {
+  const UfwcTable* table;
+
+#if PARALLEL_AVAILABLE
+#pragma omp critical(ufwc_tables)
+#endif
+  {
+    std::pair<std::map<std::pair<double, double>, UfwcTable>::iterator, bool> entry
+        = ufwc_tables.insert(std::make_pair(std::make_pair(bubble, expt), UfwcTable()));
+    UfwcTable& newTable = entry.first->second;
+    if (entry.second) {
+      for (int ii = 0; ii < QUICK_FS_TEMPS; ii++) {
+        double Aufwc = maximum_unfrozen_water(temps[ii], 1.0, bubble, expt);
+        double Bufwc = maximum_unfrozen_water(temps[ii + 1], 1.0, bubble, expt);
+        newTable.intercept[ii] = linear_interp(0., temps[ii], temps[ii + 1], Aufwc, Bufwc);
+        newTable.slope[ii] = (Bufwc - Aufwc) / (temps[ii + 1] - temps[ii]);
+      }
+    }
+    table = &newTable;
+  }
+
+  return table;
+}
@@ -0,0 +1,29 @@
+/*
+ * UfwcTable.h
+ *
+ * Linearized maximum unfrozen water content curve of the QUICK_FS option. The
+ * curve of maximum_unfrozen_water() is replaced by QUICK_FS_TEMPS line segments
+ * between the temperatures in UfwcTable::temps, for a maximum moisture content of 1.
+ * A table only depends on the bubbling pressure and the exponent of the soil, so the
+ * layers and nodes of all cells with the same soil parameters share one table.
+ * See maximum_unfrozen_water_quick() for the lookup.
+ */
+
+#ifndef UFWCTABLE_H_
+#define UFWCTABLE_H_
+
+#define QUICK_FS_TEMPS 7  /* number of line segments of the linearized curve */
+
+struct UfwcTable {
+  double intercept[QUICK_FS_TEMPS];  // unfrozen water content of each segment at 0C (fraction of max_moist)
+  double slope[QUICK_FS_TEMPS];      // slope of each segment (1/C)
+
+  // Segment boundaries (C), from the warmest to the coldest.
+  static const double temps[QUICK_FS_TEMPS + 1];
+
+  // Returns the table for the given bubbling pressure (cm) and exponent, building it
+  // the first time these parameters are seen. Tables are kept until the end of the run.
+  static const UfwcTable* get(double bubble, double expt);
+};
+
+#endif /* UFWCTABLE_H_ */
@@ -9,19 +9,25 @@
 #endif
 
 #include <netcdf>
+#include <algorithm>
 #include <ctime>
 //#include <map>
 #include <sstream>
 
 using namespace netCDF;
 
-WriteOutputNetCDF::WriteOutputNetCDF(const ProgramState* state) : WriteOutputFormat(state), netCDF(NULL) {
+// Upper limit on the memory used to buffer output records in write_data_all_cells().
+static const size_t MAX_OUTPUT_BUFFER_BYTES = 256 * 1024 * 1024;
+
+WriteOutputNetCDF::WriteOutputNetCDF(const ProgramState* state) : WriteOutputFormat(state), netCDF(NULL), numLats(0), numLons(0), gridSize(0),
+    queueDepth(state->global_param.output_queue_depth), writerBusy(false), writerStopping(false) {
   netCDFOutputFileName = state->options.NETCDF_FULL_FILE_PATH;
   // The divisor will convert the difference to sub-daily (e.g. hourly, 3/4/6/8/12-hourly) or daily, respectively.
   timeIndexDivisor = state->global_param.out_dt < 24 ? (60 * 60 * state->global_param.out_dt) : (60 * 60 * 24); //new (*state->global_param.dt)
 }
 
 WriteOutputNetCDF::~WriteOutputNetCDF() {
+  stopWriter();
   if (netCDF != NULL) {
     delete netCDF;
   }
@@ -341,8 +347,6 @@ void WriteOutputNetCDF::write_data_one_cell(std::vector<OutputData*>& all_out_da
   std::vector<size_t> start3(start3Vals, start3Vals + 3), count3(count3Vals, count3Vals + 3);
   std::vector<size_t> start4(start4Vals, start4Vals + 4), count4(count4Vals, count4Vals + 4);
 
-  std::multimap<std::string, netCDF::NcVar> allVars = netCDF->getVars();
-
   // Loop through (legacy) out_data_files_template for listing of output variables
   for (int file_idx = 0; file_idx < state->options.Noutfiles; file_idx++) {
 	  // Loop over this output file's data variables
@@ -365,7 +369,7 @@ void WriteOutputNetCDF::write_data_one_cell(std::vector<OutputData*>& all_out_da
 		  }
 		  // Write data to file for this variable
 		  try {
-			  NcVar variable = allVars.find(state->output_mapping.at(all_out_data[0][out_data_files_template[file_idx].varid[var_idx]].varname).name)->second;
+			  NcVar variable = findVariable(state->output_mapping.at(all_out_data[0][out_data_files_template[file_idx].varid[var_idx]].varname).name);
 
 			  if (use4Dimensions) {
 				  count4.at(1) = varnumelem;  // Set the number of values to write to the z dimension
@@ -383,7 +387,169 @@ void WriteOutputNetCDF::write_data_one_cell(std::vector<OutputData*>& all_out_da
   }
 }
 
-// This is called for all cells at once (intended for multithreading), writing data for one time record to file.
+// Returns the (cached) handle of the netCDF variable with the given name.
+NcVar WriteOutputNetCDF::findVariable(const std::string& name) {
+  if (variables.empty()) {
+    std::multimap<std::string, NcVar> allVars = netCDF->getVars();
+    variables.insert(allVars.begin(), allVars.end());
+  }
+  std::map<std::string, NcVar>::const_iterator it = variables.find(name);
+  if (it == variables.end()) {
+    throw VICException("Error: could not find variable in netCDF output file: " + name);
+  }
+  return it->second;
+}
+
+// Sets up the output buffers of each output variable, and starts the output writer thread.
+// Called on the first call to write_data_all_cells().
+void WriteOutputNetCDF::initializeBuffers(const std::vector<OutputData*>& all_out_data, out_data_file_struct *out_data_files_template, const ProgramState* state) {
+  numLats = state->global_param.gridNumLatDivisions;
+  numLons = state->global_param.gridNumLonDivisions;
+  gridSize = numLats * numLons;
+  for (size_t cell_idx = 0; cell_idx < gridSize; cell_idx++) {
+    if (state->modeled_cell_mask[cell_idx]) {
+      modeledCellGridIndex.push_back(cell_idx);
+    }
+  }
+
+  size_t bytesPerRec = 0;
+  for (int file_idx = 0; file_idx < state->options.Noutfiles; file_idx++) {
+    for (int var_idx = 0; var_idx < out_data_files_template[file_idx].nvars; var_idx++) {
+      const OutputData& out_data = all_out_data[0][out_data_files_template[file_idx].varid[var_idx]];
+      BufferedVariable buffered;
+      buffered.variable = findVariable(state->output_mapping.at(out_data.varname).name);
+      buffered.outvarIndex = out_data_files_template[file_idx].varid[var_idx];
+      buffered.nelem = out_data.nelem;
+      buffered.firstRec = 0;
+      buffered.numRecs = 0;
+      buffers.push_back(buffered);
+      bytesPerRec += out_data.nelem * gridSize * sizeof(float);
+    }
+  }
+
+  // Buffer as many records as fit in MAX_OUTPUT_BUFFER_BYTES (for all variables and spare buffers together), rounded
+  // down to whole time chunks so that each write fills complete chunks and no chunk has to be read back and rewritten.
+  const int timeLength = getLengthOfTimeDimension(state);
+  const size_t bytesPerRecAllBuffers = std::max(bytesPerRec * (queueDepth + 1), (size_t)1);
+  const int maxRecs = std::max(1, std::min(timeLength, (int)(MAX_OUTPUT_BUFFER_BYTES / bytesPerRecAllBuffers)));
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    NcVar::ChunkMode chunkMode;
+    std::vector<size_t> chunkSizes;
+    buffers[i].variable.getChunkingParameters(chunkMode, chunkSizes);
+    int timeChunk = (chunkMode == NcVar::nc_CHUNKED && !chunkSizes.empty()) ? (int)chunkSizes[0] : 1;
+    buffers[i].recsPerWrite = timeChunk <= maxRecs ? (maxRecs / timeChunk) * timeChunk : maxRecs;
+    buffers[i].values.assign(buffers[i].recsPerWrite * buffers[i].nelem * gridSize, NETCDF_FILL_VALUE);
+    buffers[i].spareValues.assign(queueDepth, buffers[i].values);
+  }
+
+  if (queueDepth > 0) {
+    writerThread = std::thread(&WriteOutputNetCDF::writerLoop, this);
+  }
+}
+
+// Writes numRecs records of one variable, starting at time index firstRec, as a single hyperslab.
+void WriteOutputNetCDF::writeRecords(const BufferedVariable& buffered, int firstRec, int numRecs, const std::vector<float>& values) {
+  std::vector<size_t> start(1, (size_t)firstRec), count(1, (size_t)numRecs);
+  if (buffered.nelem > 1) {
+    start.push_back(0);
+    count.push_back(buffered.nelem);
+  }
+  start.push_back(0);
+  start.push_back(0);
+  count.push_back(numLats);
+  count.push_back(numLons);
+  try {
+    buffered.variable.putVar(start, count, &values[0]);
+  } catch (std::exception& e) {
+    fprintf(stderr, "Error writing variable: %s, at timeIndex: %d\n", buffered.variable.getName().c_str(), firstRec);
+    throw;
+  }
+}
+
+// Writes the buffered records of one variable (or hands them to the output writer thread) and empties the buffer.
+void WriteOutputNetCDF::submitBuffer(int bufferIndex) {
+  BufferedVariable& buffered = buffers[bufferIndex];
+  if (buffered.numRecs == 0) {
+    return;
+  }
+  if (queueDepth == 0) {
+    writeRecords(buffered, buffered.firstRec, buffered.numRecs, buffered.values);
+    buffered.numRecs = 0;
+    return;
+  }
+  std::unique_lock<std::mutex> lock(queueMutex);
+  // Wait for a spare buffer; this bounds the number of buffers waiting to be written.
+  queueChanged.wait(lock, [&] { return !buffered.spareValues.empty() || writerError; });
+  if (writerError) {
+    std::rethrow_exception(writerError);
+  }
+  WriteJob job;
+  job.bufferIndex = bufferIndex;
+  job.firstRec = buffered.firstRec;
+  job.numRecs = buffered.numRecs;
+  job.values.swap(buffered.values);
+  buffered.values.swap(buffered.spareValues.back());
+  buffered.spareValues.pop_back();
+  queue.push_back(std::move(job));
+  buffered.numRecs = 0;
+  queueChanged.notify_all();
+}
+
+// Body of the output writer thread: writes the queued buffers in order, and returns them as spares.
+void WriteOutputNetCDF::writerLoop() {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  while (true) {
+    queueChanged.wait(lock, [&] { return writerStopping || !queue.empty(); });
+    if (queue.empty()) {
+      return;
+    }
+    WriteJob job = std::move(queue.front());
+    queue.pop_front();
+    writerBusy = true;
+    lock.unlock();
+    try {
+      writeRecords(buffers[job.bufferIndex], job.firstRec, job.numRecs, job.values);
+    } catch (...) {
+      lock.lock();
+      if (!writerError) {
+        writerError = std::current_exception();
+      }
+      lock.unlock();
+    }
+    lock.lock();
+    buffers[job.bufferIndex].spareValues.push_back(std::move(job.values));
+    writerBusy = false;
+    queueChanged.notify_all();
+  }
+}
+
+void WriteOutputNetCDF::waitForWrites() {
+  if (!writerThread.joinable()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(queueMutex);
+  queueChanged.wait(lock, [&] { return (queue.empty() && !writerBusy) || writerError; });
+  if (writerError) {
+    std::rethrow_exception(writerError);
+  }
+}
+
+// Stops the output writer thread once it has written all queued buffers.
+void WriteOutputNetCDF::stopWriter() {
+  if (!writerThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    writerStopping = true;
+  }
+  queueChanged.notify_all();
+  writerThread.join();
+  writerStopping = false;
+}
+
+// This is called for all cells at once (intended for multithreading), adding the data of one time record to
+// the output buffers. The buffered records are written to file once a buffer is full (see initializeBuffers()).
 void WriteOutputNetCDF::write_data_all_cells(std::vector<OutputData*>& all_out_data, out_data_file_struct *out_data_files_template, const int output_rec, const ProgramState* state) {
 
   if (netCDF == NULL) {
@@ -392,66 +558,50 @@ void WriteOutputNetCDF::write_data_all_cells(std::vector<OutputData*>& all_out_d
     return;
   }
 
-	const size_t timeIndex = size_t(output_rec);
-	const size_t start3Vals [] = { timeIndex, 0, 0 };     // (t, y, x)
-	const size_t count3Vals [] = { 1,(size_t) state->global_param.gridNumLatDivisions,(size_t) state->global_param.gridNumLonDivisions };
-	const size_t start4Vals [] = { timeIndex, 0, 0, 0 };  // (t, z, y, x)
-	const size_t count4Vals [] = { 1,1,(size_t) state->global_param.gridNumLatDivisions,(size_t) state->global_param.gridNumLonDivisions };
-	std::vector<size_t> start3(start3Vals, start3Vals + 3), count3(count3Vals, count3Vals + 3);
-	std::vector<size_t> start4(start4Vals, start4Vals + 4), count4(count4Vals, count4Vals + 4);
-
-	std::multimap<std::string, netCDF::NcVar> allVars = netCDF->getVars();
-	int num_cells = state->global_param.gridNumLatDivisions * state->global_param.gridNumLonDivisions;
-	bool *modeled_cell_mask_ptr;
-
-	// Loop through (legacy) out_data_files_template for listing of output variables
-	for (int file_idx = 0; file_idx < state->options.Noutfiles; file_idx++) {
-		// Loop over this output file's data variables
-		for (int var_idx = 0; var_idx < out_data_files_template[file_idx].nvars; var_idx++) {
-			// Create temporary array of data for this variable across all cells
-			float *vardata, *vardata_ptr;
-			int varnumelem = all_out_data[0][out_data_files_template[file_idx].varid[var_idx]].nelem;
-			bool use4Dimensions = varnumelem > 1;
-			int vardatasize = varnumelem * num_cells;
-			int modeled_cell_idx = 0; // index among modeled cells
-
-			vardata = new float [vardatasize];
-			vardata_ptr = vardata;
-
-			// Interleave data from each cell for this variable in temporary array vardata
-			for (int elem=0; elem<varnumelem; elem++) {
-				modeled_cell_mask_ptr = state->modeled_cell_mask;
-				modeled_cell_idx = 0;
-				for (int cell_idx = 0; cell_idx < num_cells; cell_idx++) {
-					if (*modeled_cell_mask_ptr) { // Check if this cell is marked as modeled in modeled_cell_mask
-						*vardata_ptr = all_out_data[modeled_cell_idx][out_data_files_template[file_idx].varid[var_idx]].aggdata[elem];
-						modeled_cell_idx++;
-					}
-					else {
-						*vardata_ptr = NETCDF_FILL_VALUE;
-					}
-					modeled_cell_mask_ptr++;
-					vardata_ptr++;
-				}
-			}
-			// Write data to file for this variable
-			try {
-				NcVar variable = allVars.find(state->output_mapping.at(all_out_data[0][out_data_files_template[file_idx].varid[var_idx]].varname).name)->second;
-
-				if (use4Dimensions) {
-					count4.at(1) = varnumelem;  // Set the number of values to write to the z dimension
-					variable.putVar(start4, count4, vardata);
-				} else {
-					variable.putVar(start3, count3, vardata);
-				}
-			} catch (std::exception& e) {
-				fprintf(stderr, "Error writing variable: %s, at timeIndex: %d\n", all_out_data[0][out_data_files_template[file_idx].varid[var_idx]].varname.c_str(), (int)timeIndex);
-
-				throw;
-			}
-			delete [] vardata;
-		}
-	}
+  if (buffers.empty()) {
+    initializeBuffers(all_out_data, out_data_files_template, state);
+  }
+
+  // Records are normally consecutive; write out what is buffered if this one does not follow on.
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    if (buffers[i].numRecs > 0 && output_rec != buffers[i].firstRec + buffers[i].numRecs) {
+      submitBuffer(i);
+    }
+  }
+
+  // Copy this record for all modeled cells into its slot of each buffer.
+#if PARALLEL_AVAILABLE
+#pragma omp parallel for
+#endif
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    BufferedVariable& buffered = buffers[i];
+    if (buffered.numRecs == 0) {
+      buffered.firstRec = output_rec;
+    }
+    float* recordValues = &buffered.values[(size_t)buffered.numRecs * buffered.nelem * gridSize];
+    for (int elem = 0; elem < buffered.nelem; elem++) {
+      float* elemValues = recordValues + elem * gridSize;
+      for (size_t modeled_cell_idx = 0; modeled_cell_idx < modeledCellGridIndex.size(); modeled_cell_idx++) {
+        elemValues[modeledCellGridIndex[modeled_cell_idx]] = all_out_data[modeled_cell_idx][buffered.outvarIndex].aggdata[elem];
+      }
+    }
+    buffered.numRecs++;
+  }
+
+  // Write when a buffer is full, or at the end of a group of recsPerWrite records so that writes stay chunk aligned.
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    if (buffers[i].numRecs == buffers[i].recsPerWrite || (output_rec + 1) % buffers[i].recsPerWrite == 0) {
+      submitBuffer(i);
+    }
+  }
+}
+
+void WriteOutputNetCDF::flush() {
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    submitBuffer(i);
+  }
+  waitForWrites();
+  stopWriter();
 }
 
 void WriteOutputNetCDF::compressFiles() {
@@ -1,15 +1,19 @@
 #ifndef WRITEOUTPUTNETCDF_H_
 #define WRITEOUTPUTNETCDF_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include "user_def.h"
 #include "WriteOutputFormat.h"
 
 #if NETCDF_OUTPUT_AVAILABLE
 
-namespace netCDF {
-  class NcFile;
-}
+#include <netcdf>
 
 class WriteOutputNetCDF: public WriteOutputFormat {
 public:
@@ -25,8 +29,59 @@ public:
   void write_header(OutputData *out_data, const dmy_struct *dmy, const ProgramState* state);
   int getLengthOfTimeDimension(const ProgramState* state);
   int getTimeIndex(const dmy_struct* curTime, const int timeIndexDivisor, const ProgramState* state);
+  // Waits until the output writer thread has written all the buffers handed to it so far. The netCDF library
+  // is not thread safe, so this must be called before any other netCDF file is accessed during the time loop.
+  void waitForWrites();
+  // Writes any output records still buffered by write_data_all_cells() and stops the output writer thread.
+  // Must be called after the last record.
+  void flush();
   netCDF::NcFile* netCDF;
   int timeIndexDivisor;
+private:
+  /*
+   * Output records of one variable for all grid cells, buffered by write_data_all_cells() in the
+   * (time, [depth,] lat, lon) order of the file so that several records can be written with a single
+   * putVar. The buffers are allocated once and reused; grid cells which are not modeled keep the fill value.
+   * With an output writer thread, a full buffer is swapped with one of OUTPUT_QUEUE_DEPTH spare buffers and
+   * written by the thread while the model fills the spare.
+   */
+  struct BufferedVariable {
+    netCDF::NcVar variable;
+    int outvarIndex;          // Index into the OutputData arrays.
+    int nelem;
+    int recsPerWrite;         // Number of records written at once, a multiple of the time chunk size where possible.
+    int firstRec;             // Time index of the first buffered record.
+    int numRecs;              // Number of buffered records.
+    std::vector<float> values;
+    std::vector<std::vector<float> > spareValues;  // Buffers not in use by the writer thread (guarded by queueMutex).
+  };
+  struct WriteJob {
+    int bufferIndex;
+    int firstRec;
+    int numRecs;
+    std::vector<float> values;
+  };
+  netCDF::NcVar findVariable(const std::string& name);
+  void initializeBuffers(const std::vector<OutputData*>& all_out_data, out_data_file_struct *out_data_files_template, const ProgramState* state);
+  void submitBuffer(int bufferIndex);
+  void writeRecords(const BufferedVariable& buffered, int firstRec, int numRecs, const std::vector<float>& values);
+  void writerLoop();
+  void stopWriter();
+
+  std::map<std::string, netCDF::NcVar> variables;  // Cached NcVar handles, by netCDF variable name.
+  std::vector<BufferedVariable> buffers;
+  std::vector<size_t> modeledCellGridIndex;         // Position in the lat/lon grid of each modeled cell.
+  size_t numLats, numLons, gridSize;
+
+  // Output writer thread (only used when OUTPUT_QUEUE_DEPTH > 0).
+  int queueDepth;
+  std::thread writerThread;
+  std::mutex queueMutex;
+  std::condition_variable queueChanged;
+  std::deque<WriteJob> queue;
+  bool writerBusy;
+  bool writerStopping;
+  std::exception_ptr writerError;  // First exception thrown by the writer thread, rethrown by the model thread.
 };
 
 #endif /* NETCDF_OUTPUT_AVAILABLE */
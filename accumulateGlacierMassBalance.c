@@ -2,11 +2,9 @@
 #include "GlacierMassBalanceResult.h"
 #include "vicNl.h"
 
-void resetAccumulationValues(std::vector<HRU>* hruList) {
-	for (std::vector<HRU>::iterator hru = hruList->begin(); hru != hruList->end(); ++hru) {
-		if (hru->isGlacier) {
-			hru->glacier.cum_mass_balance = 0;
-		}
+void resetAccumulationValues(dist_prcp_struct* prcp) {
+	for (std::vector<int>::const_iterator glacier = prcp->glacierHRUs.begin(); glacier != prcp->glacierHRUs.end(); ++glacier) {
+		prcp->hruList[*glacier].glacier.cum_mass_balance = 0;
 	}
 }
 
@@ -23,7 +21,7 @@ void accumulateGlacierMassBalance(GraphingEquation* gmbEquation, const dmy_struc
 
 	// Initialize on the first time step.
 	if (rec == 0) {
-		resetAccumulationValues(&prcp->hruList);
+		resetAccumulationValues(prcp);
 	}
 
 	// Check if we have reached the glacier accumulation start point of the simulation
@@ -36,11 +34,10 @@ void accumulateGlacierMassBalance(GraphingEquation* gmbEquation, const dmy_struc
 
 	// If we have reached the glacier accumulation start point of the simulation, accumulate mass balance for each glacier hru.
 	if (state->glacier_accum_started) {
-		for (std::vector<HRU>::iterator hru = prcp->hruList.begin(); hru != prcp->hruList.end(); ++hru) {
-			if (hru->isGlacier) {
-				if (IS_VALID(hru->glacier.mass_balance)) {
-					hru->glacier.cum_mass_balance += hru->glacier.mass_balance;
-				}
+		for (std::vector<int>::const_iterator glacier = prcp->glacierHRUs.begin(); glacier != prcp->glacierHRUs.end(); ++glacier) {
+			HRU& hru = prcp->hruList[*glacier];
+			if (IS_VALID(hru.glacier.mass_balance)) {
+				hru.glacier.cum_mass_balance += hru.glacier.mass_balance;
 			}
 		}
 	}
@@ -61,7 +58,7 @@ void accumulateGlacierMassBalance(GraphingEquation* gmbEquation, const dmy_struc
 		fprintf(stderr, "accumulateGlacierMassBalance for cell %d at %4.5f %4.5f:\n", soil->gridcel, soil->lat, soil->lng );
 		result.printForDebug();
 #endif /* GLACIER_DEBUG */
-		resetAccumulationValues(&(prcp->hruList));
+		resetAccumulationValues(prcp);
 		*gmbEquation = result.equation; // update GMB polynomial for this cell
 	}
 }
@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "vicNl.h"
 
 static char vcid[] = "$Id$";
@@ -37,48 +38,49 @@ atmos_data_struct * alloc_atmos(int nrecs, int NR)
 
 *******************************************************************/
 {
-  atmos_data_struct *atmos = (atmos_data_struct *) calloc(nrecs, sizeof(atmos_data_struct));
-  if (atmos == NULL)
+  /* Number of double arrays in atmos_data_struct */
+  const int Nvars = 11;
+  const size_t Nvalues = (size_t) nrecs * (NR + 1);
+
+  /* The records, then the values of each variable for all records and
+     snow steps (air_temp[rec][0..NR] for all rec, then channel_in, ...),
+     are stored in a single block. */
+  size_t recBytes = (nrecs * sizeof(atmos_data_struct) + sizeof(double) - 1)
+      / sizeof(double) * sizeof(double);
+  char *arena = (char *) calloc(recBytes + Nvalues * (Nvars * sizeof(double) + sizeof(char)), 1);
+  if (arena == NULL)
     vicerror("Memory allocation error in alloc_atmos().");
 
+  atmos_data_struct *atmos = (atmos_data_struct *) arena;
+  double *values = (double *) (arena + recBytes);
+  double *air_temp   = values;
+  double *channel_in = values + 1 * Nvalues;
+  double *density    = values + 2 * Nvalues;
+  double *longwave   = values + 3 * Nvalues;
+  double *prec       = values + 4 * Nvalues;
+  double *pressure   = values + 5 * Nvalues;
+  double *shortwave  = values + 6 * Nvalues;
+  double *tskc       = values + 7 * Nvalues;
+  double *vp         = values + 8 * Nvalues;
+  double *vpd        = values + 9 * Nvalues;
+  double *wind       = values + 10 * Nvalues;
+  char   *snowflag   = (char *) (values + Nvars * Nvalues);
+
   for (int i = 0; i < nrecs; i++) {
-    atmos[i].air_temp = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].air_temp == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].channel_in = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].channel_in == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].density = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].density == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].longwave = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].longwave == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].prec = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].prec == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].pressure = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].pressure == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].shortwave = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].shortwave == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].snowflag = (char *) calloc(NR+1, sizeof(char));
-    if (atmos[i].snowflag == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].tskc = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].tskc == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].vp = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].vp == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].vpd = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].vpd == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-    atmos[i].wind = (double *) calloc(NR+1, sizeof(double));
-    if (atmos[i].wind == NULL)
-      vicerror("Memory allocation error in alloc_atmos().");
-  }    			
+    size_t offset = (size_t) i * (NR + 1);
+    atmos[i].air_temp   = air_temp + offset;
+    atmos[i].channel_in = channel_in + offset;
+    atmos[i].density    = density + offset;
+    atmos[i].longwave   = longwave + offset;
+    atmos[i].prec       = prec + offset;
+    atmos[i].pressure   = pressure + offset;
+    atmos[i].shortwave  = shortwave + offset;
+    atmos[i].snowflag   = snowflag + offset;
+    atmos[i].tskc       = tskc + offset;
+    atmos[i].vp         = vp + offset;
+    atmos[i].vpd        = vpd + offset;
+    atmos[i].wind       = wind + offset;
+  }
   return atmos;
 }
 
@@ -100,25 +102,43 @@ void free_atmos(int nrecs, atmos_data_struct **atmos)
   2011-Nov-04 Added tskc.						TJB
 ***************************************************************************/
 {
-  int i;
-
   if (*atmos == NULL)
     return;
 
-  for (i = 0; i < nrecs; i++) {
-    free((*atmos)[i].air_temp);
-    free((*atmos)[i].channel_in);
-    free((*atmos)[i].density);
-    free((*atmos)[i].longwave);
-    free((*atmos)[i].prec);
-    free((*atmos)[i].pressure);
-    free((*atmos)[i].shortwave);
-    free((*atmos)[i].snowflag);
-    free((*atmos)[i].tskc);
-    free((*atmos)[i].vp);
-    free((*atmos)[i].vpd);
-    free((*atmos)[i].wind);
-  }
-
+  /* The records and all of their arrays are one allocation, see alloc_atmos() */
   free(*atmos);
+  *atmos = NULL;
+}
+
+/****************************************************************************/
+/*			       copy_atmos()                                 */
+/****************************************************************************/
+void copy_atmos(atmos_data_struct *dest, const atmos_data_struct *src, int nrecs, int NR)
+/***************************************************************************
+  Copies nrecs records from src to dest. Both must be (parts of) arrays
+  allocated by alloc_atmos(), so each variable is contiguous over records.
+***************************************************************************/
+{
+  size_t Nvalues = (size_t) nrecs * (NR + 1);
+
+  if (nrecs <= 0)
+    return;
+
+  memcpy(dest[0].air_temp, src[0].air_temp, Nvalues * sizeof(double));
+  memcpy(dest[0].channel_in, src[0].channel_in, Nvalues * sizeof(double));
+  memcpy(dest[0].density, src[0].density, Nvalues * sizeof(double));
+  memcpy(dest[0].longwave, src[0].longwave, Nvalues * sizeof(double));
+  memcpy(dest[0].prec, src[0].prec, Nvalues * sizeof(double));
+  memcpy(dest[0].pressure, src[0].pressure, Nvalues * sizeof(double));
+  memcpy(dest[0].shortwave, src[0].shortwave, Nvalues * sizeof(double));
+  memcpy(dest[0].snowflag, src[0].snowflag, Nvalues * sizeof(char));
+  memcpy(dest[0].tskc, src[0].tskc, Nvalues * sizeof(double));
+  memcpy(dest[0].vp, src[0].vp, Nvalues * sizeof(double));
+  memcpy(dest[0].vpd, src[0].vpd, Nvalues * sizeof(double));
+  memcpy(dest[0].wind, src[0].wind, Nvalues * sizeof(double));
+  for (int i = 0; i < nrecs; i++) {
+    dest[i].out_prec = src[i].out_prec;
+    dest[i].out_rain = src[i].out_rain;
+    dest[i].out_snow = src[i].out_snow;
+  }
 }
@@ -0,0 +1,106 @@
+/*
+ * Purpose: allocate and free the runtime-sized model state of a grid cell
+ * Usage  : Part of VIC
+ * Notes  : The soil thermal node arrays of the energy balance structures are
+ *          sized by Nnode rather than MAX_NODES, and the lake state is only
+ *          allocated for cells with a lake.
+ */
+
+/****************************************************************************/
+/*			  PREPROCESSOR DIRECTIVES                           */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "vicNl.h"
+
+static char vcid[] = "$Id$";
+
+/****************************************************************************/
+/*			     energy_nodes_size()                            */
+/****************************************************************************/
+size_t energy_nodes_size(int Nnode)
+/*******************************************************************
+  energy_nodes_size
+
+  Bytes of node storage needed by one energy balance structure: the
+  five double arrays, then T_fbcount and T_fbflag, rounded up so that
+  the next structure's doubles stay aligned.
+*******************************************************************/
+{
+  size_t bytes = (size_t) Nnode * (5 * sizeof(double) + sizeof(int) + sizeof(char));
+  return (bytes + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+}
+
+/****************************************************************************/
+/*			    attach_energy_nodes()                           */
+/****************************************************************************/
+char * attach_energy_nodes(energy_bal_struct *energy, char *storage, int Nnode)
+/*******************************************************************
+  attach_energy_nodes
+
+  Points the soil thermal node arrays of energy into storage, which
+  must hold energy_nodes_size(Nnode) bytes.  Returns the storage that
+  follows, for the next structure.
+*******************************************************************/
+{
+  double *values = (double *) storage;
+  energy->Cs_node     = values;
+  energy->ice_content = values + 1 * Nnode;
+  energy->kappa_node  = values + 2 * Nnode;
+  energy->moist       = values + 3 * Nnode;
+  energy->T           = values + 4 * Nnode;
+  energy->T_fbcount   = (int *) (values + 5 * Nnode);
+  energy->T_fbflag    = (char *) (energy->T_fbcount + Nnode);
+  return storage + energy_nodes_size(Nnode);
+}
+
+/****************************************************************************/
+/*			     alloc_cell_state()                             */
+/****************************************************************************/
+void alloc_cell_state(cell_info_struct *cell, const ProgramState *state)
+/*******************************************************************
+  alloc_cell_state
+
+  Allocates the lake state of a cell with a lake, and one block of
+  node storage holding the soil thermal node arrays of all HRUs of
+  the cell (and of its lake), so that the state of a cell is stored
+  together.  Must be called once the HRUs and the lake parameters of
+  the cell have been read.
+*******************************************************************/
+{
+  const int Nnode = state->options.Nnode;
+
+  if (state->options.LAKES && cell->lake_con.lake_idx >= 0) {
+    cell->prcp.lake_var = new lake_var_struct();
+  }
+
+  size_t numEnergy = cell->prcp.hruList.size() + (cell->prcp.lake_var != NULL ? 1 : 0);
+  cell->prcp.nodeStorage = (char *) calloc(numEnergy, energy_nodes_size(Nnode));
+  if (cell->prcp.nodeStorage == NULL && numEnergy > 0)
+    vicerror("Memory allocation error in alloc_cell_state().");
+
+  char *storage = cell->prcp.nodeStorage;
+  for (std::vector<HRU>::iterator hru = cell->prcp.hruList.begin(); hru != cell->prcp.hruList.end(); ++hru) {
+    storage = attach_energy_nodes(&hru->energy, storage, Nnode);
+  }
+  if (cell->prcp.lake_var != NULL) {
+    attach_energy_nodes(&cell->prcp.lake_var->energy, storage, Nnode);
+  }
+}
+
+/****************************************************************************/
+/*	      		      free_cell_state()                             */
+/****************************************************************************/
+void free_cell_state(cell_info_struct *cell)
+/*******************************************************************
+  free_cell_state
+
+  Frees the memory allocated by alloc_cell_state().
+*******************************************************************/
+{
+  free(cell->prcp.nodeStorage);
+  cell->prcp.nodeStorage = NULL;
+  delete cell->prcp.lake_var;
+  cell->prcp.lake_var = NULL;
+}
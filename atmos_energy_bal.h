@@ -7,7 +7,7 @@ class AtmosEnergyBal : public RootBrent {
 public:
   AtmosEnergyBal(double LatentHeat, double NetRadiation, double Ra, double Tair,
       double atmos_density, double InSensible, double *SensibleHeat) :
-      LatentHeat(LatentHeat), NetRadiation(NetRadiation), Ra(Ra), Tair(Tair), atmos_density(
+      RootBrent(SOLVER_TCANOPY), LatentHeat(LatentHeat), NetRadiation(NetRadiation), Ra(Ra), Tair(Tair), atmos_density(
           atmos_density), InSensible(InSensible), SensibleHeat(SensibleHeat) {
   }
   double calculate(double Tcanopy);
@@ -104,7 +104,8 @@ double calc_atmos_energy_bal(double  InOverSensible,
   AtmosEnergyBal atmosEnergyBalanceIterative((*LatentHeat) + (*LatentHeatSub),
            NetRadiation, Ra, Tair, atmos_density, InSensible,
            SensibleHeat);
-  Tcanopy = atmosEnergyBalanceIterative.root_brent(T_lower, T_upper, ErrorString);
+  Tcanopy = atmosEnergyBalanceIterative.solve(Tair, T_lower, T_upper, ErrorString,
+      state->options.WARM_START);
 
   if ( atmosEnergyBalanceIterative.resultIsError(Tcanopy) ) {
     if (state->options.TFALLBACK) {
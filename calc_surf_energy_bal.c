@@ -343,7 +343,8 @@ double calc_surf_energy_bal(double             latent_heat_Le,
         &energy->deltaH, &energy->fusion, &energy->grnd_flux,
         &energy->latent, &energy->latent_sub,
         &energy->sensible, &energy->snow_flux, &energy->error, state);
-    Tsurf = surfEnergyBalIterative.root_brent(T_lower, T_upper, ErrorString);
+    Tsurf = surfEnergyBalIterative.solve(Ts_old, T_lower, T_upper, ErrorString,
+        state->options.WARM_START);
  
     if(surfEnergyBalIterative.resultIsError(Tsurf)) {
       if (state->options.TFALLBACK) {
@@ -421,7 +422,8 @@ double calc_surf_energy_bal(double             latent_heat_Le,
           &energy->grnd_flux, &energy->latent, &energy->latent_sub,
           &energy->sensible, &energy->snow_flux, &energy->error, state);
       
-      Tsurf = surfEnergyBalIter2.root_brent(T_lower, T_upper, ErrorString);
+      Tsurf = surfEnergyBalIter2.solve(Ts_old, T_lower, T_upper, ErrorString,
+          state->options.WARM_START);
 
 
       if(surfEnergyBalIter2.resultIsError(Tsurf)) {
@@ -20,7 +20,7 @@ public:
       double* LongOverOut, double* NetLongOver, double* NetRadiation,
       double* RefreezeEnergy, double* SensibleHeat, double* VaporMassFlux,
       const ProgramState* state) :
-      month(month), rec(rec), delta_t(delta_t), elevation(elevation), Wcr(Wcr), Wpwp(Wpwp),
+      RootBrent(SOLVER_TFOLIAGE), month(month), rec(rec), delta_t(delta_t), elevation(elevation), Wcr(Wcr), Wpwp(Wpwp),
       depth(depth), frost_fract(frost_fract), AirDens(AirDens), EactAir(EactAir), Press(Press), latent_heat_Le(latent_heat_Le),
       Tcanopy(Tcanopy), Vpd(Vpd), precipitation_mu(precipitation_mu), Evap(Evap), Ra(Ra), Ra_used(Ra_used),
       Rainfall(Rainfall), wind_speed(wind_speed), UnderStory(UnderStory), veg_class(veg_class), displacement(displacement),
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "vicNl.h"
+#include "ParamFileIndex.h"
 #include "WriteOutputNetCDF.h"
 
 static char vcid[] = "$Id$";
@@ -39,14 +40,30 @@ filep_struct get_files(const filenames_struct *fnames, ProgramState* state)
   filep_struct file_pointers;
 
   file_pointers.soilparam   = open_file(fnames->soil, "r");
+  file_pointers.vegparam_index  = NULL;
+  file_pointers.snowband_index  = NULL;
+  file_pointers.lakeparam_index = NULL;
+  file_pointers.forcing[0] = NULL;
+  file_pointers.forcing[1] = NULL;
+  file_pointers.forcing_reader[0] = NULL;
+  file_pointers.forcing_reader[1] = NULL;
 
   if (!state->options.OUTPUT_FORCE) {
     file_pointers.veglib      = open_file(fnames->veglib, "r");
     file_pointers.vegparam    = open_file(fnames->veg, "r");
-    if(state->options.SNOW_BAND>1)
+    // Index the per-cell parameter files once, so that each cell can seek directly to its record.
+    file_pointers.vegparam_index = new ParamFileIndex(file_pointers.vegparam);
+    file_pointers.vegparam_index->buildVegParam(state->options.VEGPARAM_LAI ? 2 : 1);
+    if(state->options.SNOW_BAND>1) {
       file_pointers.snowband    = open_file(fnames->snowband, "r");
-    if ( state->options.LAKES )
+      file_pointers.snowband_index = new ParamFileIndex(file_pointers.snowband);
+      file_pointers.snowband_index->buildSnowBand();
+    }
+    if ( state->options.LAKES ) {
       file_pointers.lakeparam = open_file(fnames->lakeparam,"r");
+      file_pointers.lakeparam_index = new ParamFileIndex(file_pointers.lakeparam);
+      file_pointers.lakeparam_index->buildLakeParam();
+    }
   }
 
   return file_pointers;
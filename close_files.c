@@ -2,7 +2,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include "vicNl.h"
-#include <netcdf.h>
  
 static char vcid[] = "$Id$";
 
@@ -37,16 +36,13 @@ void close_files(const filep_struct   *filep,
     Close All Input Files
     **********************/
 
+  /* NetCDF forcing files are closed when their NetCDFForcingReader is deleted */
   if(state->param_set.FORCE_FORMAT[0] != NETCDF)
     fclose(filep->forcing[0]);
-  else /* FIXME this should only happen ONCE per invokation of VIC! (below too) */
-    nc_close(filep->forcing_ncid[0]);
   if(compress) compress_files(fnames->forcing[0]);
   if(filep->forcing[1]!=NULL) {
     if(state->param_set.FORCE_FORMAT[1] != NETCDF)
       fclose(filep->forcing[1]);
-    else
-      nc_close(filep->forcing_ncid[1]);      
     if(compress) compress_files(fnames->forcing[1]);
   }
 
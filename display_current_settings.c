@@ -104,12 +104,6 @@ void ProgramState::display_current_settings(int mode,filenames_struct *names)
 #else
   fprintf(stderr,"LOW_RES_MOIST\t\tFALSE\n");
 #endif
-#if QUICK_FS
-  fprintf(stderr,"QUICK_FS\t\tTRUE\n");
-  fprintf(stderr,"QUICK_FS_TEMPS\t%d\n",QUICK_FS_TEMPS);
-#else
-  fprintf(stderr,"QUICK_FS\t\tFALSE\n");
-#endif
 #if SPATIAL_FROST
   fprintf(stderr,"SPATIAL_FROST\t\tTRUE\n");
   fprintf(stderr,"FROST_SUBAREAS\t\t%d\n",FROST_SUBAREAS);
@@ -260,6 +254,12 @@ void ProgramState::display_current_settings(int mode,filenames_struct *names)
     fprintf(stderr,"QUICK_FLUX\t\tTRUE\n");
   else
     fprintf(stderr,"QUICK_FLUX\t\tFALSE\n");
+  if (options.QUICK_FS) {
+    fprintf(stderr,"QUICK_FS\t\tTRUE\n");
+    fprintf(stderr,"QUICK_FS_TEMPS\t\t%d\n",QUICK_FS_TEMPS);
+  }
+  else
+    fprintf(stderr,"QUICK_FS\t\tFALSE\n");
   if (options.QUICK_SOLVE)
     fprintf(stderr,"QUICK_SOLVE\t\tTRUE\n");
   else
@@ -277,6 +277,10 @@ void ProgramState::display_current_settings(int mode,filenames_struct *names)
     fprintf(stderr,"TFALLBACK\t\tTRUE\n");
   else
     fprintf(stderr,"TFALLBACK\t\tFALSE\n");
+  if (options.WARM_START == TRUE)
+    fprintf(stderr,"WARM_START\t\tTRUE\n");
+  else
+    fprintf(stderr,"WARM_START\t\tFALSE\n");
 
   if (options.VP_INTERP == TRUE)
     fprintf(stderr,"VP_INTERP\t\tTRUE\n");
@@ -452,6 +456,9 @@ void ProgramState::display_current_settings(int mode,filenames_struct *names)
   	fprintf(stderr, "OUTPUT_FORCE\t\tFALSE\n");
 
   fprintf(stderr, "PARALLEL_THREADS\t%d\n", global_param.num_threads);
+  fprintf(stderr, "FORCING_WINDOW\t\t%d\n", global_param.forcing_window);
+  fprintf(stderr, "OUTPUT_QUEUE_DEPTH\t%d\n", global_param.output_queue_depth);
+  fprintf(stderr, "TIME_BLOCK\t\t%d\n", global_param.time_block);
 
   if (options.COMPRESS)
     fprintf(stderr,"COMPRESS\t\tTRUE\n");
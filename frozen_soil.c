@@ -112,7 +112,7 @@ int  solve_T_profile(double *T,
 		     double  deltat,
 		     double *ice,
 		     double Dp,
-		     double **const* ufwc_table_node,
+		     const UfwcTable *const* ufwc_table_node,
 		     int     Nnodes,
 		     int    *FIRST_SOLN,
 		     int     NOFLUX,
@@ -147,11 +147,13 @@ int  solve_T_profile(double *T,
   2009-Sep-19 Added T fbcount to count TFALLBACK occurrences.			TJB
 **********************************************************************/
   
-  double A[MAX_NODES];
-  double B[MAX_NODES];
-  double C[MAX_NODES];
-  double D[MAX_NODES];
-  double E[MAX_NODES];
+  // The constants are only computed when FIRST_SOLN is set, and reused by the following
+  // calls of the same surface energy balance solution, so they must outlive this call.
+  static thread_local double A[MAX_NODES];
+  static thread_local double B[MAX_NODES];
+  static thread_local double C[MAX_NODES];
+  static thread_local double D[MAX_NODES];
+  static thread_local double E[MAX_NODES];
 
   double Bexp;
 
@@ -319,7 +321,7 @@ int calc_soil_thermal_fluxes(int     Nnodes,
 			     double *C, 
 			     double *D, 
 			     double *E,
-			     double **const *ufwc_table_node,
+			     const UfwcTable *const *ufwc_table_node,
 			     int    FS_ACTIVE, 
 			     int    NOFLUX,
 			     int EXP_TRANS,
@@ -362,6 +364,11 @@ int calc_soil_thermal_fluxes(int     Nnodes,
   double oldT;
   char ErrorString[MAXSTRING];
   double Tlast[MAX_NODES];
+  double Tlin0[MAX_NODES], Tlin_down[MAX_NODES], Tlin_up[MAX_NODES];
+  double rden;
+  int    last;
+  char   linear_only;
+  char   quick_fs;
 
   Error = 0;
   Done = FALSE;
@@ -377,6 +384,32 @@ int calc_soil_thermal_fluxes(int     Nnodes,
     Tfbcount[j] = 0;
   }
 
+  /* The 2nd order variable kappa equation is linear for nodes which are not
+     freezing: T[j] = Tlin0[j] + Tlin_down[j]*T[j+1] + Tlin_up[j]*T[j-1]
+     (with T[j+1] replaced by T[j] for the NOFLUX bottom node).  The stencil
+     weights do not change between sweeps, so compute them once, in a single
+     pass over the node arrays. */
+  last = NOFLUX ? Nnodes-1 : Nnodes-2;
+  if(!EXP_TRANS) {
+    for(j=1;j<=last;j++) {
+      rden = 1. / (A[j]+C[j]+D[j]);
+      Tlin0[j] = (A[j]*T0[j]+E[j]*(0.-ice[j])) * rden;
+      Tlin_down[j] = (B[j]+C[j]) * rden;
+      Tlin_up[j] = (D[j]-B[j]) * rden;
+    }
+  }
+  else {
+    for(j=1;j<=last;j++) {
+      rden = 1. / (A[j]+2.*C[j]);
+      Tlin0[j] = (A[j]*T0[j]+E[j]*(0.-ice[j])) * rden;
+      Tlin_down[j] = (B[j]+C[j]-D[j]) * rden;
+      Tlin_up[j] = (C[j]+D[j]-B[j]) * rden;
+    }
+  }
+  /* Only nodes below 0C need the nonlinear solution, and only with frozen soil active */
+  linear_only = !FS_ACTIVE || !state->options.FROZEN_SOIL;
+  quick_fs = state->options.QUICK_FS;
+
   while(!Done && Error==0 && ItCount<MAXIT) {
     ItCount++;
     maxdiff=threshold;
@@ -385,21 +418,18 @@ int calc_soil_thermal_fluxes(int     Nnodes,
       
       /**	2nd order variable kappa equation **/
       
-      if(T[j] >= 0 || !FS_ACTIVE || !state->options.FROZEN_SOIL) {
-	if(!EXP_TRANS)
-	  T[j] = (A[j]*T0[j]+B[j]*(T[j+1]-T[j-1])+C[j]*T[j+1]+D[j]*T[j-1]+E[j]*(0.-ice[j]))/(A[j]+C[j]+D[j]);
-	else
-	  T[j] = (A[j]*T0[j]+B[j]*(T[j+1]-T[j-1])+C[j]*(T[j+1]+T[j-1])-D[j]*(T[j+1]-T[j-1])+E[j]*(0.-ice[j]))/(A[j]+2.*C[j]);
+      if(linear_only || T[j] >= 0) {
+        T[j] = Tlin0[j] + Tlin_down[j]*T[j+1] + Tlin_up[j]*T[j-1];
       }
       else {
 
 
         SoilThermalEqn soilThermalEqnIteration(T[j + 1], T[j - 1], T0[j],
-            moist[j], max_moist[j], ufwc_table_node[j], bubble[j], expt[j],
+            moist[j], max_moist[j], quick_fs ? ufwc_table_node[j] : NULL, bubble[j], expt[j],
             ice[j], gamma[j - 1], A[j], B[j], C[j], D[j], E[j], EXP_TRANS, j);
 
-        T[j] = soilThermalEqnIteration.root_brent(T0[j] - (SOIL_DT),
-            T0[j] + (SOIL_DT), ErrorString);
+        T[j] = soilThermalEqnIteration.solve(T[j], T0[j] - (SOIL_DT),
+            T0[j] + (SOIL_DT), ErrorString, state->options.WARM_START);
 	
 	if(soilThermalEqnIteration.resultIsError(T[j])) {
           if (state->options.TFALLBACK) {
@@ -425,22 +455,20 @@ int calc_soil_thermal_fluxes(int     Nnodes,
       j = Nnodes-1;
       oldT=T[j];
       
-      if(T[j] >= 0 || !FS_ACTIVE || !state->options.FROZEN_SOIL) {
-	if(!EXP_TRANS )
-	  T[j] = (A[j]*T0[j]+B[j]*(T[j]-T[j-1])+C[j]*T[j]+D[j]*T[j-1]+E[j]*(0.-ice[j]))/(A[j]+C[j]+D[j]);
-	else
-	  T[j] = (A[j]*T0[j]+B[j]*(T[j]-T[j-1])+C[j]*(T[j]+T[j-1])-D[j]*(T[j]-T[j-1])+E[j]*(0.-ice[j]))/(A[j]+2.*C[j]);
+      if(linear_only || T[j] >= 0) {
+        T[j] = Tlin0[j] + Tlin_down[j]*T[j] + Tlin_up[j]*T[j-1];
       }
       else {
 
         SoilThermalEqn soilThermalEqnIteration(T[Nnodes - 1], T[Nnodes - 2],
             T0[Nnodes - 1], moist[Nnodes - 1], max_moist[Nnodes - 1],
-            ufwc_table_node[Nnodes - 1], bubble[j], expt[Nnodes - 1],
+            quick_fs ? ufwc_table_node[Nnodes - 1] : NULL, bubble[j], expt[Nnodes - 1],
             ice[Nnodes - 1], gamma[Nnodes - 2], A[j], B[j], C[j], D[j], E[j],
             EXP_TRANS, j);
 
-        T[Nnodes - 1] = soilThermalEqnIteration.root_brent(
-            T0[Nnodes - 1] - SOIL_DT, T0[Nnodes - 1] + SOIL_DT, ErrorString);
+        T[Nnodes - 1] = soilThermalEqnIteration.solve(T[Nnodes - 1],
+            T0[Nnodes - 1] - SOIL_DT, T0[Nnodes - 1] + SOIL_DT, ErrorString,
+            state->options.WARM_START);
 	
 	if(soilThermalEqnIteration.resultIsError(T[j])) {
           if (state->options.TFALLBACK) {
@@ -537,7 +565,7 @@ double error_print_solve_T_profile(double T, double TL, double TU, double T0,
 
 
 
-void NewtonRaphsonMethod::fda_heat_eqn(double T_2[], double res[], int n, int focus)
+void NewtonRaphsonMethod::fda_heat_eqn(double T_2[], double res[], int n)
 {
   /**********************************************************************
   Heat Equation for implicit scheme (used to calculate residual of the heat equation)
@@ -561,243 +589,222 @@ void NewtonRaphsonMethod::fda_heat_eqn(double T_2[], double res[], int n, int fo
 	      organic fraction into account.					TJB
   2011-Jun-10 Added bulk_dens_min and soil_dens_min to arglist of
 	      soil_conductivity() to fix bug in commputation of kappa.		TJB
+  The node properties are computed by update_node_properties(), and the
+  terms used by the Jacobian are kept for heat_eqn_jacobian().
   **********************************************************************/
   
   // locally used variables
-  double ice_new[MAX_NODES], Cs_new[MAX_NODES], kappa_new[MAX_NODES];
-  double DT[MAX_NODES],DT_down[MAX_NODES],DT_up[MAX_NODES],T_up[MAX_NODES];
-  double Dkappa[MAX_NODES];
-  char PAST_BOTTOM;
+  double T_up;
   double storage_term, flux_term, phase_term, flux_term1, flux_term2;
-  double Lsum;
-  int i, lidx;
-  int left, right;
-    
-    // calculate all entries if focus == -1
-  if (focus == -1) {
-
-    lidx = 0;
-    Lsum = 0.;
-    PAST_BOTTOM = FALSE;
-
-    for (i = 0; i < n + 1; i++) {
-      kappa_new[i] = kappa[i];
-      if (i >= 1) {  //all but surface node
-        // update ice contents
-        if (T_2[i - 1] < 0) {
-          ice_new[i] = moist[i] - maximum_unfrozen_water(T_2[i - 1], max_moist[i], bubble[i], expt[i]);
-          if (ice_new[i] < 0)
-            ice_new[i] = 0;
-        } else
-          ice_new[i] = 0;
-        Cs_new[i] = Cs[i];
-
-        // update other states due to ice content change
-        /***********************************************/
-        if (ice_new[i] != ice[i]) {
-          kappa_new[i] = soil_conductivity(moist[i], moist[i] - ice_new[i],
-              soil_dens_min[lidx], bulk_dens_min[lidx], quartz[lidx],
-              soil_density[lidx], bulk_density[lidx], organic[lidx]);
-          Cs_new[i] = volumetric_heat_capacity(
-              bulk_density[lidx] / soil_density[lidx], moist[i] - ice_new[i],
-              ice_new[i], organic[lidx]);
-        }
-        /************************************************/
-      }
-
-      if (Zsum[i] > Lsum + depth[lidx] && !PAST_BOTTOM) {
-        Lsum += depth[lidx];
-        lidx++;
-        if (lidx == Nlayers) {
-          PAST_BOTTOM = TRUE;
-          lidx = Nlayers - 1;
-        }
-      }
+  int i;
+
+  update_node_properties(T_2, n);
+
+  // constants used in fda equation
+  for (i = 0; i < n; i++) {
+    if (i == 0) {
+      DT[i] = T_2[i + 1] - Ts;
+      DT_up[i] = T_2[i] - Ts;
+      DT_down[i] = T_2[i + 1] - T_2[i];
+    } else if (i == n - 1) {
+      DT[i] = Tb - T_2[i - 1];
+      DT_up[i] = T_2[i] - T_2[i - 1];
+      DT_down[i] = Tb - T_2[i];
+    } else {
+      DT[i] = T_2[i + 1] - T_2[i - 1];
+      DT_up[i] = T_2[i] - T_2[i - 1];
+      DT_down[i] = T_2[i + 1] - T_2[i];
     }
+    if (i < n - 1)
+      Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
+    else if (!NOFLUX)
+      Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
+    else
+      Dkappa[i] = kappa_new[i + 1] - kappa_new[i];
+  }
 
-    // constants used in fda equation
-    for (i = 0; i < n; i++) {
-      if (i == 0) {
-        DT[i] = T_2[i + 1] - Ts;
-        DT_up[i] = T_2[i] - Ts;
-        DT_down[i] = T_2[i + 1] - T_2[i];
-        T_up[i] = Ts;
-      } else if (i == n - 1) {
-        DT[i] = Tb - T_2[i - 1];
-        DT_up[i] = T_2[i] - T_2[i - 1];
-        DT_down[i] = Tb - T_2[i];
-        T_up[i] = T_2[i - 1];
-      } else {
-        DT[i] = T_2[i + 1] - T_2[i - 1];
-        DT_up[i] = T_2[i] - T_2[i - 1];
-        DT_down[i] = T_2[i + 1] - T_2[i];
-        T_up[i] = T_2[i - 1];
-      }
-      if (i < n - 1)
-        Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
-      else if (!NOFLUX)
-        Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
-      else
-        Dkappa[i] = kappa_new[i + 1] - kappa_new[i];
+  for (i = 0; i < n; i++) {
+    T_up = (i == 0) ? Ts : T_2[i - 1];
+    storage_term = Cs_new[i + 1] * (T_2[i] - T0[i + 1]) / deltat
+        + T_2[i] * (Cs_new[i + 1] - Cs[i + 1]) / deltat;
+    if (!EXP_TRANS) {
+      flux_term1 = Dkappa[i] / alpha[i] * DT[i] / alpha[i];
+      flux_term2 = kappa_new[i + 1]
+          * (DT_down[i] / gamma[i] - DT_up[i] / beta[i]) / (0.5 * alpha[i]);
+    } else { //grid transformation
+      flux_term1 = Dkappa[i] / 2. * DT[i] / 2. / (Bexp * (Zsum[i + 1] + 1.))
+          / (Bexp * (Zsum[i + 1] + 1.));
+      flux_term2 =
+          kappa_new[i + 1]
+              * ((DT_down[i] - DT_up[i]) / (Bexp * (Zsum[i + 1] + 1.))
+                  / (Bexp * (Zsum[i + 1] + 1.))
+                  - DT[i] / 2.
+                      / (Bexp * (Zsum[i + 1] + 1.) * (Zsum[i + 1] + 1.)));
     }
-
-    for (i = 0; i < n; i++) {
-      storage_term = Cs_new[i + 1] * (T_2[i] - T0[i + 1]) / deltat
-          + T_2[i] * (Cs_new[i + 1] - Cs[i + 1]) / deltat;
-      if (!EXP_TRANS) {
-        flux_term1 = Dkappa[i] / alpha[i] * DT[i] / alpha[i];
-        flux_term2 = kappa_new[i + 1]
-            * (DT_down[i] / gamma[i] - DT_up[i] / beta[i]) / (0.5 * alpha[i]);
-      } else { //grid transformation
-        flux_term1 = Dkappa[i] / 2. * DT[i] / 2. / (Bexp * (Zsum[i + 1] + 1.))
-            / (Bexp * (Zsum[i + 1] + 1.));
-        flux_term2 =
-            kappa_new[i + 1]
-                * ((DT_down[i] - DT_up[i]) / (Bexp * (Zsum[i + 1] + 1.))
-                    / (Bexp * (Zsum[i + 1] + 1.))
-                    - DT[i] / 2.
-                        / (Bexp * (Zsum[i + 1] + 1.) * (Zsum[i + 1] + 1.)));
-      }
-      //inelegant fix for "cold nose" problem - when a very cold node skates off to
-      //much colder and breaks the second law of thermodynamics (because
-      //flux_term1 exceeds flux_term2 in absolute magnitude) - therefore, don't let
-      //that node get any colder.  This only seems to happen in the first and
-      //second near-surface nodes.
-//	if(i==0 || i==1 ){//surface nodes only
-      if (fabs(DT[i]) > 5. && (T_2[i] < T_2[i + 1] && T_2[i] < T_up[i])) {//cold nose
-        if ((flux_term1 < 0 && flux_term2 > 0)
-            && fabs(flux_term1) > fabs(flux_term2)) {
-          flux_term1 = 0;
+    //inelegant fix for "cold nose" problem - when a very cold node skates off to
+    //much colder and breaks the second law of thermodynamics (because
+    //flux_term1 exceeds flux_term2 in absolute magnitude) - therefore, don't let
+    //that node get any colder.  This only seems to happen in the first and
+    //second near-surface nodes.
+    coldNose[i] = false;
+    if (fabs(DT[i]) > 5. && (T_2[i] < T_2[i + 1] && T_2[i] < T_up)) {//cold nose
+      if ((flux_term1 < 0 && flux_term2 > 0)
+          && fabs(flux_term1) > fabs(flux_term2)) {
+        flux_term1 = 0;
+        coldNose[i] = true;
 #if VERBOSE
-          fprintf(stderr,
-              "WARNING: resetting thermal flux term in soil heat solution to zero for node %d.\nT[i]=%.2f T[i-1]=%.2f T[i+1]=%.2f flux_term1=%.2f flux_term2=%.2f\n",
-              i + 1, T_2[i], T_up[i], T_2[i + 1], flux_term1, flux_term2);
+        fprintf(stderr,
+            "WARNING: resetting thermal flux term in soil heat solution to zero for node %d.\nT[i]=%.2f T[i-1]=%.2f T[i+1]=%.2f flux_term1=%.2f flux_term2=%.2f\n",
+            i + 1, T_2[i], T_up, T_2[i + 1], flux_term1, flux_term2);
 #endif
-        }
       }
-//	}
-      flux_term = flux_term1 + flux_term2;
-      phase_term = ice_density * Lf * (ice_new[i + 1] - ice[i + 1]) / deltat;
-      res[i] = flux_term + phase_term - storage_term;
     }
+    flux_term = flux_term1 + flux_term2;
+    phase_term = ice_density * Lf * (ice_new[i + 1] - ice[i + 1]) / deltat;
+    res[i] = flux_term + phase_term - storage_term;
   }
+}
 
-  // only calculate entries focus-1, focus, and focus+1 if focus has a value>=0
-  else {
-    if (focus == 0)
-      left = 0;
-    else
-      left = focus - 1;
-    if (focus == n - 1)
-      right = n - 1;
-    else
-      right = focus + 1;
-
-    // update ice content for node focus and its adjacents
-    for (i = left; i <= right; i++) {
-      if (T_2[i] < 0) {
-        ice_new[i + 1] = moist[i + 1] - maximum_unfrozen_water(T_2[i], max_moist[i + 1], bubble[i + 1],
-                expt[i + 1]);
-        if (ice_new[i + 1] < 0)
-          ice_new[i + 1] = 0;
-      } else
-        ice_new[i + 1] = 0;
-    }
+void NewtonRaphsonMethod::update_node_properties(double T_2[], int n)
+{
+  /**********************************************************************
+  Computes the ice content, thermal conductivity and heat capacity of the
+  nodes for the temperatures T_2 (T_2[i] is the temperature of node i+1),
+  and their derivatives with respect to the temperature of the node.  The
+  surface node, and the bottom node unless NOFLUX, have fixed temperatures
+  and keep their conductivities.
+  **********************************************************************/
 
-    // update other parameters due to ice content change
-    /********************************************************/
-    lidx = 0;
-    Lsum = 0.;
-    PAST_BOTTOM = FALSE;
-    for (i = 0; i <= right + 1; i++) {
-      if (i >= left + 1) {
-        if (ice_new[i] != ice[i]) {
-          kappa_new[i] = soil_conductivity(moist[i], moist[i] - ice_new[i],
+  char PAST_BOTTOM;
+  double Lsum;
+  double dCs_dice;
+  int i, lidx, last;
+
+  lidx = 0;
+  Lsum = 0.;
+  PAST_BOTTOM = FALSE;
+  last = NOFLUX ? n : n + 1;
+
+  for (i = 0; i <= last; i++) {
+    kappa_new[i] = kappa[i];
+    dkappa_dT[i] = 0;
+    dice_dT[i] = 0;
+    dCs_dT[i] = 0;
+    if (i >= 1 && i <= n) {  //all but the boundary nodes
+      // update ice contents
+      if (T_2[i - 1] < 0) {
+        ice_new[i] = moist[i] - maximum_unfrozen_water(T_2[i - 1], max_moist[i], bubble[i], expt[i]);
+        if (ice_new[i] < 0)
+          ice_new[i] = 0;
+        else
+          dice_dT[i] = -maximum_unfrozen_water_dT(T_2[i - 1], max_moist[i], bubble[i], expt[i]);
+      } else
+        ice_new[i] = 0;
+      Cs_new[i] = Cs[i];
+
+      // update other states due to ice content change
+      /***********************************************/
+      if (ice_new[i] != ice[i]) {
+        kappa_new[i] = soil_conductivity(moist[i], moist[i] - ice_new[i],
+            soil_dens_min[lidx], bulk_dens_min[lidx], quartz[lidx],
+            soil_density[lidx], bulk_density[lidx], organic[lidx]);
+        Cs_new[i] = volumetric_heat_capacity(
+            bulk_density[lidx] / soil_density[lidx], moist[i] - ice_new[i],
+            ice_new[i], organic[lidx]);
+        if (dice_dT[i] != 0) {
+          // liquid water content is moist - ice, and the heat capacity is linear in the ice content
+          dkappa_dT[i] = -soil_conductivity_dWu(moist[i], moist[i] - ice_new[i],
               soil_dens_min[lidx], bulk_dens_min[lidx], quartz[lidx],
-              soil_density[lidx], bulk_density[lidx], organic[lidx]);
-          Cs_new[i] = volumetric_heat_capacity(
-              bulk_density[lidx] / soil_density[lidx], moist[i] - ice_new[i],
-              ice_new[i], organic[lidx]);
-        }
-      }
-      if (Zsum[i] > Lsum + depth[lidx] && !PAST_BOTTOM) {
-        Lsum += depth[lidx];
-        lidx++;
-        if (lidx == Nlayers) {
-          PAST_BOTTOM = TRUE;
-          lidx = Nlayers - 1;
+              soil_density[lidx], bulk_density[lidx], organic[lidx]) * dice_dT[i];
+          dCs_dice = volumetric_heat_capacity(bulk_density[lidx] / soil_density[lidx], 0., 1., organic[lidx])
+              - volumetric_heat_capacity(bulk_density[lidx] / soil_density[lidx], 1., 0., organic[lidx]);
+          dCs_dT[i] = dCs_dice * dice_dT[i];
         }
       }
+      /************************************************/
     }
-    /*********************************************************/
-
-    // update other states due to ice content change
-    for (i = left; i <= right; i++) {
-      if (i == 0) {
-        DT[i] = T_2[i + 1] - Ts;
-        DT_up[i] = T_2[i] - Ts;
-        DT_down[i] = T_2[i + 1] - T_2[i];
-        T_up[i] = Ts;
-      } else if (i == n - 1) {
-        DT[i] = Tb - T_2[i - 1];
-        DT_up[i] = T_2[i] - T_2[i - 1];
-        DT_down[i] = Tb - T_2[i];
-        T_up[i] = T_2[i - 1];
-      } else {
-        DT[i] = T_2[i + 1] - T_2[i - 1];
-        DT_up[i] = T_2[i] - T_2[i - 1];
-        DT_down[i] = T_2[i + 1] - T_2[i];
-        T_up[i] = T_2[i - 1];
+
+    if (Zsum[i] > Lsum + depth[lidx] && !PAST_BOTTOM) {
+      Lsum += depth[lidx];
+      lidx++;
+      if (lidx == Nlayers) {
+        PAST_BOTTOM = TRUE;
+        lidx = Nlayers - 1;
       }
-      //update Dkappa due to ice content change
-      /*******************************************/
-      if (i < n - 1)
-        Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
-      else if (!NOFLUX)
-        Dkappa[i] = kappa_new[i + 2] - kappa_new[i];
-      else
-        Dkappa[i] = kappa_new[i + 1] - kappa_new[i];
-      /********************************************/
     }
+  }
+}
 
-    for (i = left; i <= right; i++) {
-      storage_term = Cs_new[i + 1] * (T_2[i] - T0[i + 1]) / deltat
-          + T_2[i] * (Cs_new[i + 1] - Cs[i + 1]) / deltat;
-      if (!EXP_TRANS) {
-        flux_term1 = Dkappa[i] / alpha[i] * DT[i] / alpha[i];
-        flux_term2 = kappa_new[i + 1]
-            * (DT_down[i] / gamma[i] - DT_up[i] / beta[i]) / (0.5 * alpha[i]);
-      } else { //grid transformation
-        flux_term1 = Dkappa[i] / 2. * DT[i] / 2. / (Bexp * (Zsum[i + 1] + 1.))
-            / (Bexp * (Zsum[i + 1] + 1.));
-        flux_term2 =
-            kappa_new[i + 1]
-                * ((DT_down[i] - DT_up[i]) / (Bexp * (Zsum[i + 1] + 1.))
-                    / (Bexp * (Zsum[i + 1] + 1.))
-                    - DT[i] / 2.
-                        / (Bexp * (Zsum[i + 1] + 1.) * (Zsum[i + 1] + 1.)));
-      }
-      //inelegant fix for "cold nose" problem - when a very cold node skates off to
-      //much colder and breaks the second law of thermodynamics (because
-      //flux_term1 exceeds flux_term2 in absolute magnitude) - therefore, don't let
-      //that node get any colder.  This only seems to happen in the first and
-      //second near-surface nodes.
-      if (i == 0 || i == 1) {	//surface nodes only
-        if (fabs(DT[i]) > 5. && (T_2[i] < T_2[i + 1] && T_2[i] < T_up[i])) {//cold nose
-          if ((flux_term1 < 0 && flux_term2 > 0)
-              && fabs(flux_term1) > fabs(flux_term2)) {
-            flux_term1 = 0;
-#if VERBOSE
-            fprintf(stderr,
-                "WARNING: resetting thermal flux term in soil heat solution to zero for node %d.\nT[i]=%.2f T[i-1]=%.2f T[i+1]=%.2f flux_term1=%.2f flux_term2=%.2f\n",
-                i + 1, T_2[i], T_up[i], T_2[i + 1], flux_term1, flux_term2);
-#endif
-          }
-        }
-      }
-      flux_term = flux_term1 + flux_term2;
-      phase_term = ice_density * Lf * (ice_new[i + 1] - ice[i + 1]) / deltat;
-      res[i] = flux_term + phase_term - storage_term;
+void NewtonRaphsonMethod::heat_eqn_jacobian(double T_2[], double a[], double b[], double c[], int n)
+{
+  /**********************************************************************
+  Analytic Jacobian of the residual computed by fda_heat_eqn(), which must
+  have been called for the same T_2.  Residual i depends on T_2[i-1],
+  T_2[i] and T_2[i+1] only, so the Jacobian is tridiagonal:
+    a[i] = d res[i] / d T_2[i-1]
+    b[i] = d res[i] / d T_2[i]
+    c[i] = d res[i] / d T_2[i+1]
+  The boundary temperatures Ts and Tb are fixed.
+  **********************************************************************/
+
+  double up, down;            // 1 if the neighbouring node is an unknown, 0 if it is a boundary
+  double dDk_up, dDk, dDk_down;
+  double c1;                  // flux_term1 = c1 * Dkappa * DT
+  double flux_bracket;        // flux_term2 = kappa_new * flux_bracket
+  double db_up, db, db_down;  // derivatives of flux_bracket
+  double z2;
+  int i, k;
+
+  for (i = 0; i < n; i++) {
+    k = i + 1;
+    up = (i > 0) ? 1. : 0.;
+    down = (i < n - 1) ? 1. : 0.;
+
+    // derivatives of Dkappa
+    dDk_up = -dkappa_dT[k - 1];
+    if (i < n - 1 || !NOFLUX) {
+      dDk = 0;
+      dDk_down = dkappa_dT[k + 1];
     }
-  } // end of calculation of focus node only
+    else {
+      dDk = dkappa_dT[k];
+      dDk_down = 0;
+    }
+
+    if (!EXP_TRANS) {
+      c1 = 1. / (alpha[i] * alpha[i]);
+      flux_bracket = (DT_down[i] / gamma[i] - DT_up[i] / beta[i]) / (0.5 * alpha[i]);
+      db_up = up / beta[i] / (0.5 * alpha[i]);
+      db = (-1. / gamma[i] - 1. / beta[i]) / (0.5 * alpha[i]);
+      db_down = down / gamma[i] / (0.5 * alpha[i]);
+    }
+    else { //grid transformation
+      z2 = (Bexp * (Zsum[k] + 1.)) * (Bexp * (Zsum[k] + 1.));
+      c1 = 0.25 / z2;
+      flux_bracket = (DT_down[i] - DT_up[i]) / z2
+          - DT[i] / 2. / (Bexp * (Zsum[k] + 1.) * (Zsum[k] + 1.));
+      db_up = up * (1. / z2 + 0.5 / (Bexp * (Zsum[k] + 1.) * (Zsum[k] + 1.)));
+      db = -2. / z2;
+      db_down = down * (1. / z2 - 0.5 / (Bexp * (Zsum[k] + 1.) * (Zsum[k] + 1.)));
+    }
+
+    // flux_term2
+    a[i] = kappa_new[k] * db_up;
+    b[i] = kappa_new[k] * db + dkappa_dT[k] * flux_bracket;
+    c[i] = kappa_new[k] * db_down;
+
+    // flux_term1, unless it was reset for a cold nose
+    if (!coldNose[i]) {
+      a[i] += c1 * (dDk_up * DT[i] - up * Dkappa[i]);
+      b[i] += c1 * dDk * DT[i];
+      c[i] += c1 * (dDk_down * DT[i] + down * Dkappa[i]);
+    }
+
+    // phase_term - storage_term
+    b[i] += ice_density * Lf * dice_dT[k] / deltat
+        - (dCs_dT[k] * (T_2[i] - T0[k]) + Cs_new[k]
+           + (Cs_new[k] - Cs[k]) + T_2[i] * dCs_dT[k]) / deltat;
+  }
+  a[0] = 0;
+  c[n - 1] = 0;
 }
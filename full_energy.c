@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include "vicNl.h"
 #include <math.h>
 
@@ -126,7 +127,6 @@ int  full_energy(char                 NEWCELL,
   VegConditions          displacement;
   VegConditions          roughness;
   VegConditions          ref_height;
-  VegConditions          *aero_resist;
   double                 Cv;
   double                 latent_heat_Le;
   double                 Melt[2*MAX_BANDS];
@@ -165,12 +165,14 @@ int  full_energy(char                 NEWCELL,
   double                 total_meltwater = 0; //mm
   double                 tmp_depth = 0, tmp_depth_prior = 0; //m
   double                 ppt[2]; 
-  const int              NUM_HRU = prcp->hruList.size();
-  double                 moist_prior[2][NUM_HRU][MAX_LAYERS]; //mm
-  double                 evap_prior[2][NUM_HRU][MAX_LAYERS]; //mm
 
-  /* Allocate aero_resist array */
-  aero_resist = new VegConditions [N_PET_TYPES + 1];
+  /* Scratch arrays are kept in the workspace of this thread, which is sized
+     for the largest cell, rather than allocated on every call */
+  EnergyWorkspace& workspace = EnergyWorkspace::current;
+  workspace.reserve(std::max(state->max_num_HRUs, (int)prcp->hruList.size()));
+  VegConditions* aero_resist = workspace.aero_resist;
+  for (int p = 0; p < N_PET_TYPES + 1; p++)
+    aero_resist[p] = VegConditions();
 
   /* set variables for distributed precipitation */
   if (state->options.DIST_PRCP)
@@ -198,11 +200,11 @@ int  full_energy(char                 NEWCELL,
 
   /* initialize prior moist and ice for subsidence calculations */
 #if EXCESS_ICE
-  for (std::vector<HRU>::iterator it = prcp->hruList.begin(); it != prcp->hruList.end(); ++it) {
-    for ( dist = 0; dist < Ndist; dist++ ) {
-      for(lidx=0;lidx<state->options.Nlayer;lidx++) {
-        moist_prior[dist][it->vegIndex][it->bandIndex][lidx] = it->cell[dist].layer[lidx].moist;
-        evap_prior[dist][it->vegIndex][it->bandIndex][lidx] = 0; //initialize
+  for (unsigned int hidx = 0; hidx < prcp->hruList.size(); hidx++) {
+    for (int dist = 0; dist < Ndist; dist++) {
+      for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
+        workspace.moist_prior(dist, hidx)[lidx] = prcp->hruList[hidx].cell[dist].layer[lidx].moist;
+        workspace.evap_prior(dist, hidx)[lidx] = 0; //initialize
       }
     }
   }
@@ -212,8 +214,9 @@ int  full_energy(char                 NEWCELL,
    Solve Energy and/or Water Balance for Each
    Vegetation Type
    **************************************************/
-  int hruIndex = 0;
-  for (std::vector<HRU>::iterator hru = prcp->hruList.begin(); hru != prcp->hruList.end(); ++hru, ++hruIndex) {
+  for (std::vector<int>::const_iterator active = prcp->activeHRUs.begin(); active != prcp->activeHRUs.end(); ++active) {
+    const int hruIndex = *active;
+    HRU* hru = &prcp->hruList[hruIndex];
 
     /** Solve Veg Type only if Coverage Greater than 0% **/
 
@@ -226,18 +229,18 @@ int  full_energy(char                 NEWCELL,
       if (hru->veg_con.LAKE) {
 
         /* Update areai to equal new ice area from previous time step. */
-        prcp->lake_var.areai = prcp->lake_var.new_ice_area;
+        prcp->lake_var->areai = prcp->lake_var->new_ice_area;
 
         /* Compute lake fraction and ice-covered fraction */
-        if (prcp->lake_var.areai < 0)
-          prcp->lake_var.areai = 0;
-        if (prcp->lake_var.sarea > 0) {
-          fraci = prcp->lake_var.areai / prcp->lake_var.sarea;
+        if (prcp->lake_var->areai < 0)
+          prcp->lake_var->areai = 0;
+        if (prcp->lake_var->sarea > 0) {
+          fraci = prcp->lake_var->areai / prcp->lake_var->sarea;
           if (fraci > 1.0)
             fraci = 1.0;
         } else
           fraci = 0.0;
-        lakefrac = prcp->lake_var.sarea / lake_con->basin[0];
+        lakefrac = prcp->lake_var->sarea / lake_con->basin[0];
 
         Nbands = 1;
         Cv *= (1 - lakefrac);
@@ -400,7 +403,7 @@ int  full_energy(char                 NEWCELL,
 
           ErrorFlag = surface_fluxes_glac(bare_albedo, height,
               ice0[hru->bandIndex], moist0[hru->bandIndex], SubsidenceUpdate,
-              evap_prior[DRY][hruIndex], evap_prior[WET][hruIndex], *hru,
+              workspace.evap_prior(DRY, hruIndex), workspace.evap_prior(WET, hruIndex), *hru,
               &(Melt[hru->bandIndex * 2]), &latent_heat_Le, aero_resist,
               displacement, gauge_correction, &out_prec[hru->bandIndex * 2],
               &out_rain[hru->bandIndex * 2], &out_snow[hru->bandIndex * 2],
@@ -411,7 +414,7 @@ int  full_energy(char                 NEWCELL,
         } else {              // Otherwise, run the model calculations as normal.
           ErrorFlag = surface_fluxes(overstory, bare_albedo, height,
               ice0[hru->bandIndex], moist0[hru->bandIndex], SubsidenceUpdate,
-              evap_prior[DRY][hruIndex], evap_prior[WET][hruIndex], *hru,
+              workspace.evap_prior(DRY, hruIndex), workspace.evap_prior(WET, hruIndex), *hru,
               surf_atten, &(Melt[hru->bandIndex * 2]), &latent_heat_Le,
               aero_resist, displacement, gauge_correction,
               &out_prec[hru->bandIndex * 2], &out_rain[hru->bandIndex * 2],
@@ -495,8 +498,6 @@ int  full_energy(char                 NEWCELL,
     } /** end current vegetation type **/
   } /** end of vegetation loop **/
 
-  delete [] aero_resist;
-
   /****************************
    Calculate Subsidence
    ****************************/
@@ -716,8 +717,9 @@ int  full_energy(char                 NEWCELL,
     wetland_runoff = wetland_baseflow = 0;
     sum_runoff = sum_baseflow = 0;
 
-    // Loop through all vegetation tiles (HRUs)
-    for (std::vector<HRU>::iterator it = prcp->hruList.begin(); it != prcp->hruList.end(); ++it) {
+    // Loop through the vegetation tiles (HRUs) that were solved
+    for (std::vector<int>::const_iterator active = prcp->activeHRUs.begin(); active != prcp->activeHRUs.end(); ++active) {
+      HRU* it = &prcp->hruList[*active];
 
       /** Solve Veg Tile only if Coverage Greater than 0% **/
     	if ((it->veg_con.Cv > 0.) || (it->isGlacier && state->options.GLACIER_DYNAMICS && it->veg_con.Cv >= 0.)) {
@@ -760,12 +762,12 @@ int  full_energy(char                 NEWCELL,
     }
 
     /** Run lake model **/
-    prcp->lake_var.runoff_in = (sum_runoff * lake_con->rpercent + wetland_runoff)
+    prcp->lake_var->runoff_in = (sum_runoff * lake_con->rpercent + wetland_runoff)
         * soil_con->cell_area * 0.001; // m3
-    prcp->lake_var.baseflow_in = (sum_baseflow * lake_con->rpercent
+    prcp->lake_var->baseflow_in = (sum_baseflow * lake_con->rpercent
         + wetland_baseflow) * soil_con->cell_area * 0.001; // m3
-    prcp->lake_var.channel_in = atmos->channel_in[state->NR] * soil_con->cell_area * 0.001; // m3
-    prcp->lake_var.prec = atmos->prec[state->NR] * prcp->lake_var.sarea * 0.001; // m3
+    prcp->lake_var->channel_in = atmos->channel_in[state->NR] * soil_con->cell_area * 0.001; // m3
+    prcp->lake_var->prec = atmos->prec[state->NR] * prcp->lake_var->sarea * 0.001; // m3
     rainonly = calc_rainonly(atmos->air_temp[state->NR], atmos->prec[state->NR], soil_con->MAX_SNOW_TEMP, soil_con->MIN_RAIN_TEMP, 1, state);
     if ((int) rainonly == ERROR) {
       return (ERROR);
@@ -775,7 +777,7 @@ int  full_energy(char                 NEWCELL,
        Solve the energy budget for the lake.
      **********************************************************************/
 
-    oldsnow = prcp->lake_var.snow.swq;
+    oldsnow = prcp->lake_var->snow.swq;
     snowprec = gauge_correction[SNOW] * (atmos->prec[state->NR] - rainonly) * soil_con->PADJ_S;
     rainprec = gauge_correction[RAIN] * rainonly * soil_con->PADJ_R;
     atmos->out_prec += (snowprec + rainprec) * lake_con->Cl[0] * lakefrac;
@@ -783,7 +785,7 @@ int  full_energy(char                 NEWCELL,
     ErrorFlag = solve_lake(snowprec, rainprec, atmos->air_temp[state->NR],
         atmos->wind[state->NR], atmos->vp[state->NR] / 1000., atmos->shortwave[state->NR],
         atmos->longwave[state->NR], atmos->vpd[state->NR] / 1000.,
-        atmos->pressure[state->NR] / 1000., atmos->density[state->NR], &(prcp->lake_var), *lake_con,
+        atmos->pressure[state->NR] / 1000., atmos->density[state->NR], prcp->lake_var, *lake_con,
         soil_con, state->global_param.dt, time_step_record, state->global_param.wind_h, dmy[time_step_record], fraci, state);
     if (ErrorFlag == ERROR)
       return (ERROR);
@@ -792,7 +794,7 @@ int  full_energy(char                 NEWCELL,
        Solve the water budget for the lake.
      **********************************************************************/
     for (std::vector<HRU>::iterator hru = prcp->hruList.begin(); hru != prcp->hruList.end(); ++hru) {
-      ErrorFlag = water_balance(&(prcp->lake_var), *lake_con,
+      ErrorFlag = water_balance(prcp->lake_var, *lake_con,
           state->global_param.dt, prcp, time_step_record,
           *hru, lakefrac, *soil_con,
           SubsidenceUpdate, total_meltwater, state);
@@ -821,32 +823,32 @@ int  full_energy(char                 NEWCELL,
 
       // print lake variables
       fprintf(state->debug.fg_lake, "%i/%i/%i %i:00:00,%i", dmy[time_step_record].month, dmy[time_step_record].day, dmy[time_step_record].year, dmy[time_step_record].hour, time_step_record);
-      fprintf(state->debug.fg_lake, ",%i", prcp->lake_var.activenod);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.ldepth);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.sarea);
+      fprintf(state->debug.fg_lake, ",%i", prcp->lake_var->activenod);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->ldepth);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->sarea);
       for (int i = 0; i < MAX_LAKE_NODES; i++ )
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.surface[i]);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.volume);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.baseflow_in);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.baseflow_out);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.channel_in);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.evapw);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.prec);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.recharge);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.runoff_in);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.runoff_out);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.snowmlt);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.vapor_flux);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->surface[i]);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->volume);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->baseflow_in);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->baseflow_out);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->channel_in);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->evapw);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->prec);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->recharge);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->runoff_in);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->runoff_out);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->snowmlt);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->vapor_flux);
       for (int i = 0; i < MAX_LAKE_NODES; i++ )
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.temp[i]);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->temp[i]);
       for (int i = 0; i < MAX_LAKE_NODES; i++ )
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.density[i]);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.areai);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.hice);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.sdepth);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.swe);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.tempi);
-      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var.aero_resist);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->density[i]);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->areai);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->hice);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->sdepth);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->swe);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->tempi);
+      fprintf(state->debug.fg_lake, ",%f", prcp->lake_var->aero_resist);
 
       for (std::vector<HRU>::iterator hru = prcp->hruList.begin(); hru != prcp->hruList.end(); ++hru) {
         if (hru->veg_con.LAKE) {
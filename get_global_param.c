@@ -284,6 +284,9 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
   global_param.out_dt        = INVALID_INT;
   global_param.num_threads        = 1;
   global_param.disagg_write_chunk_size = 1;
+  global_param.forcing_window = 0;
+  global_param.output_queue_depth = 1;
+  global_param.time_block = 1;
 
   // Open the file
   FILE* gp = open_file(global_file_name, "r");
@@ -308,6 +311,15 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
       if(strcasecmp("DISAGG_WRITE_CHUNK_SIZE",optstr)==0) {
         sscanf(cmdstr,"%*s %d",&global_param.disagg_write_chunk_size);
       }
+      else if(strcasecmp("FORCING_WINDOW",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&global_param.forcing_window);
+      }
+      else if(strcasecmp("OUTPUT_QUEUE_DEPTH",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&global_param.output_queue_depth);
+      }
+      else if(strcasecmp("TIME_BLOCK",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&global_param.time_block);
+      }
       else if(strcasecmp("PARALLEL_THREADS",optstr)==0) {
         sscanf(cmdstr,"%*s %d",&global_param.num_threads);
       }
@@ -386,6 +398,11 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
         if(strcasecmp("TRUE",flgstr)==0) options.QUICK_FLUX=TRUE;
         else options.QUICK_FLUX = FALSE;
       }
+      else if(strcasecmp("QUICK_FS",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.QUICK_FS=TRUE;
+        else options.QUICK_FS = FALSE;
+      }
       else if(strcasecmp("QUICK_SOLVE",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.QUICK_SOLVE=TRUE;
@@ -507,6 +524,11 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
         if(strcasecmp("TRUE",flgstr)==0) options.TFALLBACK=TRUE;
         else options.TFALLBACK = FALSE;
       }
+      else if(strcasecmp("WARM_START",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.WARM_START=TRUE;
+        else options.WARM_START = FALSE;
+      }
       else if(strcasecmp("VP_INTERP",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.VP_INTERP=TRUE;
@@ -1171,7 +1193,7 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
       nrerror(ErrStr);
     }
     if(options.IMPLICIT)  {
-      if ( QUICK_FS ) 
+      if ( options.QUICK_FS )
         fprintf(stderr,"WARNING: IMPLICIT and QUICK_FS are both TRUE.\n\tThe QUICK_FS option is ignored when IMPLICIT=TRUE\n");
     }
     if( EXCESS_ICE ) {
@@ -1183,7 +1205,7 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
         fprintf(stderr,"WARNING: QUICK_SOLVE and EXCESS_ICE are both TRUE.\n\tThis is an incompatible combination.  Setting QUICK_SOLVE to FALSE.\n");
         options.QUICK_SOLVE=FALSE;  
       }    
-      if ( QUICK_FS ) 
+      if ( options.QUICK_FS )
         nrerror("QUICK_FS = TRUE and EXCESS_ICE = TRUE are incompatible options.");
     }
     if(options.Nlayer > MAX_LAYERS) {
@@ -1217,6 +1239,22 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
       }
     }
 
+    // Validate the forcing window
+    if (global_param.forcing_window < 0) {
+      nrerror("FORCING_WINDOW must be 0 (keep the forcings of the whole simulation in memory) or a positive number of days.");
+    }
+    if (global_param.forcing_window > 0 && options.COMPUTE_TREELINE && !options.JULY_TAVG_SUPPLIED) {
+      nrerror("COMPUTE_TREELINE = TRUE requires JULY_TAVG_SUPPLIED = TRUE when FORCING_WINDOW is used, since the average July air temperature cannot be computed from a window of the forcings.");
+    }
+
+    if (global_param.output_queue_depth < 0) {
+      nrerror("OUTPUT_QUEUE_DEPTH must be 0 (write the output without a separate writer thread) or a positive number of output buffers.");
+    }
+
+    if (global_param.time_block < 0) {
+      nrerror("TIME_BLOCK must be 0 (advance each cell by an output interval at a time) or a positive number of time steps.");
+    }
+
     //validate and set Noutfiles based on set options
     options.Noutfiles = 2;  // This is the default for the OUTPUT_FORCE=FALSE case
     if (options.FROZEN_SOIL) {
@@ -1267,7 +1305,7 @@ void ProgramState::init_global_param(filenames_struct *names, const char* global
       fprintf(stderr,".... Thermal nodes are linearly distributed with depth (except top two nodes).\n");
     if( EXCESS_ICE )
       fprintf(stderr,".... Excess ground ice is being considered.\n\t\tTherefore, ground ice (as a volumetric fraction) must be initialized for each\n\t\t   soil layer in the soil file.\n\t\tCAUTION: When excess ice melts, subsidence occurs.\n\t\t  Therefore, soil layer depths, damping depth, thermal node depths,\n\t\t     bulk densities, porosities, and other properties are now dynamic!\n\t\t  EXERCISE EXTREME CAUTION IN INTERPRETING MODEL OUTPUT.\n\t\t  It is recommended to add OUT_SOIL_DEPTH to your list of output variables.\n");
-    if ( QUICK_FS ){
+    if ( options.QUICK_FS ){
       fprintf(stderr,".... Using linearized UFWC curve with %d temperatures.\n", QUICK_FS_TEMPS);
     }
     fprintf(stderr,"Run Snow Model Using a Time Step of %d hours\n", 
@@ -157,9 +157,10 @@ int glacier_melt(double Le,
         &sensible_heat,
         &glacier->vapor_flux);
 
-    glacier->surf_temp = glacierIterative.root_brent(
+    glacier->surf_temp = glacierIterative.solve(glacier->surf_temp,
         (double) (glacier->surf_temp - SNOW_DT),
-        (double) (glacier->surf_temp + SNOW_DT), ErrorString);
+        (double) (glacier->surf_temp + SNOW_DT), ErrorString,
+        state->options.WARM_START);
 
     if (glacierIterative.resultIsError(glacier->surf_temp)) {
       if (state->options.TFALLBACK) {
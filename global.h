@@ -23,10 +23,6 @@
 #ifndef GLOBAL_H
 #define GLOBAL_H
 
-#if QUICK_FS
-const double temps[] = { -1.e-5, -0.075, -0.20, -0.50, -1.00, -2.50, -5, -10 };
-#endif
-
   /**************************************************************************
     Define some reference landcover types that always exist regardless
     of the contents of the library (mainly for potential evap calculations):
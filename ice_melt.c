@@ -423,9 +423,10 @@ int ice_melt(double            z2,
           snow->swq * RHO_W / RHOSNOW, RHOSNOW, surf_atten, &SnowFlux,
           &latent_heat, &latent_heat_sub, &sensible_heat, &LWnet);
 
-      snow->surf_temp = iceEnergyBalanceIteration.root_brent(
+      snow->surf_temp = iceEnergyBalanceIteration.solve(snow->surf_temp,
           (double) (snow->surf_temp - SNOW_DT),
-          (double) (snow->surf_temp + SNOW_DT), ErrorString);
+          (double) (snow->surf_temp + SNOW_DT), ErrorString,
+          state->options.WARM_START);
 
 
       if (iceEnergyBalanceIteration.resultIsError(snow->surf_temp)) {
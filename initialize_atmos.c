@@ -7,8 +7,9 @@ static char vcid[] = "$Id$";
 void initialize_atmos(atmos_data_struct        *atmos,
                       const dmy_struct         *dmy,
                       FILE                    **infile,
-                      int                      *ncids,
+                      NetCDFForcingReader     **forcing_readers,
                       soil_con_struct          *soil_con,
+                      const global_param_struct *global_param,
                       const ProgramState       *state)
 
 /**********************************************************************
@@ -21,6 +22,10 @@ void initialize_atmos(atmos_data_struct        *atmos,
   routine for reference), and radiation is estimated using Bras's algorithms
   (see routines for reference).
 
+  The forcings are prepared for the period given by global_param, which is
+  either the whole simulation or a window of it (see FORCING_WINDOW); dmy
+  and atmos start at the first record of that period.
+
   WARNING: This subroutine is site specific.  Location parameters
     must be changed before compilation.
 
@@ -144,21 +149,21 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
   /* compute number of simulation days */
   int tmp_starthour = 0;
-  int tmp_endhour = 24 - state->global_param.dt;
-  int tmp_nrecs = state->global_param.nrecs+state->global_param.starthour-tmp_starthour+tmp_endhour-dmy[state->global_param.nrecs-1].hour;
-  Ndays = (tmp_nrecs * state->global_param.dt) / 24;
+  int tmp_endhour = 24 - global_param->dt;
+  int tmp_nrecs = global_param->nrecs+global_param->starthour-tmp_starthour+tmp_endhour-dmy[global_param->nrecs-1].hour;
+  Ndays = (tmp_nrecs * global_param->dt) / 24;
 
   /* compute number of full model time steps per day */
-  stepspday = 24/state->global_param.dt;
+  stepspday = 24/global_param->dt;
  
   /* Compute number of days for MTCLIM (in local time); for sub-daily, we must pad start and end with dummy records */
   Ndays_local = Ndays;
   if (hour_offset_int != 0) Ndays_local = Ndays + 1;
 
-  local_starthour = state->global_param.starthour - hour_offset_int;
-  local_startday = state->global_param.startday;
-  local_startmonth = state->global_param.startmonth;
-  local_startyear = state->global_param.startyear;
+  local_starthour = global_param->starthour - hour_offset_int;
+  local_startday = global_param->startday;
+  local_startmonth = global_param->startmonth;
+  local_startyear = global_param->startyear;
   if (local_starthour < 0) {
     local_starthour += 24;
     local_startday--;
@@ -244,7 +249,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
     read in meteorological data 
   *******************************/
 
-  forcing_data = read_forcing_data(infile, ncids, state->global_param, soil_con, state);
+  forcing_data = read_forcing_data(infile, forcing_readers, *global_param, soil_con, state);
   
   fprintf(stderr,"Finished reading meteorological forcing file\n");
 
@@ -268,8 +273,8 @@ void initialize_atmos(atmos_data_struct        *atmos,
             || type == LSSNOWF
             || type == CHANNEL_IN
            ) {
-          for (int idx=0; idx<(state->global_param.nrecs * state->NF); idx++) {
-            forcing_data[type][idx] *= state->global_param.dt * 3600;
+          for (int idx=0; idx<(global_param->nrecs * state->NF); idx++) {
+            forcing_data[type][idx] *= global_param->dt * 3600;
           }
         }
         /* Convert temperatures from K to C */
@@ -277,7 +282,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
                  || type == TMIN
                  || type == TMAX
                 ) {
-          for (int idx=0; idx<(state->global_param.nrecs*state->NF); idx++) {
+          for (int idx=0; idx<(global_param->nrecs*state->NF); idx++) {
             forcing_data[type][idx] -= KELVIN;
           }
         }
@@ -291,7 +296,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
         if (   type == PRESSURE
             || type == VP
            ) {
-          for (int idx=0; idx<(state->global_param.nrecs*state->NF); idx++) {
+          for (int idx=0; idx<(global_param->nrecs*state->NF); idx++) {
             forcing_data[type][idx] *= kPa2Pa;
           }
         }
@@ -308,9 +313,9 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if(state->param_set.TYPE[RAINF].SUPPLIED && state->param_set.TYPE[SNOWF].SUPPLIED) {
     /* rainfall and snowfall supplied */
     if (forcing_data[PREC] == NULL) {
-      forcing_data[PREC] = (double *)calloc((state->global_param.nrecs * state->NF),sizeof(double));
+      forcing_data[PREC] = (double *)calloc((global_param->nrecs * state->NF),sizeof(double));
     }
-    for (int idx=0; idx<(state->global_param.nrecs*state->NF); idx++) {
+    for (int idx=0; idx<(global_param->nrecs*state->NF); idx++) {
       forcing_data[PREC][idx] = forcing_data[RAINF][idx] + forcing_data[SNOWF][idx];
     }
   }
@@ -318,9 +323,9 @@ void initialize_atmos(atmos_data_struct        *atmos,
     && state->param_set.TYPE[CSNOWF].SUPPLIED && state->param_set.TYPE[LSSNOWF].SUPPLIED) {
     /* convective and large-scale rainfall and snowfall supplied */
     if (forcing_data[PREC] == NULL) {
-      forcing_data[PREC] = (double *)calloc((state->global_param.nrecs * state->NF),sizeof(double));
+      forcing_data[PREC] = (double *)calloc((global_param->nrecs * state->NF),sizeof(double));
     }
-    for (int idx=0; idx<(state->global_param.nrecs*state->NF); idx++) {
+    for (int idx=0; idx<(global_param->nrecs*state->NF); idx++) {
       forcing_data[PREC][idx] = forcing_data[CRAINF][idx] + forcing_data[LSRAINF][idx]
                                + forcing_data[CSNOWF][idx] + forcing_data[LSSNOWF][idx];
     }
@@ -334,9 +339,9 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if(state->param_set.TYPE[WIND_E].SUPPLIED && state->param_set.TYPE[WIND_N].SUPPLIED) {
     /* specific wind_e and wind_n supplied */
     if (forcing_data[WIND] == NULL) {
-      forcing_data[WIND] = (double *)calloc((state->global_param.nrecs * state->NF),sizeof(double));
+      forcing_data[WIND] = (double *)calloc((global_param->nrecs * state->NF),sizeof(double));
     }
-    for (int idx=0; idx<(state->global_param.nrecs*state->NF); idx++) {
+    for (int idx=0; idx<(global_param->nrecs*state->NF); idx++) {
       forcing_data[WIND][idx] = sqrt( forcing_data[WIND_E][idx]*forcing_data[WIND_E][idx]
                                     + forcing_data[WIND_N][idx]*forcing_data[WIND_N][idx] );
     }
@@ -369,7 +374,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
         // Sub-daily forcings need to a) start at hour 0, local time and b) draw from the correct element of the supplied forcings (if the supplied forcings are not in local time)
         int fstepspday = 24/state->param_set.FORCE_DT[state->param_set.TYPE[type].SUPPLIED-1];
         for (int idx=0; idx<(Ndays_local*24); idx++) {
-          int i = (idx - state->global_param.starthour + hour_offset_int)/state->param_set.FORCE_DT[state->param_set.TYPE[type].SUPPLIED-1];
+          int i = (idx - global_param->starthour + hour_offset_int)/state->param_set.FORCE_DT[state->param_set.TYPE[type].SUPPLIED-1];
           if (i < 0) i += fstepspday;
           if (i >= (Ndays*fstepspday)) i -= fstepspday;
           if (   type == PREC
@@ -400,11 +405,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if(state->param_set.TYPE[CHANNEL_IN].SUPPLIED) {
     if(state->param_set.FORCE_DT[state->param_set.TYPE[CHANNEL_IN].SUPPLIED-1] == 24) {
       /* daily channel_in provided */
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for (int j = 0; j < state->NF; j++) {
-          int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           int idx = (int)((float)hour/24.0);
           atmos[rec].channel_in[j] = local_forcing_data[CHANNEL_IN][idx] / (float)(state->NF*stepspday); // divide evenly over the day
           atmos[rec].channel_in[j] *= 1000/soil_con->cell_area; // convert to mm over grid cell
@@ -415,12 +420,12 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
     else {
       /* sub-daily channel_in provided */
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
           atmos[rec].channel_in[i] = 0;
-          while (hour < rec*state->global_param.dt + (i+1)*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int) {
+          while (hour < rec*global_param->dt + (i+1)*state->options.SNOW_STEP + global_param->starthour - hour_offset_int) {
             int idx = hour;
             if (idx < 0) idx += 24;
 	    atmos[rec].channel_in[i] += local_forcing_data[CHANNEL_IN][idx];
@@ -434,7 +439,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
   }
   else {
-    for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for(int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for(int i = 0; i < state->NF; i++) {
         atmos[rec].channel_in[i] = 0;
@@ -450,11 +455,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
   if(state->param_set.FORCE_DT[state->param_set.TYPE[PREC].SUPPLIED-1] == 24) {
     /* daily precipitation provided */
-    for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for (int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for (int j = 0; j < state->NF; j++) {
-        int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-        if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+        int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+        if (global_param->starthour - hour_offset_int < 0) hour += 24;
         int idx = (int)((float)hour/24.0);
         atmos[rec].prec[j] = local_forcing_data[PREC][idx] / (float)(state->NF*stepspday); // divide evenly over the day
         sum += atmos[rec].prec[j];
@@ -467,11 +472,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
   }
   else {
     /* sub-daily precipitation provided */
-    for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for(int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for(int i = 0; i < state->NF; i++) {
-        int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-        if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+        int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+        if (global_param->starthour - hour_offset_int < 0) hour += 24;
         atmos[rec].prec[i] = 0;
         for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	  atmos[rec].prec[i] += local_forcing_data[PREC][idx];
@@ -495,13 +500,13 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if (state->param_set.TYPE[WIND].SUPPLIED) {
     if (state->param_set.FORCE_DT[state->param_set.TYPE[WIND].SUPPLIED - 1] == 24) {
       /* daily wind provided */
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         int j = 0;
         for (j = 0; j < state->NF; j++) {
-          int hour = rec * state->global_param.dt + j * state->options.SNOW_STEP
-              + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0)
+          int hour = rec * global_param->dt + j * state->options.SNOW_STEP
+              + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0)
             hour += 24;
           int idx = (int) ((float) hour / 24.0);
           atmos[rec].wind[j] = local_forcing_data[WIND][idx]; // assume constant over the day
@@ -509,7 +514,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
         }
         if (state->NF > 1)
           atmos[rec].wind[state->NR] = sum / (float) state->NF;
-        if (state->global_param.dt == 24) {
+        if (global_param->dt == 24) {
           if (atmos[rec].wind[j] < state->options.MIN_WIND_SPEED)
             atmos[rec].wind[j] = state->options.MIN_WIND_SPEED;
         }
@@ -517,11 +522,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
     else {
       /* sub-daily wind provided */
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           atmos[rec].wind[i] = 0;
           for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	    if(local_forcing_data[WIND][idx] < state->options.MIN_WIND_SPEED)
@@ -538,7 +543,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
   }
   else {
     /* no wind data provided, use default constant */
-    for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for (int rec = 0; rec < global_param->nrecs; rec++) {
       for (int i = 0; i < state->NF; i++) {
         atmos[rec].wind[i] = 1.5;
       }
@@ -593,11 +598,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
   *************************************************/
 
   if(state->param_set.TYPE[AIR_TEMP].SUPPLIED) {
-    for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for(int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for(int i = 0; i < state->NF; i++) {
-        int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-        if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+        int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+        if (global_param->starthour - hour_offset_int < 0) hour += 24;
         atmos[rec].air_temp[i] = 0;
         for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	  atmos[rec].air_temp[i] += local_forcing_data[AIR_TEMP][idx];
@@ -639,11 +644,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
       for (int day=0; day<Ndays_local; day++) {
         daily_vp[day] = local_forcing_data[VP][day];
       }
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for (int j = 0; j < state->NF; j++) {
-          int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           int idx = (int)((float)hour/24.0);
           atmos[rec].vp[j] = local_forcing_data[VP][idx]; // assume constant over the day
           sum += atmos[rec].vp[j];
@@ -660,11 +665,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
         }
         daily_vp[day] /= 24;
       }
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           atmos[rec].vp[i] = 0;
           for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	    atmos[rec].vp[i] += local_forcing_data[VP][idx];
@@ -803,11 +808,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     c) completely estimated by MTCLIM, if no shortwave was supplied as a forcing
   ***********************************************************/
 
-  for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+  for(int rec = 0; rec < global_param->nrecs; rec++) {
     sum = 0;
     for(int i = 0; i < state->NF; i++) {
-      int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-      if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+      int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+      if (global_param->starthour - hour_offset_int < 0) hour += 24;
       atmos[rec].shortwave[i] = 0;
       for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	atmos[rec].shortwave[i] += hourlyrad[idx];
@@ -835,11 +840,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
       Calculate the subdaily and daily temperature based on tmax and tmin 
     **********************************************************************/
     HourlyT(1, Ndays_local, tmaxhour, tmax, tminhour, tmin, tair);
-    for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for(int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for(int i = 0; i < state->NF; i++) {
-        int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-        if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+        int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+        if (global_param->starthour - hour_offset_int < 0) hour += 24;
         atmos[rec].air_temp[i] = 0;
         for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	  atmos[rec].air_temp[i] += tair[idx];
@@ -864,11 +869,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if (state->param_set.TYPE[DENSITY].SUPPLIED) {
     if(state->param_set.FORCE_DT[state->param_set.TYPE[DENSITY].SUPPLIED-1] == 24) {
       /* daily density provided */
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for (int j = 0; j < state->NF; j++) {
-          int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           int idx = (int)((float)hour/24.0);
           atmos[rec].density[j] = local_forcing_data[DENSITY][idx]; // assume constant over the day
           sum += atmos[rec].density[j];
@@ -878,11 +883,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
     else {
       /* sub-daily density provided */
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           atmos[rec].density[i] = 0;
           for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	    atmos[rec].density[i] += local_forcing_data[DENSITY][idx];
@@ -905,7 +910,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
       if (state->options.PLAPSE) {
         /* Assume average virtual temperature in air column
            between ground and sea level = KELVIN+atmos[rec].air_temp[NR] + 0.5*elevation*LAPSE_PM */
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
           atmos[rec].pressure[state->NR] = PS_PM*exp(-soil_con->elevation*G/(Rd*(KELVIN+atmos[rec].air_temp[state->NR]+0.5*soil_con->elevation*LAPSE_PM)));
           for (int i = 0; i < state->NF; i++) {
             atmos[rec].pressure[i] = PS_PM*exp(-soil_con->elevation*G/(Rd*(KELVIN+atmos[rec].air_temp[i]+0.5*soil_con->elevation*LAPSE_PM)));
@@ -914,7 +919,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
       }
       else {
         /* set pressure to constant value */
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
 	  atmos[rec].pressure[state->NR] = 95500.;
 	  for (int i = 0; i < state->NF; i++) {
 	    atmos[rec].pressure[i] = atmos[rec].pressure[state->NR];
@@ -925,7 +930,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
     else {
       /* use observed densities to estimate pressure */
       if (state->options.PLAPSE) {
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
           atmos[rec].pressure[state->NR] = (KELVIN+atmos[rec].air_temp[state->NR])*atmos[rec].density[state->NR]*Rd;
           for (int i = 0; i < state->NF; i++) {
             atmos[rec].pressure[i] = (KELVIN+atmos[rec].air_temp[i])*atmos[rec].density[i]*Rd;
@@ -933,7 +938,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
         }
       }
       else {
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
 	  atmos[rec].pressure[state->NR] = (275.0 + atmos[rec].air_temp[state->NR]) *atmos[rec].density[state->NR]/0.003486;
 	  for (int i = 0; i < state->NF; i++) {
 	    atmos[rec].pressure[i] = (275.0 + atmos[rec].air_temp[i]) *atmos[rec].density[i]/0.003486;
@@ -946,11 +951,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     /* observed atmospheric pressure supplied */
     if(state->param_set.FORCE_DT[state->param_set.TYPE[PRESSURE].SUPPLIED-1] == 24) {
       /* daily pressure provided */
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for (int j = 0; j < state->NF; j++) {
-          int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           int idx = (int)((float)hour/24.0);
           atmos[rec].pressure[j] = local_forcing_data[PRESSURE][idx]; // assume constant over the day
           sum += atmos[rec].pressure[j];
@@ -960,11 +965,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
     else {
       /* sub-daily pressure provided */
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           atmos[rec].pressure[i] = 0;
           for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	    atmos[rec].pressure[i] += local_forcing_data[PRESSURE][idx];
@@ -984,7 +989,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
   if(!state->param_set.TYPE[DENSITY].SUPPLIED) {
     /* use pressure to estimate density */
     if (state->options.PLAPSE) {
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         atmos[rec].density[state->NR] = atmos[rec].pressure[state->NR]/(Rd*(KELVIN+atmos[rec].air_temp[state->NR]));
         for (int i = 0; i < state->NF; i++) {
           atmos[rec].density[i] = atmos[rec].pressure[i]/(Rd*(KELVIN+atmos[rec].air_temp[i]));
@@ -992,7 +997,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
       }
     }
     else {
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         atmos[rec].density[state->NR] = 0.003486*atmos[rec].pressure[state->NR]/ (275.0 + atmos[rec].air_temp[state->NR]);
         for (int i = 0; i < state->NF; i++) {
 	  atmos[rec].density[i] = 0.003486*atmos[rec].pressure[i]/ (275.0 + atmos[rec].air_temp[i]);
@@ -1017,11 +1022,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
       if(state->param_set.FORCE_DT[state->param_set.TYPE[QAIR].SUPPLIED-1] == 24) {
         /* daily specific humidity provided */
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
           sum = 0;
           for (int j = 0; j < state->NF; j++) {
-            int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-            if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+            int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+            if (global_param->starthour - hour_offset_int < 0) hour += 24;
             int idx = (int)((float)hour/24.0);
             atmos[rec].vp[j] = local_forcing_data[QAIR][idx] * atmos[rec].pressure[j] / EPS;
             sum += atmos[rec].vp[j];
@@ -1031,11 +1036,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
       }
       else {
         /* sub-daily specific humidity provided */
-        for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for(int rec = 0; rec < global_param->nrecs; rec++) {
           sum = 0;
           for(int i = 0; i < state->NF; i++) {
-            int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-            if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+            int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+            if (global_param->starthour - hour_offset_int < 0) hour += 24;
             atmos[rec].vp[i] = 0;
             for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	      atmos[rec].vp[i] += local_forcing_data[QAIR][idx] * atmos[rec].pressure[i] / EPS;
@@ -1058,11 +1063,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
       if(state->param_set.FORCE_DT[state->param_set.TYPE[REL_HUMID].SUPPLIED-1] == 24) {
         /* daily specific humidity provided */
-        for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for (int rec = 0; rec < global_param->nrecs; rec++) {
           sum = 0;
           for (int j = 0; j < state->NF; j++) {
-            int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-            if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+            int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+            if (global_param->starthour - hour_offset_int < 0) hour += 24;
             int idx = (int)((float)hour/24.0);
             atmos[rec].vp[j] = local_forcing_data[REL_HUMID][idx] * svp(atmos[rec].air_temp[j]) / 100;
             sum += atmos[rec].vp[j];
@@ -1072,11 +1077,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
       }
       else {
         /* sub-daily specific humidity provided */
-        for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+        for(int rec = 0; rec < global_param->nrecs; rec++) {
           sum = 0;
           for(int i = 0; i < state->NF; i++) {
-            int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-            if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+            int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+            if (global_param->starthour - hour_offset_int < 0) hour += 24;
             atmos[rec].vp[i] = 0;
             for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	      atmos[rec].vp[i] += local_forcing_data[REL_HUMID][idx] * svp(atmos[rec].air_temp[i]) / 100;
@@ -1151,11 +1156,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
 
     /* Transfer sub-daily VP to atmos array */
-    for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for(int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for(int i = 0; i < state->NF; i++) {
-        int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-        if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+        int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+        if (global_param->starthour - hour_offset_int < 0) hour += 24;
         atmos[rec].vp[i] = 0;
         for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	  atmos[rec].vp[i] += local_forcing_data[VP][idx];
@@ -1172,7 +1177,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
     Vapor Pressure Deficit
   *************************************************/
 
-  for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+  for(int rec = 0; rec < global_param->nrecs; rec++) {
     sum = 0;
     sum2 = 0;
     for(int i = 0; i < state->NF; i++) {
@@ -1197,11 +1202,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     Cloud Transmissivity (from MTCLIM)
   *************************************************/
 
-  for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+  for (int rec = 0; rec < global_param->nrecs; rec++) {
     sum = 0;
     for (int j = 0; j < state->NF; j++) {
-      int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-      if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+      int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+      if (global_param->starthour - hour_offset_int < 0) hour += 24;
       int idx = (int)((float)hour/24.0);
       atmos[rec].tskc[j] = tskc[idx]; // assume constant over the day
       sum += atmos[rec].tskc[j];
@@ -1223,7 +1228,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
   if ( !state->param_set.TYPE[LONGWAVE].SUPPLIED ) {
     /** Incoming longwave radiation not supplied **/
-    for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for (int rec = 0; rec < global_param->nrecs; rec++) {
       sum = 0;
       for (int i = 0; i < state->NF; i++) {
 	calc_longwave(&(atmos[rec].longwave[i]), atmos[rec].tskc[i],
@@ -1236,11 +1241,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
   else {
     if(state->param_set.FORCE_DT[state->param_set.TYPE[LONGWAVE].SUPPLIED-1] == 24) {
       /* daily incoming longwave radiation provided */
-      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for (int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for (int j = 0; j < state->NF; j++) {
-          int hour = rec*state->global_param.dt + j*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + j*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           int idx = (int)((float)hour/24.0);
           atmos[rec].longwave[j] = local_forcing_data[LONGWAVE][idx]; // assume constant over the day
           sum += atmos[rec].longwave[j];
@@ -1250,11 +1255,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     }
     else {
       /* sub-daily incoming longwave radiation provided */
-      for(int rec = 0; rec < state->global_param.nrecs; rec++) {
+      for(int rec = 0; rec < global_param->nrecs; rec++) {
         sum = 0;
         for(int i = 0; i < state->NF; i++) {
-          int hour = rec*state->global_param.dt + i*state->options.SNOW_STEP + state->global_param.starthour - hour_offset_int;
-          if (state->global_param.starthour - hour_offset_int < 0) hour += 24;
+          int hour = rec*global_param->dt + i*state->options.SNOW_STEP + global_param->starthour - hour_offset_int;
+          if (global_param->starthour - hour_offset_int < 0) hour += 24;
           atmos[rec].longwave[i] = 0;
           for (int idx = hour; idx < hour+state->options.SNOW_STEP; idx++) {
 	    atmos[rec].longwave[i] += local_forcing_data[LONGWAVE][idx];
@@ -1277,7 +1282,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
       if (soil_con->Tfactor[band] < min_Tfactor)
         min_Tfactor = soil_con->Tfactor[band];
     }
-    for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+    for (int rec = 0; rec < global_param->nrecs; rec++) {
       atmos[rec].snowflag[state->NR] = FALSE;
       for (int i = 0; i < state->NF; i++) {
     	if(state->options.TEMP_TH_TYPE == VIC_412){
@@ -1330,7 +1335,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
 
 #if OUTPUT_FORCE_STATS
 #error // OUTPUT_FORCE_STATS is an untested code path. Continue at your own risk!
-  calc_forcing_stats(state->global_param.nrecs, atmos, state->NR);
+  calc_forcing_stats(global_param->nrecs, atmos, state->NR);
 #endif // OUTPUT_FORCE_STATS
 
   if (!state->options.OUTPUT_FORCE) {
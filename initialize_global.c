@@ -150,6 +150,7 @@ void ProgramState::initialize_global() {
   options.PLAPSE                = TRUE;
   options.PREC_EXPT             = 0.6;
   options.QUICK_FLUX            = TRUE;
+  options.QUICK_FS              = FALSE;
   options.QUICK_SOLVE           = FALSE;
   options.ROOT_ZONES            = INVALID_INT;
   options.SNOW_ALBEDO           = USACE;
@@ -158,6 +159,7 @@ void ProgramState::initialize_global() {
   options.SNOW_STEP             = 1;
   options.SW_PREC_THRESH        = 0;
   options.TFALLBACK             = TRUE;
+  options.WARM_START            = FALSE;
   options.VP_INTERP             = TRUE;
   options.VP_ITER               = VP_ITER_ALWAYS;
   options.TEMP_TH_TYPE          = KIENZLE;
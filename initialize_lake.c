@@ -9,7 +9,8 @@ int initialize_lake (lake_var_struct   *lake,
 		      soil_con_struct  *soil_con,
 		      hru_data_struct *cell,
 		      double            airtemp,
-		      int               skip_hydro)
+		      int               skip_hydro,
+		      const ProgramState *state)
 
 /**********************************************************************
 	initialize_lake		Laura Bowling		March 8, 2000
@@ -242,7 +243,7 @@ int initialize_lake (lake_var_struct   *lake,
     lake->energy.Cs[i]          = 0.0;
     lake->energy.kappa[i]       = 0.0;
   }
-  for (i=0; i<MAX_NODES; i++) {
+  for (i=0; i<state->options.Nnode; i++) {
     lake->energy.Cs_node[i]     = 0.0;
     lake->energy.ice_content[i]         = 0.0;
     lake->energy.kappa_node[i]  = 0.0;
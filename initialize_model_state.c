@@ -106,10 +106,6 @@ int initialize_model_state(cell_info_struct* cell,
 	      state->options.Nnodes is no longer automatically reset here.	TJB
 **********************************************************************/
 {
-#if QUICK_FS
-  extern const double temps[];
-#endif
-
   char     ErrStr[MAXSTRING];
   char     FIRST_VEG;
   double   tmp_moist[MAX_LAYERS];
@@ -128,7 +124,6 @@ int initialize_model_state(cell_info_struct* cell,
 #else
   double   ice[NUM_HRU][MAX_LAYERS];
 #endif // SPATIAL_FROST
-  double   Aufwc, Bufwc;
   double   Clake;
   double   precipitation_mu;
   double   surf_swq;
@@ -146,6 +141,8 @@ int initialize_model_state(cell_info_struct* cell,
   Tair = surf_temp;
   if ( surf_temp < -1. ) surf_temp = -1.;
   
+  update_active_hrus(&cell->prcp, &cell->soil_con, state);
+
   // initialize storm parameters to start a new simulation
   for (std::vector<HRU>::iterator hru = cell->prcp.hruList.begin(); hru != cell->prcp.hruList.end(); ++hru) {
     hru->init_STILL_STORM = 0;
@@ -181,11 +178,11 @@ int initialize_model_state(cell_info_struct* cell,
     Initialize all lake variables 
   ********************************************/
 
-  if ( state->options.LAKES && cell->lake_con.Cl[0] > 0) {
+  if (cell->prcp.lake_var != NULL && cell->lake_con.Cl[0] > 0) {
     for (std::vector<HRU>::iterator hru = cell->prcp.hruList.begin(); hru != cell->prcp.hruList.end(); ++hru) {
       if (hru->veg_con.vegClass == cell->lake_con.lake_idx) {
         hru->veg_con.LAKE = 1;
-        ErrorFlag = initialize_lake(&cell->prcp.lake_var, cell->lake_con, &cell->soil_con, &(hru->cell[WET]), surf_temp, 0);
+        ErrorFlag = initialize_lake(cell->prcp.lake_var, cell->lake_con, &cell->soil_con, &(hru->cell[WET]), surf_temp, 0, state);
         if (ErrorFlag == ERROR) return(ErrorFlag);
       }
     }
@@ -212,27 +209,20 @@ int initialize_model_state(cell_info_struct* cell,
     spatial distribution of soil frost routines.
   ********************************************************/
 
-#if QUICK_FS
-#error // QUICK_FS is an untested code path. Continue at your own risk!
-  if(state->options.FROZEN_SOIL) {
+  if(state->options.FROZEN_SOIL && state->options.QUICK_FS) {
 
     /***********************************************************
-      Prepare table of maximum unfrozen water content values
+      Look up the table of maximum unfrozen water content values
+      of each layer
       - This linearizes the equation for maximum unfrozen water
         content, reducing computation time for the frozen soil
-        model.
+        model.  Layers (of any cell) with the same soil
+        parameters share a table.
     ***********************************************************/
 
-    for(lidx=0;lidx<state->options.Nlayer;lidx++) {
-      for(ii=0;ii<QUICK_FS_TEMPS;ii++) {
-        Aufwc = maximum_unfrozen_water(temps[ii], 1.0, cell->soil_con.bubble[lidx], cell->soil_con.expt[lidx]);
-        Bufwc = maximum_unfrozen_water(temps[ii+1], 1.0, cell->soil_con.bubble[lidx], cell->soil_con.expt[lidx]);
-        cell->soil_con.ufwc_table_layer[lidx][ii][0] = linear_interp(0., temps[ii], temps[ii+1], Aufwc, Bufwc);
-        cell->soil_con.ufwc_table_layer[lidx][ii][1] = (Bufwc - Aufwc) / (temps[ii+1] - temps[ii]);
-      }
-    }
-  }  
-#endif // QUICK_FS
+    for(int lidx=0;lidx<state->options.Nlayer;lidx++)
+      cell->soil_con.ufwc_table_layer[lidx] = UfwcTable::get(cell->soil_con.bubble[lidx], cell->soil_con.expt[lidx]);
+  }
 
 
 
@@ -323,8 +313,15 @@ int initialize_model_state(cell_info_struct* cell,
     }
 #endif
 
-
-    read_initial_model_state(initStateFilename, cell, cell->prcp.hruList.size(), Ndist, state);
+    if (state->options.STATE_FORMAT == StateOutputFormat::NETCDF_STATEFILE) {
+      // The netCDF library is not thread safe: cells initialized in parallel take turns, also with the forcing reader.
+#if PARALLEL_AVAILABLE
+#pragma omp critical(netcdf_forcing)
+#endif
+      read_initial_model_state(initStateFilename, cell, cell->prcp.hruList.size(), Ndist, state);
+    }
+    else
+      read_initial_model_state(initStateFilename, cell, cell->prcp.hruList.size(), Ndist, state);
 
 #if EXCESS_ICE
     // calculate dynamic soil and veg properties if excess_ice is present
@@ -437,17 +434,17 @@ int initialize_model_state(cell_info_struct* cell,
 
       // Override possible bad values of soil moisture under lake coming from state file
       // (ideally we wouldn't store these in the state file in the first place)
-      if (state->options.LAKES && it->veg_con.vegClass == cell->lake_con.lake_idx) {
+      if (cell->prcp.lake_var != NULL && it->veg_con.vegClass == cell->lake_con.lake_idx) {
         for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
-          cell->prcp.lake_var.soil.layer[lidx].moist = cell->soil_con.max_moist[lidx];
+          cell->prcp.lake_var->soil.layer[lidx].moist = cell->soil_con.max_moist[lidx];
 #if SPATIAL_FROST
           for ( frost_area = 0; frost_area < FROST_SUBAREAS; frost_area++) {
             if (cell->prcp.lake_var->soil.layer[lidx].soil_ice[frost_area] > cell->prcp.lake_var->soil.layer[lidx].moist)
             cell->prcp.lake_var->soil.layer[lidx].soil_ice[frost_area] = cell->prcp.lake_var->soil.layer[lidx].moist;
           }
 #else
-          if (cell->prcp.lake_var.soil.layer[lidx].soil_ice > cell->prcp.lake_var.soil.layer[lidx].moist)
-            cell->prcp.lake_var.soil.layer[lidx].soil_ice = cell->prcp.lake_var.soil.layer[lidx].moist;
+          if (cell->prcp.lake_var->soil.layer[lidx].soil_ice > cell->prcp.lake_var->soil.layer[lidx].moist)
+            cell->prcp.lake_var->soil.layer[lidx].soil_ice = cell->prcp.lake_var->soil.layer[lidx].moist;
 #endif
         }
       }
@@ -941,3 +938,33 @@ int update_thermal_nodes(dist_prcp_struct    *prcp,
 
   return (0);
 }
+
+void update_active_hrus(dist_prcp_struct    *prcp,
+                        const soil_con_struct *soil_con,
+                        const ProgramState  *state)
+/**********************************************************************
+  update_active_hrus
+
+  Collects the indices of the HRUs which full_energy() solves, i.e. those
+  with vegetation cover in an elevation band with area (glaciers are
+  solved with zero cover or area when GLACIER_DYNAMICS is TRUE, and lake
+  tiles regardless of band area), and of the glacier HRUs.  The time step
+  loops walk these lists rather than the whole hruList, which in cells
+  with many elevation bands is mostly HRUs of zero area.  This must be
+  called again whenever the cover fractions or band areas change.
+**********************************************************************/
+{
+  prcp->activeHRUs.clear();
+  prcp->glacierHRUs.clear();
+  for (unsigned int hruIndex = 0; hruIndex < prcp->hruList.size(); hruIndex++) {
+    const HRU& hru = prcp->hruList[hruIndex];
+    bool dynamicGlacier = hru.isGlacier && state->options.GLACIER_DYNAMICS;
+    double areaFract = soil_con->AreaFract[hru.bandIndex];
+    if (hru.isGlacier)
+      prcp->glacierHRUs.push_back(hruIndex);
+    if (!((hru.veg_con.Cv > 0.) || (dynamicGlacier && hru.veg_con.Cv >= 0.)))
+      continue;
+    if ((areaFract > 0.) || (dynamicGlacier && areaFract >= 0.) || hru.veg_con.LAKE)
+      prcp->activeHRUs.push_back(hruIndex);
+  }
+}
@@ -2352,7 +2352,7 @@ int water_balance (lake_var_struct *lake, lake_con_struct lake_con, int dt, dist
         lake->snow.coverage = 0;
     }
     else { // lake didn't exist at beginning of time step; create new lake
-      initialize_lake(lake, lake_con, &soil_con, &(hruElement.cell[WET]), hruElement.energy.T[0], 1);
+      initialize_lake(lake, lake_con, &soil_con, &(hruElement.cell[WET]), hruElement.energy.T[0], 1, state);
     }
   }
   else if (lakefrac > 0.0) { // lake is gone at end of time step, but existed at beginning of step
@@ -3,7 +3,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include "vicNl.h"
-#include <netcdf.h>
 
 static char vcid[] = "$Id$";
 
@@ -57,12 +56,11 @@ void make_in_files(filep_struct         *filep,
     strcat(filenames->forcing[0], lngchar);
   }
 
+  /* NetCDF forcing files are opened once for all cells, see NetCDFForcingReader */
   filep->forcing[0] = NULL;
-  if (state->param_set.FORCE_FORMAT[0] == NETCDF)
-    assert(nc_open(filenames->forcing[0], NC_NOWRITE, &filep->forcing_ncid[0]) == NC_NOERR); /* TODO proper error handling */
-  else if(state->param_set.FORCE_FORMAT[0] == BINARY)
+  if(state->param_set.FORCE_FORMAT[0] == BINARY)
     filep->forcing[0] = open_file(filenames->forcing[0], "rb");
-  else
+  else if(state->param_set.FORCE_FORMAT[0] != NETCDF)
     filep->forcing[0] = open_file(filenames->forcing[0], "r");
 
   filep->forcing[1] = NULL;
@@ -73,11 +71,9 @@ void make_in_files(filep_struct         *filep,
       strcat(filenames->forcing[1], "_");
       strcat(filenames->forcing[1], lngchar);
     }
-    if(state->param_set.FORCE_FORMAT[1] == NETCDF)
-      assert(nc_open(filenames->forcing[1], NC_NOWRITE, &filep->forcing_ncid[1]) == NC_NOERR); /* TODO proper error handling */
-    else if(state->param_set.FORCE_FORMAT[1] == BINARY) /* MPN: Changed this to [1]; It's used elsewhere so I presume it's actually set. */
+    if(state->param_set.FORCE_FORMAT[1] == BINARY) /* MPN: Changed this to [1]; It's used elsewhere so I presume it's actually set. */
       filep->forcing[1] = open_file(filenames->forcing[1], "rb");
-    else 
+    else if(state->param_set.FORCE_FORMAT[1] != NETCDF)
       filep->forcing[1] = open_file(filenames->forcing[1], "r");
   }
 
@@ -109,6 +109,22 @@ double *s_tfmax; /* array of cloud transmittance factor values */
   /* end vic_change */
 } data_struct;
 
+/* start vic_change */
+/* Site-constant radiation geometry, built by calc_solar_geometry().  These
+   depend only on the site latitude, elevation, slope, aspect and horizons
+   (and on the time zone offset, for hourly_radfract), so they are shared
+   between all cells with the same values. */
+typedef struct
+{
+  double ttmax0[366];            /* maximum daily total transmittance */
+  double flat_potrad[366];       /* daylight average flux density, flat surface (W/m2) */
+  double slope_potrad[366];      /* daylight average flux density, slope (W/m2) */
+  double daylength[366];         /* daylength (s) */
+  double hourly_radfract[366][24]; /* fraction of the daily potential radiation
+                                      falling in each local hour */
+} solar_geom_struct;
+/* end vic_change */
+
 /********************************
  **                             **
  **    FUNCTION PROTOTYPES      **
@@ -119,19 +135,21 @@ int calc_tair(const control_struct *ctrl, const parameter_struct *p,
 int calc_prcp(const control_struct *ctrl, const parameter_struct *p, 
 	      data_struct *data);
 /* start vic_change */
+void calc_solar_geometry(const parameter_struct *p, int tiny_offset,
+			 solar_geom_struct *geom);
 int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p, 
-		       data_struct *data, double **tiny_radfract, const ProgramState*);
+		       data_struct *data, const solar_geom_struct *geom, const ProgramState*);
 /* end vic_change */
 /* start vic_change */
 int calc_srad_humidity_iterative(const control_struct *ctrl,
 				 const parameter_struct *p, data_struct *data,
-				 double **tiny_radfract, const ProgramState* state);
+				 const solar_geom_struct *geom, const ProgramState* state);
 int snowpack(const control_struct *ctrl, const parameter_struct *p, 
 	      data_struct *data);
 void compute_srad_humidity_onetime(int ndays, const control_struct *ctrl,
-    data_struct *data, double *tdew, double *pva, double *ttmax0,
-    double *flat_potrad, double *slope_potrad, double sky_prop,
-    double *daylength, double *pet, double *parray, double pa, double *dtr,
+    data_struct *data, double *tdew, double *pva, const double *ttmax0,
+    const double *flat_potrad, const double *slope_potrad, double sky_prop,
+    const double *daylength, double *pet, double *parray, double pa, double *dtr,
     const ProgramState*);
 /* end vic_change */
 int data_alloc(const control_struct *ctrl, data_struct *data);
@@ -14,8 +14,11 @@
 	    introduction to hydrologic science", Addison-Wesley, Reading,
 	    Massachusetts, 1990).
 	    - For each day of the year the fraction of the total daily potential
-	    radiation that occurs during each radiation time step is also
-	    returned through the variable tiny_radfract
+	    radiation that occurs during each hour is also returned, through
+	    the hourly_radfract member of solar_geom_struct
+	    - the site-constant radiation geometry (STEPS 1-3 of the srad
+	    algorithm) is computed separately by calc_solar_geometry(), so
+	    that it can be shared between cells
 	    - SRADDT has been changed to be 300 sec
 	    Changes are preceded by the comment * start vic_change *  and
 	    followed by the comment * end vic_change *
@@ -522,111 +525,43 @@ int snowpack(const control_struct *ctrl, const parameter_struct *p,
 }
 /* end of snowpack() */
 
-/* when dewpoint temperature observations are available, radiation and
-   humidity can be estimated directly */
 /* start vic_change */
-int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p, 
-		       data_struct *data, double **tiny_radfract, const ProgramState* state)
-/* end vic_change */
+/* The site-constant part of the radiation algorithm (STEPS 1-3), split out of
+   calc_srad_humidity() and calc_srad_humidity_iterative() so that the result
+   can be shared between cells with the same geometry (see mtclim_wrapper.c).
+   Instead of returning the fraction of daily potential radiation falling in
+   every SRADDT interval of every yearday, the fractions are summed into the
+   24 local hours of each yearday, using tiny_offset (the number of SRADDT
+   intervals between local solar time and the time zone of the forcings). */
+void calc_solar_geometry(const parameter_struct *p, int tiny_offset,
+			 solar_geom_struct *geom)
 {
-  int ok=1;
-  int i,j,ndays;
-  double pva,pvs,vpd;
-  int ami,yday;
-  double ttmax0[366];
-  double flat_potrad[366];
-  double slope_potrad[366];
-  double daylength[366];
-  double *dtr, *sm_dtr;
-  double tmax,tmin;
+  int i,j,k;
+  int ami;
   double t1,t2;
   double pratio;
-  double lat,coslat,sinlat,dt,dh,h;
+  double lat,coslat,sinlat,dt,h,dh;
   double cosslp,sinslp,cosasp,sinasp;
   double bsg1,bsg2,bsg3;
   double decl,cosdecl,sindecl,cosegeom,sinegeom,coshss,hss;
   double sc,dir_beam_topa;
-  double sum_flat_potrad, sum_slope_potrad, sum_trans;
+  double sum_flat_potrad,sum_slope_potrad,sum_trans;
   double cosh,sinh;
   double cza,cbsa,coszeh,coszwh;
   double dir_flat_topa,am;
   double trans1,trans2;
-  double t_tmax,b,t_fmax;
-  double t_final,pdif,pdir,srad1,srad2; 
-  double sky_prop;
-  double avg_horizon, slope_excess;
-  double horizon_scalar, slope_scalar;
-  double *parray, *window, *tdew;
-  double sum_prcp,ann_prcp,effann_prcp;
-  double sum_pet,ann_pet;
-  double tmink,pet,ratio,ratio2,ratio3,tdewk;
-  double pa;
-  int start_yday,end_yday,isloop;
 
   /* optical airmass by degrees */
   double optam[21] = {2.90,3.05,3.21,3.39,3.69,3.82,4.07,4.37,4.72,5.12,5.60,
 		      6.18,6.88,7.77,8.90,10.39,12.44,15.36,19.79,26.96,30.00};
-  
-  /* start vic_change */
+
   int tinystep;
   int tinystepspday;
-  double tfmax_tmp;
-  /* end vic_change */
-  
-  /* number of simulation days */
-  ndays = ctrl->ndays;
- 
-  if (!ctrl->invp && ctrl->indewpt) {
-    /* calculate humidity from Tdew observations */
-    for (i=0 ; i<ndays ; i++) {
-      /* convert dewpoint to vapor pressure */
-      /* start vic_change */
-      /* pva = 610.7 * exp(17.38 * data->tdew[i] / (239.0 + data->tdew[i])); */
-      pva = svp(data->tdew[i]);
-      /* end vic_change */
-      data->s_hum[i] = pva;
-    }
-  }
-  
-  /* estimate radiation using Tdew observations */
-  /* allocate space for DTR and smoothed DTR arrays */
-  if (!(dtr = (double*) malloc(ndays * sizeof(double)))) {
-	fprintf(stderr, "Error allocating for DTR array\n");
-    ok=0;
-  }
-  if (!(sm_dtr = (double*) malloc(ndays * sizeof(double)))) {
-	fprintf(stderr, "Error allocating for smoothed DTR array\n");
-    ok=0;
-  }
-  
-  /* calculate diurnal temperature range for transmittance calculations */
-  for (i=0 ; i<ndays ; i++) {
-    tmax = data->tmax[i];
-    tmin = data->tmin[i];
-    if (tmax < tmin) tmax = tmin;
-    dtr[i] = tmax-tmin;
-  }
-  
-  /* smooth dtr array using a 30-day antecedent smoothing window */
-  if (ndays >= 30) {
-    if (pulled_boxcar(dtr, sm_dtr, ndays, 30, 0)) {
-      fprintf(stderr, "Error in boxcar smoothing, calc_srad_humidity()\n");
-      ok=0;
-    }
-  }
-  else /* smoothing window width = ndays */ {
-    if (pulled_boxcar(dtr, sm_dtr, ndays, ndays, 0)) {
-      fprintf(stderr, "Error in boxcar smoothing, calc_srad_humidity()\n");
-      ok=0;
-    }
-  }
-  
-  /*****************************************
-   *                                       *
-   * start of the main radiation algorithm *
-   *                                       *
-   *****************************************/
-  
+  int tinystepsphour;
+  /* fraction of the daily potential radiation in each SRADDT interval of
+     the current yearday */
+  double tiny_radfract[(int)(86400/SRADDT)];
+
   /* STEP (1) calculate pressure ratio (site/reference) = f(elevation) */
   t1 = 1.0 - (LR_STD * p->site_elev)/T_STD;
   t2 = G_STD / (LR_STD * (R/MA));
@@ -660,10 +595,16 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
   dh = dt / SECPERRAD;        /* calculate hour-angle step */
   /* start vic_change */
   tinystepspday = 86400/SRADDT;
+  tinystepsphour = 3600/SRADDT;
   /* end vic_change */
 
   /* begin loop through yeardays */
   for (i=0 ; i<365 ; i++) {
+    /* start vic_change */
+    for (j = 0; j < tinystepspday; j++)
+      tiny_radfract[j] = 0;
+    /* end vic_change */
+
     /* calculate cos and sin of declination */
     decl = MINDECL * cos(((double)i + DAYSOFF) * RADPERDAY);
     cosdecl = cos(decl);
@@ -684,13 +625,13 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
       coshss = 1.0;    /* 0-hr daylight */
     hss = acos(coshss);                /* hour angle at sunset (radians) */
     /* daylength (seconds) */
-    daylength[i] = 2.0 * hss * SECPERRAD;
+    geom->daylength[i] = 2.0 * hss * SECPERRAD;
     
     /* start vic_change */
-    if (daylength[i] > 86400)
-      daylength[i] = 86400;
+    if (geom->daylength[i] > 86400)
+      geom->daylength[i] = 86400;
     /* end vic_change */
-
+    
     /* solar constant as a function of yearday (W/m^2) */
     sc = 1368.0 + 45.5*sin((2.0*PI*(double)i/365.25) + 1.7);
     /* extraterrestrial radiation perpendicular to beam, total over
@@ -702,7 +643,6 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
     sum_slope_potrad = 0.0;
     
     /* begin sub-daily hour-angle loop, from -hss to hss */
-    
     for (h=-hss ; h<hss ; h+=dh) {
       /* precalculate cos and sin of hour angle */
       cosh = cos(h);
@@ -729,8 +669,10 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
 	am = 1.0/(cza + 0.0000001);
 	if (am > 2.9) {
 	  ami = (int)(acos(cza)/RADPERDEG) - 69;
-	  if (ami < 0) ami = 0;
-	  if (ami > 20) ami = 20;
+	  if (ami < 0) 
+	    ami = 0;
+	  if (ami > 20) 
+	    ami = 20;
 	  am = optam[ami];
 	}
 	
@@ -746,11 +688,12 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
 	/* keep track of total potential radiation on a flat
 	   surface for ideal horizons */
 	sum_flat_potrad += dir_flat_topa;
-
+	
 	/* keep track of whether this time step contributes to
 	   component 1 (direct on slope) */
-	if ((h<0.0 && cza>coszeh && cbsa>0.0) || 
+	if ((h<0.0 && cza>coszeh && cbsa>0.0) ||
 	    (h>=0.0 && cza>coszwh && cbsa>0.0)) {
+	  
 	  /* sun between east and west horizons, and direct on
 	     slope. this period contributes to component 1 */
 	  sum_slope_potrad += dir_beam_topa * cbsa;
@@ -758,52 +701,166 @@ int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p,
 	
       } /* end if sun above ideal horizon */
       else dir_flat_topa = -1;
-      
+
       /* start vic_change */
-      tinystep = (12 * 3600 + h * SECPERRAD)/SRADDT;
+      tinystep = (12L * 3600L + h * SECPERRAD)/SRADDT;
       if (tinystep < 0)
 	tinystep = 0;
       if (tinystep > tinystepspday-1)
 	tinystep = tinystepspday-1;
       if (dir_flat_topa > 0)
-	tiny_radfract[i][tinystep] = dir_flat_topa;
+	tiny_radfract[tinystep] = dir_flat_topa;
       else
-	tiny_radfract[i][tinystep] = 0;
+	tiny_radfract[tinystep] = 0;
       /* end vic_change */
       
     } /* end of sub-daily hour-angle loop */
     
     /* start vic_change */
-    if (daylength[i] && sum_flat_potrad > 0) {
+    if (geom->daylength[i] && sum_flat_potrad > 0) {
       for (j = 0; j < tinystepspday; j++)
-	tiny_radfract[i][j] /= sum_flat_potrad;
+	tiny_radfract[j] /= sum_flat_potrad;
+    }
+    /* sum the fractions into local hours, shifted by tiny_offset so that
+       hour 0 is local midnight */
+    for (j = 0; j < 24; j++) {
+      geom->hourly_radfract[i][j] = 0;
+      for (k = 0; k < tinystepsphour; k++) {
+        tinystep = j*tinystepsphour + k - tiny_offset;
+        if (tinystep < 0) {
+          tinystep += tinystepspday;
+        }
+        if (tinystep > tinystepspday-1) {
+          tinystep -= tinystepspday;
+        }
+        geom->hourly_radfract[i][j] += tiny_radfract[tinystep];
+      }
     }
     /* end vic_change */
 
     /* calculate maximum daily total transmittance and daylight average
        flux density for a flat surface and the slope */
-    if (daylength[i]) {
-      ttmax0[i] = sum_trans / sum_flat_potrad;
-      flat_potrad[i] = sum_flat_potrad / daylength[i];
-      slope_potrad[i] = sum_slope_potrad / daylength[i];
+    if (geom->daylength[i]) {
+      geom->ttmax0[i] = sum_trans / sum_flat_potrad;
+      geom->flat_potrad[i] = sum_flat_potrad / geom->daylength[i];
+      geom->slope_potrad[i] = sum_slope_potrad / geom->daylength[i];
     }
     else {
-      ttmax0[i] = 0.0;
-      flat_potrad[i] = 0.0;
-      slope_potrad[i] = 0.0;
+      geom->ttmax0[i] = 0.0;
+      geom->flat_potrad[i] = 0.0;
+      geom->slope_potrad[i] = 0.0;
     }
+
   } /* end of i=365 days loop */
   
   /* force yearday 366 = yearday 365 */
-  ttmax0[365] = ttmax0[364];
-  flat_potrad[365] = flat_potrad[364];
-  slope_potrad[365] = slope_potrad[364];
-  daylength[365] = daylength[364];
+  geom->ttmax0[365] = geom->ttmax0[364];
+  geom->flat_potrad[365] = geom->flat_potrad[364];
+  geom->slope_potrad[365] = geom->slope_potrad[364];
+  geom->daylength[365] = geom->daylength[364];
+  
+  /* start vic_change */
+  for (j = 0 ; j < 24; j++)
+    geom->hourly_radfract[365][j] = geom->hourly_radfract[364][j];
+  /* end vic_change */
+}
+/* end vic_change */
+
+/* when dewpoint temperature observations are available, radiation and
+   humidity can be estimated directly */
+/* start vic_change */
+int calc_srad_humidity(const control_struct *ctrl, const parameter_struct *p, 
+		       data_struct *data, const solar_geom_struct *geom, const ProgramState* state)
+/* end vic_change */
+{
+  int ok=1;
+  int i,j,ndays;
+  double pva,pvs,vpd;
+  int yday;
+  const double *ttmax0;
+  const double *flat_potrad;
+  const double *slope_potrad;
+  const double *daylength;
+  double *dtr, *sm_dtr;
+  double tmax,tmin;
+  double sc;
+  double t_tmax,b,t_fmax;
+  double t_final,pdif,pdir,srad1,srad2; 
+  double sky_prop;
+  double avg_horizon, slope_excess;
+  double horizon_scalar, slope_scalar;
+  double *parray, *window, *tdew;
+  double sum_prcp,ann_prcp,effann_prcp;
+  double sum_pet,ann_pet;
+  double tmink,pet,ratio,ratio2,ratio3,tdewk;
+  double pa;
+  int start_yday,end_yday,isloop;
 
   /* start vic_change */
-  for (j = 0 ; j < tinystepspday; j++)
-    tiny_radfract[365][j] = tiny_radfract[364][j];
+  double tfmax_tmp;
   /* end vic_change */
+  
+  /* number of simulation days */
+  ndays = ctrl->ndays;
+ 
+  if (!ctrl->invp && ctrl->indewpt) {
+    /* calculate humidity from Tdew observations */
+    for (i=0 ; i<ndays ; i++) {
+      /* convert dewpoint to vapor pressure */
+      /* start vic_change */
+      /* pva = 610.7 * exp(17.38 * data->tdew[i] / (239.0 + data->tdew[i])); */
+      pva = svp(data->tdew[i]);
+      /* end vic_change */
+      data->s_hum[i] = pva;
+    }
+  }
+  
+  /* estimate radiation using Tdew observations */
+  /* allocate space for DTR and smoothed DTR arrays */
+  if (!(dtr = (double*) malloc(ndays * sizeof(double)))) {
+	fprintf(stderr, "Error allocating for DTR array\n");
+    ok=0;
+  }
+  if (!(sm_dtr = (double*) malloc(ndays * sizeof(double)))) {
+	fprintf(stderr, "Error allocating for smoothed DTR array\n");
+    ok=0;
+  }
+  
+  /* calculate diurnal temperature range for transmittance calculations */
+  for (i=0 ; i<ndays ; i++) {
+    tmax = data->tmax[i];
+    tmin = data->tmin[i];
+    if (tmax < tmin) tmax = tmin;
+    dtr[i] = tmax-tmin;
+  }
+  
+  /* smooth dtr array using a 30-day antecedent smoothing window */
+  if (ndays >= 30) {
+    if (pulled_boxcar(dtr, sm_dtr, ndays, 30, 0)) {
+      fprintf(stderr, "Error in boxcar smoothing, calc_srad_humidity()\n");
+      ok=0;
+    }
+  }
+  else /* smoothing window width = ndays */ {
+    if (pulled_boxcar(dtr, sm_dtr, ndays, ndays, 0)) {
+      fprintf(stderr, "Error in boxcar smoothing, calc_srad_humidity()\n");
+      ok=0;
+    }
+  }
+  
+  /*****************************************
+   *                                       *
+   * start of the main radiation algorithm *
+   *                                       *
+   *****************************************/
+  
+  /* STEPS (1)-(3) pressure ratio, elevation-corrected transmittance, and the
+     366-day arrays of ttmax0, potential rad, and daylength are site constants;
+     they are computed once per site geometry by calc_solar_geometry() */
+  ttmax0 = geom->ttmax0;
+  flat_potrad = geom->flat_potrad;
+  slope_potrad = geom->slope_potrad;
+  daylength = geom->daylength;
 
   /* STEP (4)  calculate the sky proportion for diffuse radiation */
   /* uses the product of spherical cap defined by average horizon angle
@@ -1062,38 +1119,26 @@ data->s_ppratio[i] = ratio*365.25;
 /* start vic_change */
 int calc_srad_humidity_iterative(const control_struct *ctrl,
 				 const parameter_struct *p, data_struct *data,
-				 double **tiny_radfract, const ProgramState* state)
+				 const solar_geom_struct *geom, const ProgramState* state)
   /* end vic_change */
 {
   int ok=1;
   int i,j,ndays;
   int start_yday,end_yday,isloop;
-  int ami,yday;
-  double ttmax0[366];
-  double flat_potrad[366];
-  double slope_potrad[366];
-  double daylength[366];
+  int yday;
+  const double *ttmax0;
+  const double *flat_potrad;
+  const double *slope_potrad;
+  const double *daylength;
   double *dtr, *sm_dtr;
   double *parray, *window, *t_fmax, *tdew;
   double *pet;
   double sum_prcp,ann_prcp,effann_prcp;
   double sum_pet,ann_pet;
   double tmax,tmin;
-  double t1,t2;
-  double pratio;
-  double lat,coslat,sinlat,dt,h,dh;
-  double cosslp,sinslp,cosasp,sinasp;
-  double bsg1,bsg2,bsg3;
-  double decl,cosdecl,sindecl,cosegeom,sinegeom,coshss,hss;
-  double sc,dir_beam_topa;
-  double sum_flat_potrad,sum_slope_potrad,sum_trans;
-  double cosh,sinh;
-  double cza,cbsa,coszeh,coszwh;
-  double dir_flat_topa,am;
   double t_tmax,b;
   double tmink,ratio,ratio2,ratio3,tdewk;
   double pvs,vpd;
-  double trans1,trans2;
   double t_final,pdif,pdir,srad1,srad2; 
   double pa;
   double sky_prop;
@@ -1101,13 +1146,7 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
   double horizon_scalar, slope_scalar;
   int update_pva;
 
-  /* optical airmass by degrees */
-  double optam[21] = {2.90,3.05,3.21,3.39,3.69,3.82,4.07,4.37,4.72,5.12,5.60,
-		      6.18,6.88,7.77,8.90,10.39,12.44,15.36,19.79,26.96,30.00};
-  
   /* start vic_change */
-  int tinystep;
-  int tinystepspday;
   double tfmax_tmp;
   /* end vic_change */
   
@@ -1279,186 +1318,13 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
      radiation, calculate all the variables that don't depend on 
      humidity so they only get done once. */
   
-  /* STEP (1) calculate pressure ratio (site/reference) = f(elevation) */
-  t1 = 1.0 - (LR_STD * p->site_elev)/T_STD;
-  t2 = G_STD / (LR_STD * (R/MA));
-  pratio = pow(t1,t2);
-  
-  /* STEP (2) correct initial transmittance for elevation */ 
-  trans1 = pow(TBASE,pratio);
-  
-  /* STEP (3) build 366-day array of ttmax0, potential rad, and daylength */
-  
-  /* precalculate the transcendentals */
-  lat = p->site_lat;
-  /* check for (+/-) 90 degrees latitude, throws off daylength calc */
-  lat *= RADPERDEG;
-  if (lat > 1.5707) 
-    lat = 1.5707;
-  if (lat < -1.5707) 
-    lat = -1.5707;
-  coslat = cos(lat);
-  sinlat = sin(lat);
-  cosslp = cos(p->site_slp * RADPERDEG);
-  sinslp = sin(p->site_slp * RADPERDEG);
-  cosasp = cos(p->site_asp * RADPERDEG);
-  sinasp = sin(p->site_asp * RADPERDEG);
-  /* cosine of zenith angle for east and west horizons */
-  coszeh = cos(1.570796 - (p->site_ehoriz * RADPERDEG));
-  coszwh = cos(1.570796 - (p->site_whoriz * RADPERDEG));
-  
-  /* sub-daily time and angular increment information */
-  dt = SRADDT;                /* set timestep */ 
-  dh = dt / SECPERRAD;        /* calculate hour-angle step */
-  /* start vic_change */
-  tinystepspday = 86400/SRADDT;
-  /* end vic_change */
-
-  /* begin loop through yeardays */
-  for (i=0 ; i<365 ; i++) {
-    /* calculate cos and sin of declination */
-    decl = MINDECL * cos(((double)i + DAYSOFF) * RADPERDAY);
-    cosdecl = cos(decl);
-    sindecl = sin(decl);
-    
-    /* do some precalculations for beam-slope geometry (bsg) */
-    bsg1 = -sinslp * sinasp * cosdecl;
-    bsg2 = (-cosasp * sinslp * sinlat + cosslp * coslat) * cosdecl;
-    bsg3 = (cosasp * sinslp * coslat + cosslp * sinlat) * sindecl;
-    
-    /* calculate daylength as a function of lat and decl */
-    cosegeom = coslat * cosdecl;
-    sinegeom = sinlat * sindecl;
-    coshss = -(sinegeom) / cosegeom;
-    if (coshss < -1.0) 
-      coshss = -1.0;  /* 24-hr daylight */
-    if (coshss > 1.0) 
-      coshss = 1.0;    /* 0-hr daylight */
-    hss = acos(coshss);                /* hour angle at sunset (radians) */
-    /* daylength (seconds) */
-    daylength[i] = 2.0 * hss * SECPERRAD;
-    
-    /* start vic_change */
-    if (daylength[i] > 86400)
-      daylength[i] = 86400;
-    /* end vic_change */
-    
-    /* solar constant as a function of yearday (W/m^2) */
-    sc = 1368.0 + 45.5*sin((2.0*PI*(double)i/365.25) + 1.7);
-    /* extraterrestrial radiation perpendicular to beam, total over
-       the timestep (J) */
-    dir_beam_topa = sc * dt;
-    
-    sum_trans = 0.0;
-    sum_flat_potrad = 0.0;
-    sum_slope_potrad = 0.0;
-    
-    /* begin sub-daily hour-angle loop, from -hss to hss */
-    for (h=-hss ; h<hss ; h+=dh) {
-      /* precalculate cos and sin of hour angle */
-      cosh = cos(h);
-      sinh = sin(h);
-      
-      /* calculate cosine of solar zenith angle */
-      cza = cosegeom * cosh + sinegeom;
-      
-      /* calculate cosine of beam-slope angle */
-      cbsa = sinh * bsg1 + cosh * bsg2 + bsg3;
-      
-      /* check if sun is above a flat horizon */
-      if (cza > 0.0) {
-	/* when sun is above the ideal (flat) horizon, do all the
-	   flat-surface calculations to determine daily total
-	   transmittance, and save flat-surface potential radiation
-	   for later calculations of diffuse radiation */
-	
-	/* potential radiation for this time period, flat surface,
-	   top of atmosphere */
-	dir_flat_topa = dir_beam_topa * cza;
-	
-	/* determine optical air mass */
-	am = 1.0/(cza + 0.0000001);
-	if (am > 2.9) {
-	  ami = (int)(acos(cza)/RADPERDEG) - 69;
-	  if (ami < 0) 
-	    ami = 0;
-	  if (ami > 20) 
-	    ami = 20;
-	  am = optam[ami];
-	}
-	
-	/* correct instantaneous transmittance for this optical
-	   air mass */
-	trans2 = pow(trans1,am);
-	
-	/* instantaneous transmittance is weighted by potential
-	   radiation for flat surface at top of atmosphere to get
-	   daily total transmittance */
-	sum_trans += trans2 * dir_flat_topa;
-	
-	/* keep track of total potential radiation on a flat
-	   surface for ideal horizons */
-	sum_flat_potrad += dir_flat_topa;
-	
-	/* keep track of whether this time step contributes to
-	   component 1 (direct on slope) */
-	if ((h<0.0 && cza>coszeh && cbsa>0.0) ||
-	    (h>=0.0 && cza>coszwh && cbsa>0.0)) {
-	  
-	  /* sun between east and west horizons, and direct on
-	     slope. this period contributes to component 1 */
-	  sum_slope_potrad += dir_beam_topa * cbsa;
-	}
-	
-      } /* end if sun above ideal horizon */
-      else dir_flat_topa = -1;
-
-      /* start vic_change */
-      tinystep = (12L * 3600L + h * SECPERRAD)/SRADDT;
-      if (tinystep < 0)
-	tinystep = 0;
-      if (tinystep > tinystepspday-1)
-	tinystep = tinystepspday-1;
-      if (dir_flat_topa > 0)
-	tiny_radfract[i][tinystep] = dir_flat_topa;
-      else
-	tiny_radfract[i][tinystep] = 0;
-      /* end vic_change */
-      
-    } /* end of sub-daily hour-angle loop */
-    
-    /* start vic_change */
-    if (daylength[i] && sum_flat_potrad > 0) {
-      for (j = 0; j < tinystepspday; j++)
-	tiny_radfract[i][j] /= sum_flat_potrad;
-    }
-    /* end vic_change */
-
-    /* calculate maximum daily total transmittance and daylight average
-       flux density for a flat surface and the slope */
-    if (daylength[i]) {
-      ttmax0[i] = sum_trans / sum_flat_potrad;
-      flat_potrad[i] = sum_flat_potrad / daylength[i];
-      slope_potrad[i] = sum_slope_potrad / daylength[i];
-    }
-    else {
-      ttmax0[i] = 0.0;
-      flat_potrad[i] = 0.0;
-      slope_potrad[i] = 0.0;
-    }
-
-  } /* end of i=365 days loop */
-  
-  /* force yearday 366 = yearday 365 */
-  ttmax0[365] = ttmax0[364];
-  flat_potrad[365] = flat_potrad[364];
-  slope_potrad[365] = slope_potrad[364];
-  daylength[365] = daylength[364];
-  
-  /* start vic_change */
-  for (j = 0 ; j < tinystepspday; j++)
-    tiny_radfract[365][j] = tiny_radfract[364][j];
-  /* end vic_change */
+  /* STEPS (1)-(3) pressure ratio, elevation-corrected transmittance, and the
+     366-day arrays of ttmax0, potential rad, and daylength are site constants;
+     they are computed once per site geometry by calc_solar_geometry() */
+  ttmax0 = geom->ttmax0;
+  flat_potrad = geom->flat_potrad;
+  slope_potrad = geom->slope_potrad;
+  daylength = geom->daylength;
 
   /* STEP (4)  calculate the sky proportion for diffuse radiation */
   /* uses the product of spherical cap defined by average horizon angle
@@ -1629,9 +1495,9 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
 } /* end of calc_srad_humidity_iterative() */
 
 void compute_srad_humidity_onetime(int ndays, const control_struct *ctrl,
-    data_struct *data, double *tdew, double *pva, double *ttmax0,
-    double *flat_potrad, double *slope_potrad, double sky_prop,
-    double *daylength, double *pet, double *parray, double pa, double *dtr,
+    data_struct *data, double *tdew, double *pva, const double *ttmax0,
+    const double *flat_potrad, const double *slope_potrad, double sky_prop,
+    const double *daylength, double *pet, double *parray, double pa, double *dtr,
     const ProgramState* state) {
 
   int i;
@@ -28,6 +28,10 @@
 	      every non-leap year.  At high latitudes this resulted in
 	      substantial errors in the diurnal cycle after 20-30 years
 	      of simulation.  This has been fixed.			TJB
+  Site radiation geometry (the former tiny_radfract array, plus ttmax0,
+  potential radiation and daylength) is now computed once per distinct
+  site by calc_solar_geometry() and shared between cells through a small
+  cache, instead of being recomputed and reallocated for every cell.
 
 *******************************************************************************/
 /******************************************************************************/
@@ -37,6 +41,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <memory>
+#include <vector>
 #include "vicNl.h"
 #include "mtclim_constants_vic.h"
 #include "mtclim_parameters_vic.h"
@@ -47,20 +53,46 @@ static char vcid[] = "$Id$";
 /*			TYPE DEFINITIONS, GLOBALS, ETC.                       */
 /******************************************************************************/
 
+/* maximum number of distinct site geometries kept in the cache.  Each entry
+   is about 80 KB; the least recently used entry is replaced when full */
+#define SOLAR_GEOM_CACHE_SIZE 64
+
+/* everything that calc_solar_geometry() depends on */
+typedef struct {
+  double lat;
+  double elev;
+  double slp;
+  double asp;
+  double ehoriz;
+  double whoriz;
+  int tiny_offset;
+} solar_geom_key;
+
+typedef struct {
+  solar_geom_key key;
+  std::shared_ptr<const solar_geom_struct> geom;
+  unsigned long last_used;
+} solar_geom_cache_entry;
+
+static std::vector<solar_geom_cache_entry> solar_geom_cache;
+static unsigned long solar_geom_cache_clock = 0;
+
 /******************************************************************************/
 /*			      FUNCTION PROTOTYPES                             */
 /******************************************************************************/
 void mtclim_init(int have_dewpt, int have_shortwave, const soil_con_struct* soil, int Ndays, dmy_struct *dmy,
 		   double *prec, double *tmax, double *tmin, double *vp, double *hourlyrad, 
-		   double **tiny_radfract, control_struct *ctrl, 
+		   control_struct *ctrl, 
 		   parameter_struct *p, data_struct *mtclim_data, const ProgramState* state);
 
-void mtclim_to_vic(double hour_offset, 
-		     int Ndays, dmy_struct *dmy, 
-		     double **tiny_radfract, control_struct *ctrl, 
+void mtclim_to_vic(int Ndays, dmy_struct *dmy, 
+		     const solar_geom_struct *geom, control_struct *ctrl, 
 		     data_struct *mtclim_data, double *tskc, double *vp, 
 		     double *hourlyrad);
 
+static std::shared_ptr<const solar_geom_struct>
+get_solar_geometry(const parameter_struct *p, int tiny_offset);
+
 void mtclim_wrapper(int have_dewpt, int have_shortwave, double hour_offset,
 		      const soil_con_struct* soil,
 		      int Ndays, dmy_struct *dmy, 
@@ -70,26 +102,21 @@ void mtclim_wrapper(int have_dewpt, int have_shortwave, double hour_offset,
   control_struct ctrl;
   parameter_struct p;
   data_struct mtclim_data;
-  double **tiny_radfract;
-  int i;
-
-  /* allocate space for the tiny_radfract array */
-  tiny_radfract = (double **) calloc(366, sizeof(double*));
-  if (tiny_radfract == NULL) {
-    nrerror("Memory allocation error in mtclim_init() ...\n");
-  }
-  for (i=0; i<366; i++) {
-    tiny_radfract[i] = (double *) calloc(86400, sizeof(double));
-    if (tiny_radfract[i] == NULL) {
-      nrerror("Memory allocation error in mtclim_init() ...\n");
-    }
-  }
+  std::shared_ptr<const solar_geom_struct> geom;
+  int tiny_offset;
 
   /* initialize the mtclim data structures */ 
   mtclim_init(have_dewpt, have_shortwave, soil, Ndays, dmy, prec,
-		tmax, tmin, vp, hourlyrad, tiny_radfract, &ctrl, &p,
+		tmax, tmin, vp, hourlyrad, &ctrl, &p,
 		&mtclim_data, state);
 
+  /* offset (in SRADDT intervals) between local solar time and the time
+     zone of the forcings */
+  tiny_offset = (int)((float)(3600/SRADDT) * hour_offset);
+
+  /* look up (or compute) the radiation geometry for this site */
+  geom = get_solar_geometry(&p, tiny_offset);
+
   /* calculate daily air temperatures */
   if (calc_tair(&ctrl, &p, &mtclim_data)) {
     nrerror("Error in calc_tair()... exiting\n");
@@ -109,39 +136,106 @@ void mtclim_wrapper(int have_dewpt, int have_shortwave, double hour_offset,
 //     appropriate srad and humidity algorithms */
 //  if (ctrl.indewpt || ctrl.invp || ctrl.insw) {
 //    /* calculate srad and humidity using real Tdew or VP or SW data */
-//    if (calc_srad_humidity(&ctrl, &p, &mtclim_data, tiny_radfract)) {
+//    if (calc_srad_humidity(&ctrl, &p, &mtclim_data, geom.get(), state)) {
 //      nrerror("Error in calc_srad_humidity()... exiting\n");
 //    }
 //  }
 //  else { /* no dewpoint temperature, VP, or SW data */
     /* calculate srad and humidity with iterative algorithm */
-    if (calc_srad_humidity_iterative(&ctrl, &p, &mtclim_data, tiny_radfract, state)) {
+    if (calc_srad_humidity_iterative(&ctrl, &p, &mtclim_data, geom.get(), state)) {
       nrerror("Error in calc_srad_humidity_iterative()... exiting\n");
     }
 //  }
 
   /* translate the mtclim structures back to the VIC data structures */
-  mtclim_to_vic(hour_offset, Ndays,
-		  dmy, tiny_radfract, &ctrl,&mtclim_data, tskc, vp,
+  mtclim_to_vic(Ndays,
+		  dmy, geom.get(), &ctrl,&mtclim_data, tskc, vp,
 		  hourlyrad);
 
   /* clean up */
   if (data_free(&ctrl, &mtclim_data)) {
     nrerror("Error in data_free()... exiting\n");
   }
-  for (i=0; i<366; i++) {
-    free(tiny_radfract[i]);
+}
+
+/* Returns the radiation geometry for the site described by p.  Neighbouring
+   cells frequently share latitude, elevation, slope, aspect and horizons, so
+   the result is cached and shared between cells (and threads) rather than
+   recomputed for each one. */
+static std::shared_ptr<const solar_geom_struct>
+get_solar_geometry(const parameter_struct *p, int tiny_offset)
+{
+  solar_geom_key key;
+  std::shared_ptr<const solar_geom_struct> geom;
+  std::shared_ptr<solar_geom_struct> new_geom;
+  size_t i, oldest;
+
+  key.lat = p->site_lat;
+  key.elev = p->site_elev;
+  key.slp = p->site_slp;
+  key.asp = p->site_asp;
+  key.ehoriz = p->site_ehoriz;
+  key.whoriz = p->site_whoriz;
+  key.tiny_offset = tiny_offset;
+
+#if PARALLEL_AVAILABLE
+#pragma omp critical(solar_geom_cache)
+#endif
+  {
+    for (i = 0; i < solar_geom_cache.size(); i++) {
+      const solar_geom_key& k = solar_geom_cache[i].key;
+      if (k.lat == key.lat && k.elev == key.elev && k.slp == key.slp
+          && k.asp == key.asp && k.ehoriz == key.ehoriz
+          && k.whoriz == key.whoriz && k.tiny_offset == key.tiny_offset) {
+        solar_geom_cache[i].last_used = ++solar_geom_cache_clock;
+        geom = solar_geom_cache[i].geom;
+        break;
+      }
+    }
+  }
+  if (geom) {
+    return geom;
+  }
+
+  /* not cached; compute it outside of the critical section */
+  new_geom = std::make_shared<solar_geom_struct>();
+  calc_solar_geometry(p, tiny_offset, new_geom.get());
+  geom = new_geom;
+
+#if PARALLEL_AVAILABLE
+#pragma omp critical(solar_geom_cache)
+#endif
+  {
+    if (solar_geom_cache.size() < SOLAR_GEOM_CACHE_SIZE) {
+      solar_geom_cache_entry entry;
+      entry.key = key;
+      entry.geom = geom;
+      entry.last_used = ++solar_geom_cache_clock;
+      solar_geom_cache.push_back(entry);
+    }
+    else {
+      /* replace the least recently used entry; cells still holding it keep
+         their own reference */
+      oldest = 0;
+      for (i = 1; i < solar_geom_cache.size(); i++) {
+        if (solar_geom_cache[i].last_used < solar_geom_cache[oldest].last_used)
+          oldest = i;
+      }
+      solar_geom_cache[oldest].key = key;
+      solar_geom_cache[oldest].geom = geom;
+      solar_geom_cache[oldest].last_used = ++solar_geom_cache_clock;
+    }
   }
-  free(tiny_radfract);
+
+  return geom;
 }
   
 void mtclim_init(int have_dewpt, int have_shortwave, const soil_con_struct* soil, int Ndays, dmy_struct *dmy,
 		   double *prec, double *tmax, double *tmin, double *vp, double *hourlyrad, 
-		   double **tiny_radfract, control_struct *ctrl, 
+		   control_struct *ctrl, 
 		   parameter_struct *p, data_struct *mtclim_data, const ProgramState* state)
 {
   int i,j;
-  int tinystepspday;
 
   /* initialize the control structure */
 
@@ -203,30 +297,17 @@ void mtclim_init(int have_dewpt, int have_shortwave, const soil_con_struct* soil
     if (have_dewpt==1)
       nrerror("have_dewpt not yet implemented ...\n");
   }
-  tinystepspday = 86400/SRADDT;
-  for (i = 0; i < 366; i++) {
-    for (j = 0; j < tinystepspday; j++) {
-      tiny_radfract[i][j] = 0;
-    }
-  }
 }
 
-void mtclim_to_vic(double hour_offset, 
-		     int Ndays, dmy_struct *dmy, 
-		     double **tiny_radfract, control_struct *ctrl, 
+void mtclim_to_vic(int Ndays, dmy_struct *dmy, 
+		     const solar_geom_struct *geom, control_struct *ctrl, 
 		     data_struct *mtclim_data, double *tskc, double *vp, 
 		     double *hourlyrad)
 {
-  int i,j,k;
-  int tinystepsphour;
-  int tinystep;
-  int tiny_offset;
+  int i,j;
   double tmp_rad;
   
-  tinystepsphour = 3600/SRADDT;
-
   if (!ctrl->insw) {
-    tiny_offset = (int)((float)tinystepsphour * hour_offset);
     for (i = 0; i < ctrl->ndays; i++) {
       // s_srad = avg SW flux (W/m2) over daylight hours
       // s_dayl = number of seconds of daylight in current day
@@ -234,20 +315,10 @@ void mtclim_to_vic(double hour_offset,
       // tiny_radfrac = fraction of total daily sw falling in each SRADDT interval
       // hourlyrad = SW flux (W/m2) over each hour = total_daily_sw * sum_over_hour(tiny_radfract) / 3600
       //                                           = tmp_rad * sum_over_hour(tiny_radfract)
+      // geom->hourly_radfract already holds sum_over_hour(tiny_radfract), shifted to local time
       tmp_rad = mtclim_data->s_srad[i] * mtclim_data->s_dayl[i] / 3600.;
       for (j = 0; j < 24; j++) {
-        hourlyrad[i*24+j] = 0;
-        for (k = 0; k < tinystepsphour; k++) {
-          tinystep = j*tinystepsphour + k - tiny_offset;
-          if (tinystep < 0) {
-            tinystep += 24*tinystepsphour; 
-          }
-          if (tinystep > 24*tinystepsphour-1) {
-            tinystep -= 24*tinystepsphour; 
-          }
-          hourlyrad[i*24+j] += tiny_radfract[dmy[i*24+j].day_in_year-1][tinystep];
-        }
-        hourlyrad[i*24+j] *= tmp_rad;
+        hourlyrad[i*24+j] = geom->hourly_radfract[dmy[i*24+j].day_in_year-1][j] * tmp_rad;
       }
     }
   }
@@ -69,10 +69,14 @@ int NewtonRaphsonMethod::compute(double x[], int n)
 
   Error = 0;
 
+  SolverCall call(SOLVER_TSOIL_NEWTON);
+
   for (k=0; k<MAXTRIAL; k++) {
 
-    // calculate function value for all nodes, i.e. focus = -1
-    fda_heat_eqn(x, fvec, n, -1);
+    call.iteration();
+
+    // calculate function value for all nodes
+    fda_heat_eqn(x, fvec, n);
 
     // stop if TOLF is satisfied
     errf=0.0;
@@ -83,7 +87,7 @@ int NewtonRaphsonMethod::compute(double x[], int n)
     }
     
     // calculate the Jacobian
-    fdjac3(x, fvec, a, b, c, n);
+    heat_eqn_jacobian(x, a, b, c, n);
 
     for (i=0; i<n; i++) p[i]=-fvec[i];
 
@@ -109,6 +113,7 @@ int NewtonRaphsonMethod::compute(double x[], int n)
     }
   }
   Error = 1;
+  call.failure();
 #if VERBOSE
   //fprintf(stderr, "WARNING: Maximum number of trials %d reached in Newton-Raphson search for solution (with F error = %g).\n", MAXTRIAL, errf);
   //for (i=0; i<n; i++) 
@@ -128,45 +133,6 @@ int NewtonRaphsonMethod::compute(double x[], int n)
 #undef RELAX1
 #undef RELAX2
 #undef RELAX3
-
-
-
-#define EPS2     1e-4
-
-void NewtonRaphsonMethod::fdjac3(double x[], double fvec[], double a[], double b[], double c[], int n)
-{
-
-/******************************************************************
-  fdjac3    2006    Ming Pan      mpan@princeton.EDU
-
- forward difference approx to Jacobian,
- adapted from "Numerical Recipes"
-
-******************************************************************/
-
-  int i, j;
-  double h, temp, f[MAXSIZE];
-
-  for (j=0; j<n; j++) {
-    temp=x[j];
-    h=EPS2*fabs(temp);
-    if (h==0) h=EPS2;
-    x[j]=temp+h;
-    h=x[j]-temp;
-
-    // only update column j-1, j and j+1, caused by change in x[j]
-    fda_heat_eqn(x, f, n, j);
-
-    x[j]=temp;
-
-    b[j]=(f[j]-fvec[j])/h;
-    if (j!=0) c[j-1]=(f[j-1]-fvec[j-1])/h;
-    if (j!=n-1) a[j+1]=(f[j+1]-fvec[j+1])/h;
-  }
-
-}
-
-#undef EPS2
 #undef MAXSIZE
 
 
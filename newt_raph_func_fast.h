@@ -16,8 +16,9 @@ public:
   virtual ~NewtonRaphsonMethod() {}
   int compute(double x[], int n);
 private:
-  virtual void fda_heat_eqn(double [], double [], int n, int focus);
-  void fdjac3(double x[], double fvec[], double a[], double b[], double c[], int n);
+  void update_node_properties(double T_2[], int n);
+  void fda_heat_eqn(double T_2[], double res[], int n);
+  void heat_eqn_jacobian(double T_2[], double a[], double b[], double c[], int n);
 
   double deltat;
   int FS_ACTIVE;
@@ -50,6 +51,21 @@ private:
   // defined here
   double Ts;
   double Tb;
+
+  // node properties at the current iterate, set by update_node_properties() and shared
+  // by the residual (fda_heat_eqn) and the Jacobian (heat_eqn_jacobian)
+  double ice_new[MAX_NODES];
+  double kappa_new[MAX_NODES];
+  double Cs_new[MAX_NODES];
+  double dice_dT[MAX_NODES];    // derivatives with respect to the temperature of the node
+  double dkappa_dT[MAX_NODES];
+  double dCs_dT[MAX_NODES];
+  // terms of the residual which the Jacobian reuses
+  double DT[MAX_NODES];
+  double DT_up[MAX_NODES];
+  double DT_down[MAX_NODES];
+  double Dkappa[MAX_NODES];
+  bool   coldNose[MAX_NODES];   // flux_term1 was reset to zero
 };
 
 
@@ -295,6 +295,12 @@ OutputData *create_output_list(const ProgramState* state) {
   out_data[OUT_GLAC_INFLOW_BAND].varname =  "OUT_GLAC_INFLOW_BAND";        /* glacier water inflow from snow melt, ice melt and rainfall [mm] */
   out_data[OUT_GLAC_OUTFLOW_BAND].varname =  "OUT_GLAC_OUTFLOW_BAND";      /* glacier water outflow [mm] */
 
+  // Solver Diagnostics
+  out_data[OUT_SOLVER_CALLS].varname = "OUT_SOLVER_CALLS";                 /* number of solver calls */
+  out_data[OUT_SOLVER_ITER].varname = "OUT_SOLVER_ITER";                   /* number of solver iterations */
+  out_data[OUT_SOLVER_FAIL].varname = "OUT_SOLVER_FAIL";                   /* number of failed solver calls */
+  out_data[OUT_SOLVER_TIME].varname = "OUT_SOLVER_TIME";                   /* wall time spent in the solver [s] */
+
   // Set number of elements - default is 1
   for (v=0; v<N_OUTVAR_TYPES; v++) {
     out_data[v].nelem = 1;
@@ -353,6 +359,10 @@ OutputData *create_output_list(const ProgramState* state) {
   out_data[OUT_GLAC_SUB_BAND].nelem = state->options.SNOW_BAND;
   out_data[OUT_GLAC_INFLOW_BAND].nelem = state->options.SNOW_BAND;
   out_data[OUT_GLAC_OUTFLOW_BAND].nelem = state->options.SNOW_BAND;
+  out_data[OUT_SOLVER_CALLS].nelem = N_SOLVER_TYPES;
+  out_data[OUT_SOLVER_ITER].nelem = N_SOLVER_TYPES;
+  out_data[OUT_SOLVER_FAIL].nelem = N_SOLVER_TYPES;
+  out_data[OUT_SOLVER_TIME].nelem = N_SOLVER_TYPES;
 
   // Set aggregation method - default is to average over the interval
   for (v=0; v<N_OUTVAR_TYPES; v++) {
@@ -481,6 +491,10 @@ OutputData *create_output_list(const ProgramState* state) {
   out_data[OUT_GLAC_SUB_BAND].aggtype = AGG_TYPE_SUM;
   out_data[OUT_GLAC_INFLOW_BAND].aggtype = AGG_TYPE_SUM;
   out_data[OUT_GLAC_OUTFLOW_BAND].aggtype = AGG_TYPE_SUM;
+  out_data[OUT_SOLVER_CALLS].aggtype = AGG_TYPE_SUM;
+  out_data[OUT_SOLVER_ITER].aggtype = AGG_TYPE_SUM;
+  out_data[OUT_SOLVER_FAIL].aggtype = AGG_TYPE_SUM;
+  out_data[OUT_SOLVER_TIME].aggtype = AGG_TYPE_SUM;
 
   // Allocate space for data
   for (v=0; v<N_OUTVAR_TYPES; v++) {
@@ -583,6 +597,41 @@ int set_output_var(out_data_file_struct *out_data_files,
 }
 
 
+void ProgramState::build_output_plan(const out_data_file_struct *out_data_files) {
+/*************************************************************
+  build_output_plan()
+
+  This routine finds the output variables that put_data() needs to
+  aggregate: those written to the output files, and those that the
+  aggregated values of written variables are derived from.
+
+*************************************************************/
+  outvar_active.assign(N_OUTVAR_TYPES, false);
+  for (int filenum = 0; filenum < options.Noutfiles; filenum++) {
+    for (int varnum = 0; varnum < out_data_files[filenum].nvars; varnum++) {
+      outvar_active[out_data_files[filenum].varid[varnum]] = true;
+    }
+  }
+
+  // Aggregated resistances are the inverse of the aggregated conductances
+  if (outvar_active[OUT_AERO_RESIST]) outvar_active[OUT_AERO_COND] = true;
+  if (outvar_active[OUT_AERO_RESIST1]) outvar_active[OUT_AERO_COND1] = true;
+  if (outvar_active[OUT_AERO_RESIST2]) outvar_active[OUT_AERO_COND2] = true;
+  // ALMA sublimation from the snow pack includes sublimation from the canopy
+  if (options.ALMA_OUTPUT && outvar_active[OUT_SUB_SNOW]) outvar_active[OUT_SUB_CANOP] = true;
+
+  active_outvars.clear();
+  output_band_terms = false;
+  for (int varid = 0; varid < N_OUTVAR_TYPES; varid++) {
+    if (outvar_active[varid]) {
+      active_outvars.push_back(varid);
+      if ((varid >= OUT_ADV_SENS_BAND && varid <= OUT_SWE_BAND) || (varid >= OUT_GLAC_DELTACC_BAND && varid <= OUT_GLAC_OUTFLOW_BAND)) {
+        output_band_terms = true;
+      }
+    }
+  }
+}
+
 void zero_output_list(OutputData *out_data) {
 /*************************************************************
   zero_output_list()      Ted Bohn     September 08, 2006
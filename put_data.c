@@ -192,7 +192,7 @@ int  put_data(cell_info_struct  *cell,
     if (state->veg_lib[hru->veg_con.vegIndex].overstory) {
       if (state->options.LAKES && hru->veg_con.LAKE) {
         // Fraction of tile that is flooded
-        Clake = cell->prcp.lake_var.sarea / cell->lake_con.basin[0];
+        Clake = cell->prcp.lake_var->sarea / cell->lake_con.basin[0];
         bandCv[hru->bandIndex] += hru->veg_con.Cv * (1 - Clake);
       } else {
         bandCv[hru->bandIndex] += hru->veg_con.Cv;
@@ -224,28 +224,29 @@ int  put_data(cell_info_struct  *cell,
   /* MPN */
   // Set output versions of input forcings
   if (rec >= 0) {
-    out_data[OUT_AIR_TEMP].data[0] = cell->atmos[rec].air_temp[state->NR];
-    out_data[OUT_DENSITY].data[0] = cell->atmos[rec].density[state->NR];
-    out_data[OUT_LONGWAVE].data[0] = cell->atmos[rec].longwave[state->NR];
-    out_data[OUT_PREC].data[0] = cell->atmos[rec].out_prec; // mm over grid cell
-    out_data[OUT_PRESSURE].data[0] = cell->atmos[rec].pressure[state->NR]
+    const atmos_data_struct& atmos = cell->atmos[rec - cell->atmos_first_rec];
+    out_data[OUT_AIR_TEMP].data[0] = atmos.air_temp[state->NR];
+    out_data[OUT_DENSITY].data[0] = atmos.density[state->NR];
+    out_data[OUT_LONGWAVE].data[0] = atmos.longwave[state->NR];
+    out_data[OUT_PREC].data[0] = atmos.out_prec; // mm over grid cell
+    out_data[OUT_PRESSURE].data[0] = atmos.pressure[state->NR]
         / kPa2Pa;
-    out_data[OUT_QAIR].data[0] = EPS * cell->atmos[rec].vp[state->NR]
-        / cell->atmos[rec].pressure[state->NR];
-    out_data[OUT_RAINF].data[0] = cell->atmos[rec].out_rain; // mm over grid cell
-    out_data[OUT_REL_HUMID].data[0] = 100. * cell->atmos[rec].vp[state->NR]
-        / (cell->atmos[rec].vp[state->NR] + cell->atmos[rec].vpd[state->NR]);
+    out_data[OUT_QAIR].data[0] = EPS * atmos.vp[state->NR]
+        / atmos.pressure[state->NR];
+    out_data[OUT_RAINF].data[0] = atmos.out_rain; // mm over grid cell
+    out_data[OUT_REL_HUMID].data[0] = 100. * atmos.vp[state->NR]
+        / (atmos.vp[state->NR] + atmos.vpd[state->NR]);
     if (state->options.LAKES && cell->lake_con.Cl[0] > 0)
       out_data[OUT_LAKE_CHAN_IN].data[0] =
-          cell->atmos[rec].channel_in[state->NR]; // mm over grid cell
+          atmos.channel_in[state->NR]; // mm over grid cell
     else
       out_data[OUT_LAKE_CHAN_IN].data[0] = 0;
-    out_data[OUT_SHORTWAVE].data[0] = cell->atmos[rec].shortwave[state->NR];
-    out_data[OUT_SNOWF].data[0] = cell->atmos[rec].out_snow; // mm over grid cell
-    out_data[OUT_TSKC].data[0] = cell->atmos[rec].tskc[state->NR];
-    out_data[OUT_VP].data[0] = cell->atmos[rec].vp[state->NR] / kPa2Pa;
-    out_data[OUT_VPD].data[0] = cell->atmos[rec].vpd[state->NR] / kPa2Pa;
-    out_data[OUT_WIND].data[0] = cell->atmos[rec].wind[state->NR];
+    out_data[OUT_SHORTWAVE].data[0] = atmos.shortwave[state->NR];
+    out_data[OUT_SNOWF].data[0] = atmos.out_snow; // mm over grid cell
+    out_data[OUT_TSKC].data[0] = atmos.tskc[state->NR];
+    out_data[OUT_VP].data[0] = atmos.vp[state->NR] / kPa2Pa;
+    out_data[OUT_VPD].data[0] = atmos.vpd[state->NR] / kPa2Pa;
+    out_data[OUT_WIND].data[0] = atmos.wind[state->NR];
   }
   
   // Store cell properties
@@ -258,7 +259,8 @@ int  put_data(cell_info_struct  *cell,
   /****************************************
    Store Output for all Vegetation Types (except lakes)
    ****************************************/
-  for (std::vector<HRU>::iterator hru = cell->prcp.hruList.begin(); hru != cell->prcp.hruList.end(); ++hru) {
+  for (std::vector<int>::const_iterator active = cell->prcp.activeHRUs.begin(); active != cell->prcp.activeHRUs.end(); ++active) {
+    HRU* hru = &cell->prcp.hruList[*active];
 
     Cv = hru->veg_con.Cv;
     Clake = 0;
@@ -276,7 +278,7 @@ int  put_data(cell_info_struct  *cell,
 
       // Check if this is lake/wetland tile
       if (state->options.LAKES && hru->veg_con.LAKE) {
-        Clake = cell->prcp.lake_var.sarea/cell->lake_con.basin[0];
+        Clake = cell->prcp.lake_var->sarea/cell->lake_con.basin[0];
         Nbands = 1;
         IsWet = true;
       }
@@ -326,7 +328,6 @@ int  put_data(cell_info_struct  *cell,
                              hru->veg_var[dist],
                              hru->snow,
                              hru->glacier,
-                             cell->prcp.lake_var,
                              precipitation_mu,
                              Cv,
                              ThisTreeAdjust,
@@ -384,30 +385,29 @@ int  put_data(cell_info_struct  *cell,
             // Note: doing this for eb terms will lead to reporting of eb errors 
             // this should be fixed when we implement full thermal solution beneath lake
           for (int i = 0; i < MAX_FRONTS; i++) {
-            cell->prcp.lake_var.energy.fdepth[i] = hru->energy.fdepth[i];
-            cell->prcp.lake_var.energy.tdepth[i] = hru->energy.fdepth[i];
+            cell->prcp.lake_var->energy.fdepth[i] = hru->energy.fdepth[i];
+            cell->prcp.lake_var->energy.tdepth[i] = hru->energy.fdepth[i];
           }
           for (int i = 0; i < state->options.Nnode; i++) {
-            cell->prcp.lake_var.energy.ice_content[i] = hru->energy.ice_content[i];
-            cell->prcp.lake_var.energy.T[i] = hru->energy.T[i];
+            cell->prcp.lake_var->energy.ice_content[i] = hru->energy.ice_content[i];
+            cell->prcp.lake_var->energy.T[i] = hru->energy.T[i];
           }
           for (int i = 0; i < N_PET_TYPES; i++) {
-            cell->prcp.lake_var.soil.pot_evap[i] = hru->cell[WET].pot_evap[i];
+            cell->prcp.lake_var->soil.pot_evap[i] = hru->cell[WET].pot_evap[i];
           }
-          cell->prcp.lake_var.soil.rootmoist = hru->cell[WET].rootmoist;
-          cell->prcp.lake_var.energy.deltaH = hru->energy.deltaH;
-          cell->prcp.lake_var.energy.fusion = hru->energy.fusion;
-          cell->prcp.lake_var.energy.grnd_flux = hru->energy.grnd_flux;
+          cell->prcp.lake_var->soil.rootmoist = hru->cell[WET].rootmoist;
+          cell->prcp.lake_var->energy.deltaH = hru->energy.deltaH;
+          cell->prcp.lake_var->energy.fusion = hru->energy.fusion;
+          cell->prcp.lake_var->energy.grnd_flux = hru->energy.grnd_flux;
 
           glac_data_struct invalidGlacier;  // Placeholder with internal variables initialized to INVALID by default.
           /*********************************
            Record Water Balance Terms
            *********************************/
-            collect_wb_terms(cell->prcp.lake_var.soil,
+            collect_wb_terms(cell->prcp.lake_var->soil,
                              hru->veg_var[WET],
-                             cell->prcp.lake_var.snow,
+                             cell->prcp.lake_var->snow,
                              invalidGlacier,
-                             cell->prcp.lake_var,
                              1.0,
                              Cv,
                              ThisTreeAdjust,
@@ -423,10 +423,10 @@ int  put_data(cell_info_struct  *cell,
           /**********************************
            Record Energy Balance Terms
            **********************************/
-            collect_eb_terms(cell->prcp.lake_var.energy,
-                             cell->prcp.lake_var.snow,
+            collect_eb_terms(cell->prcp.lake_var->energy,
+                             cell->prcp.lake_var->snow,
                              invalidGlacier,
-                             cell->prcp.lake_var.soil,
+                             cell->prcp.lake_var->soil,
                              &(cell->fallBackStats),
                              Cv,
                              ThisAreaFract,
@@ -446,12 +446,12 @@ int  put_data(cell_info_struct  *cell,
             // Store Lake-Specific Variables
             //TODO: move this lake stuff outside of the for loop since it doesn't depend on veg or band (for improved efficiency)
             // Lake ice
-            if (cell->prcp.lake_var.new_ice_area > 0.0) {
-              out_data[OUT_LAKE_ICE].data[0]   = (cell->prcp.lake_var.ice_water_eq/cell->prcp.lake_var.new_ice_area) * ice_density / RHO_W;
-              out_data[OUT_LAKE_ICE_TEMP].data[0]   = cell->prcp.lake_var.tempi;
-              out_data[OUT_LAKE_ICE_HEIGHT].data[0] = cell->prcp.lake_var.hice;
-              out_data[OUT_LAKE_SWE].data[0] = cell->prcp.lake_var.swe/cell->prcp.lake_var.areai; // m over lake ice
-              out_data[OUT_LAKE_SWE_V].data[0] = cell->prcp.lake_var.swe; // m3
+            if (cell->prcp.lake_var->new_ice_area > 0.0) {
+              out_data[OUT_LAKE_ICE].data[0]   = (cell->prcp.lake_var->ice_water_eq/cell->prcp.lake_var->new_ice_area) * ice_density / RHO_W;
+              out_data[OUT_LAKE_ICE_TEMP].data[0]   = cell->prcp.lake_var->tempi;
+              out_data[OUT_LAKE_ICE_HEIGHT].data[0] = cell->prcp.lake_var->hice;
+              out_data[OUT_LAKE_SWE].data[0] = cell->prcp.lake_var->swe/cell->prcp.lake_var->areai; // m over lake ice
+              out_data[OUT_LAKE_SWE_V].data[0] = cell->prcp.lake_var->swe; // m3
             }
             else {
               out_data[OUT_LAKE_ICE].data[0]   = 0.0;
@@ -460,26 +460,26 @@ int  put_data(cell_info_struct  *cell,
               out_data[OUT_LAKE_SWE].data[0]   = 0.0;
               out_data[OUT_LAKE_SWE_V].data[0]   = 0.0;
             }
-            out_data[OUT_LAKE_DSWE_V].data[0] = cell->prcp.lake_var.swe - cell->prcp.lake_var.swe_save; // m3
-            out_data[OUT_LAKE_DSWE].data[0] = (cell->prcp.lake_var.swe - cell->prcp.lake_var.swe_save)*1000/cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_DSWE_V].data[0] = cell->prcp.lake_var->swe - cell->prcp.lake_var->swe_save; // m3
+            out_data[OUT_LAKE_DSWE].data[0] = (cell->prcp.lake_var->swe - cell->prcp.lake_var->swe_save)*1000/cell->soil_con.cell_area; // mm over gridcell
 
           // Lake dimensions
           out_data[OUT_LAKE_AREA_FRAC].data[0] = Cv * Clake;
-          out_data[OUT_LAKE_DEPTH].data[0] = cell->prcp.lake_var.ldepth;
-          out_data[OUT_LAKE_SURF_AREA].data[0] = cell->prcp.lake_var.sarea;
+          out_data[OUT_LAKE_DEPTH].data[0] = cell->prcp.lake_var->ldepth;
+          out_data[OUT_LAKE_SURF_AREA].data[0] = cell->prcp.lake_var->sarea;
           if (out_data[OUT_LAKE_SURF_AREA].data[0] > 0)
-            out_data[OUT_LAKE_ICE_FRACT].data[0] = cell->prcp.lake_var.new_ice_area / out_data[OUT_LAKE_SURF_AREA].data[0];
+            out_data[OUT_LAKE_ICE_FRACT].data[0] = cell->prcp.lake_var->new_ice_area / out_data[OUT_LAKE_SURF_AREA].data[0];
           else
             out_data[OUT_LAKE_ICE_FRACT].data[0] = 0.;
-          out_data[OUT_LAKE_VOLUME].data[0] = cell->prcp.lake_var.volume;
-          out_data[OUT_LAKE_DSTOR_V].data[0] = cell->prcp.lake_var.volume - cell->prcp.lake_var.volume_save;
-          out_data[OUT_LAKE_DSTOR].data[0] = (cell->prcp.lake_var.volume - cell->prcp.lake_var.volume_save)*1000/cell->soil_con.cell_area; // mm over gridcell
+          out_data[OUT_LAKE_VOLUME].data[0] = cell->prcp.lake_var->volume;
+          out_data[OUT_LAKE_DSTOR_V].data[0] = cell->prcp.lake_var->volume - cell->prcp.lake_var->volume_save;
+          out_data[OUT_LAKE_DSTOR].data[0] = (cell->prcp.lake_var->volume - cell->prcp.lake_var->volume_save)*1000/cell->soil_con.cell_area; // mm over gridcell
 
             // Other lake characteristics
-            out_data[OUT_LAKE_SURF_TEMP].data[0]  = cell->prcp.lake_var.temp[0];
+            out_data[OUT_LAKE_SURF_TEMP].data[0]  = cell->prcp.lake_var->temp[0];
             if (out_data[OUT_LAKE_SURF_AREA].data[0] > 0) {
-              out_data[OUT_LAKE_MOIST].data[0]      = (cell->prcp.lake_var.volume / cell->soil_con.cell_area) * 1000.; // mm over gridcell
-              out_data[OUT_SURFSTOR].data[0]        = (cell->prcp.lake_var.volume / cell->soil_con.cell_area) * 1000.; // same as OUT_LAKE_MOIST
+              out_data[OUT_LAKE_MOIST].data[0]      = (cell->prcp.lake_var->volume / cell->soil_con.cell_area) * 1000.; // mm over gridcell
+              out_data[OUT_SURFSTOR].data[0]        = (cell->prcp.lake_var->volume / cell->soil_con.cell_area) * 1000.; // same as OUT_LAKE_MOIST
             }
             else {
               out_data[OUT_LAKE_MOIST].data[0] = 0;
@@ -487,22 +487,22 @@ int  put_data(cell_info_struct  *cell,
             }
 
             // Lake moisture fluxes
-            out_data[OUT_LAKE_BF_IN_V].data[0] = cell->prcp.lake_var.baseflow_in; // m3
-            out_data[OUT_LAKE_BF_OUT_V].data[0] = cell->prcp.lake_var.baseflow_out; // m3
-            out_data[OUT_LAKE_CHAN_IN_V].data[0] = cell->prcp.lake_var.channel_in; // m3
-            out_data[OUT_LAKE_CHAN_OUT_V].data[0] = cell->prcp.lake_var.runoff_out; // m3
-            out_data[OUT_LAKE_EVAP_V].data[0] = cell->prcp.lake_var.evapw; // m3
-            out_data[OUT_LAKE_PREC_V].data[0] = cell->prcp.lake_var.prec; // m3
-            out_data[OUT_LAKE_RCHRG_V].data[0] = cell->prcp.lake_var.recharge; // m3
-            out_data[OUT_LAKE_RO_IN_V].data[0] = cell->prcp.lake_var.runoff_in; // m3
-            out_data[OUT_LAKE_VAPFLX_V].data[0] = cell->prcp.lake_var.vapor_flux; // m3
-            out_data[OUT_LAKE_BF_IN].data[0] = cell->prcp.lake_var.baseflow_in*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_BF_OUT].data[0] = cell->prcp.lake_var.baseflow_out*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_CHAN_OUT].data[0] = cell->prcp.lake_var.runoff_out*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_EVAP].data[0] = cell->prcp.lake_var.evapw*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_RCHRG].data[0] = cell->prcp.lake_var.recharge*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_RO_IN].data[0] = cell->prcp.lake_var.runoff_in*1000./cell->soil_con.cell_area; // mm over gridcell
-            out_data[OUT_LAKE_VAPFLX].data[0] = cell->prcp.lake_var.vapor_flux*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_BF_IN_V].data[0] = cell->prcp.lake_var->baseflow_in; // m3
+            out_data[OUT_LAKE_BF_OUT_V].data[0] = cell->prcp.lake_var->baseflow_out; // m3
+            out_data[OUT_LAKE_CHAN_IN_V].data[0] = cell->prcp.lake_var->channel_in; // m3
+            out_data[OUT_LAKE_CHAN_OUT_V].data[0] = cell->prcp.lake_var->runoff_out; // m3
+            out_data[OUT_LAKE_EVAP_V].data[0] = cell->prcp.lake_var->evapw; // m3
+            out_data[OUT_LAKE_PREC_V].data[0] = cell->prcp.lake_var->prec; // m3
+            out_data[OUT_LAKE_RCHRG_V].data[0] = cell->prcp.lake_var->recharge; // m3
+            out_data[OUT_LAKE_RO_IN_V].data[0] = cell->prcp.lake_var->runoff_in; // m3
+            out_data[OUT_LAKE_VAPFLX_V].data[0] = cell->prcp.lake_var->vapor_flux; // m3
+            out_data[OUT_LAKE_BF_IN].data[0] = cell->prcp.lake_var->baseflow_in*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_BF_OUT].data[0] = cell->prcp.lake_var->baseflow_out*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_CHAN_OUT].data[0] = cell->prcp.lake_var->runoff_out*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_EVAP].data[0] = cell->prcp.lake_var->evapw*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_RCHRG].data[0] = cell->prcp.lake_var->recharge*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_RO_IN].data[0] = cell->prcp.lake_var->runoff_in*1000./cell->soil_con.cell_area; // mm over gridcell
+            out_data[OUT_LAKE_VAPFLX].data[0] = cell->prcp.lake_var->vapor_flux*1000./cell->soil_con.cell_area; // mm over gridcell
 
           } // End if options.LAKES etc.
 
@@ -549,26 +549,34 @@ int  put_data(cell_info_struct  *cell,
   }
 
   // Radiative temperature
-  out_data[OUT_RAD_TEMP].data[0] = pow(out_data[OUT_RAD_TEMP].data[0],0.25);
+  if (state->outvar_active[OUT_RAD_TEMP]) {
+    out_data[OUT_RAD_TEMP].data[0] = pow(out_data[OUT_RAD_TEMP].data[0],0.25);
+  }
 
   // Aerodynamic conductance and resistance
-  if (out_data[OUT_AERO_COND1].data[0] > SMALL) {
-    out_data[OUT_AERO_RESIST1].data[0] = 1 / out_data[OUT_AERO_COND1].data[0];
-  }
-  else {
-    out_data[OUT_AERO_RESIST1].data[0] = HUGE_RESIST;
-  }
-  if (out_data[OUT_AERO_COND2].data[0] > SMALL) {
-    out_data[OUT_AERO_RESIST2].data[0] = 1 / out_data[OUT_AERO_COND2].data[0];
-  }
-  else {
-    out_data[OUT_AERO_RESIST2].data[0] = HUGE_RESIST;
+  if (state->outvar_active[OUT_AERO_RESIST1]) {
+    if (out_data[OUT_AERO_COND1].data[0] > SMALL) {
+      out_data[OUT_AERO_RESIST1].data[0] = 1 / out_data[OUT_AERO_COND1].data[0];
+    }
+    else {
+      out_data[OUT_AERO_RESIST1].data[0] = HUGE_RESIST;
+    }
   }
-  if (out_data[OUT_AERO_COND].data[0] > SMALL) {
-    out_data[OUT_AERO_RESIST].data[0] = 1 / out_data[OUT_AERO_COND].data[0];
+  if (state->outvar_active[OUT_AERO_RESIST2]) {
+    if (out_data[OUT_AERO_COND2].data[0] > SMALL) {
+      out_data[OUT_AERO_RESIST2].data[0] = 1 / out_data[OUT_AERO_COND2].data[0];
+    }
+    else {
+      out_data[OUT_AERO_RESIST2].data[0] = HUGE_RESIST;
+    }
   }
-  else {
-    out_data[OUT_AERO_RESIST].data[0] = HUGE_RESIST;
+  if (state->outvar_active[OUT_AERO_RESIST]) {
+    if (out_data[OUT_AERO_COND].data[0] > SMALL) {
+      out_data[OUT_AERO_RESIST].data[0] = 1 / out_data[OUT_AERO_COND].data[0];
+    }
+    else {
+      out_data[OUT_AERO_RESIST].data[0] = HUGE_RESIST;
+    }
   }
 
   /*****************************************
@@ -581,8 +589,10 @@ int  put_data(cell_info_struct  *cell,
 	out_data[OUT_SOIL_ICE_TOT].data[0] += out_data[OUT_SOIL_ICE].data[index];
 	out_data[OUT_SOIL_MOIST].data[index] = out_data[OUT_SOIL_LIQ].data[index]+out_data[OUT_SOIL_ICE].data[index];
     out_data[OUT_DELSOILMOIST].data[0] += out_data[OUT_SOIL_MOIST].data[index];
-    out_data[OUT_SMLIQFRAC].data[index] = out_data[OUT_SOIL_LIQ].data[index]/out_data[OUT_SOIL_MOIST].data[index];
-    out_data[OUT_SMFROZFRAC].data[index] = 1 - out_data[OUT_SMLIQFRAC].data[index];
+    if (state->outvar_active[OUT_SMLIQFRAC] || state->outvar_active[OUT_SMFROZFRAC]) {
+      out_data[OUT_SMLIQFRAC].data[index] = out_data[OUT_SOIL_LIQ].data[index]/out_data[OUT_SOIL_MOIST].data[index];
+      out_data[OUT_SMFROZFRAC].data[index] = 1 - out_data[OUT_SMLIQFRAC].data[index];
+    }
   }
   if (rec >= 0) {
     out_data[OUT_DELSOILMOIST].data[0] -= cell->save_data.total_soil_moist;
@@ -642,6 +652,19 @@ int  put_data(cell_info_struct  *cell,
 
 
 
+  /********************
+    Collect the solver counts of this time step (see SolverStats::current)
+  ********************/
+  const SolverStats& stepSolverStats = SolverStats::current;
+  for (int type = 0; type < N_SOLVER_TYPES; type++) {
+    out_data[OUT_SOLVER_CALLS].data[type] = stepSolverStats.counters[type].calls;
+    out_data[OUT_SOLVER_ITER].data[type] = stepSolverStats.counters[type].iterations;
+    out_data[OUT_SOLVER_FAIL].data[type] = stepSolverStats.counters[type].failures;
+    out_data[OUT_SOLVER_TIME].data[type] = stepSolverStats.counters[type].seconds;
+  }
+  cell->solverStats.add(stepSolverStats);
+  SolverStats::current.reset();
+
   /********************
     Report T Fallback Occurrences
   ********************/
@@ -656,8 +679,10 @@ int  put_data(cell_info_struct  *cell,
 
   /********************
     Temporal Aggregation 
+    (only of the variables in the output plan, see ProgramState::build_output_plan())
     ********************/
-  for (int v=0; v<N_OUTVAR_TYPES; v++) {
+  for (std::vector<int>::const_iterator it = state->active_outvars.begin(); it != state->active_outvars.end(); ++it) {
+    const int v = *it;
     if (out_data[v].aggtype == AGG_TYPE_END) {
       for (int i=0; i<out_data[v].nelem; i++) {
         out_data[v].aggdata[i] = out_data[v].data[i];
@@ -674,9 +699,12 @@ int  put_data(cell_info_struct  *cell,
       }
     }
   }
-  out_data[OUT_AERO_RESIST].aggdata[0] = 1/out_data[OUT_AERO_COND].aggdata[0];
-  out_data[OUT_AERO_RESIST1].aggdata[0] = 1/out_data[OUT_AERO_COND1].aggdata[0];
-  out_data[OUT_AERO_RESIST2].aggdata[0] = 1/out_data[OUT_AERO_COND2].aggdata[0];
+  if (state->outvar_active[OUT_AERO_RESIST])
+    out_data[OUT_AERO_RESIST].aggdata[0] = 1/out_data[OUT_AERO_COND].aggdata[0];
+  if (state->outvar_active[OUT_AERO_RESIST1])
+    out_data[OUT_AERO_RESIST1].aggdata[0] = 1/out_data[OUT_AERO_COND1].aggdata[0];
+  if (state->outvar_active[OUT_AERO_RESIST2])
+    out_data[OUT_AERO_RESIST2].aggdata[0] = 1/out_data[OUT_AERO_COND2].aggdata[0];
   
   
 
@@ -684,7 +712,7 @@ int  put_data(cell_info_struct  *cell,
     Output procedure
     (only execute when we've completed an output interval)
   ********************/
-  if (state->step_count == out_step_ratio) {
+  if ((rec + 1) % out_step_ratio == 0) {
 
     /***********************************************
       Change of units for ALMA-compliant output
@@ -762,7 +790,6 @@ void collect_wb_terms(const hru_data_struct&  cell,
                       const veg_var_struct&    veg_var,
                       const snow_data_struct&  snow,
                       const glac_data_struct& glacier,
-                      const lake_var_struct&   lake_var,
                       double            precipitation_mu,
                       double            Cv,
                       double            TreeAdjustFactor,
@@ -1148,6 +1175,10 @@ void collect_eb_terms(const energy_bal_struct& energy,
   if (AreaFract == 0) {
     throw VICException("Error: AreaFract is zero! cannot divide by 0 (put_data.c)");
   }
+  // Skipped unless a band-specific variable is written to the output files.
+  if (!state->output_band_terms) {
+    return;
+  }
   double bandFactor = Cv * lakefactor / AreaFract;
 
   /** record band snow water equivalent **/
@@ -6,7 +6,7 @@
 static char vcid[] = "$Id$";
 
 double **read_forcing_data(FILE                **infile,
-                           int                  *ncids,
+                           NetCDFForcingReader **forcing_readers,
 			   global_param_struct   global_param,
                            soil_con_struct      *soil_con,
                            const ProgramState   *state)
@@ -33,7 +33,7 @@ double **read_forcing_data(FILE                **infile,
 
   /** Read First Forcing Data File **/
   if(IS_VALID(state->param_set.FORCE_DT[0]) && state->param_set.FORCE_DT[0] > 0) {
-    read_atmos_data(infile[0], ncids[0], 0, global_param.forceskip[0],
+    read_atmos_data(infile[0], forcing_readers[0], 0, global_param.forceskip[0], &global_param,
 		    forcing_data, soil_con, state);
   }
   else {
@@ -43,7 +43,7 @@ double **read_forcing_data(FILE                **infile,
 
   /** Read Second Forcing Data File **/
   if(IS_VALID(state->param_set.FORCE_DT[1]) && state->param_set.FORCE_DT[1] > 0) {
-    read_atmos_data(infile[1], ncids[1], 1, global_param.forceskip[1],
+    read_atmos_data(infile[1], forcing_readers[1], 1, global_param.forceskip[1], &global_param,
 		    forcing_data, soil_con, state);
   }
 
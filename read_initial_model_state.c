@@ -143,9 +143,9 @@ void read_initial_model_state(const char* initStateFilename, cell_info_struct *c
       element->snow.depth = 1000. * element->snow.swq / element->snow.density;
   }
 
-  if (state->options.LAKES == TRUE) {
-    if (cell->prcp.lake_var.snow.density > 0.)
-      cell->prcp.lake_var.snow.depth = 1000. * cell->prcp.lake_var.snow.swq / cell->prcp.lake_var.snow.density;
+  if (cell->prcp.lake_var != NULL) {
+    if (cell->prcp.lake_var->snow.density > 0.)
+      cell->prcp.lake_var->snow.depth = 1000. * cell->prcp.lake_var->snow.swq / cell->prcp.lake_var->snow.density;
   }
 
 
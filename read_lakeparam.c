@@ -1,11 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "vicNl.h"
+#include "ParamFileIndex.h"
 #include <string.h>
 
 static char vcid[] = "$Id$";
 
 lake_con_struct read_lakeparam(FILE            *lakeparam, 
+			       const ParamFileIndex *lakeparam_index,
 			       soil_con_struct  soil_con, 
 			       std::vector<HRU>& hruList,
 			       const ProgramState* state)
@@ -78,26 +80,16 @@ lake_con_struct read_lakeparam(FILE            *lakeparam,
 
   lake_con_struct temp;
   
-#if !NO_REWIND
-  rewind(lakeparam);
-#endif // NO_REWIND
-    
   /*******************************************************************/
   /* Read in general lake parameters.                           */
   /******************************************************************/
 
-  fscanf(lakeparam, "%d", &lakecel);
-  while ( lakecel != soil_con.gridcel && !feof(lakeparam) ) {
-    fgets(tmpstr, MAXSTRING, lakeparam); // grid cell number, etc.
-    fgets(tmpstr, MAXSTRING, lakeparam); // lake depth-area relationship
-    fscanf(lakeparam, "%d", &lakecel);
-  }
-
   // cell number not found
-  if ( feof(lakeparam) ) {
+  if ( !lakeparam_index->seekToCell(soil_con.gridcel) ) {
     sprintf(tmpstr, "Unable to find cell %i in the lake parameter file, check the file or set NO_REWIND to FALSE", soil_con.gridcel);
     nrerror(tmpstr);
   }
+  fscanf(lakeparam, "%d", &lakecel);
 
   // read lake parameters from file
   fscanf(lakeparam, "%d", &temp.lake_idx);
@@ -1,11 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "vicNl.h"
+#include "ParamFileIndex.h"
 #include <string.h>
 
 static char vcid[] = "$Id$";
 
 void read_snowband(FILE    *snowband,
+		   const ParamFileIndex *snowband_index,
 		   soil_con_struct *soil_con,
 		   const int num_elevation_snow_bands)
 /**********************************************************************
@@ -38,22 +40,13 @@ void read_snowband(FILE    *snowband,
   if ( num_elevation_snow_bands > 1 ) {
 
     /** Find Current Grid Cell in SnowBand File **/
-#if !NO_REWIND
-    rewind(snowband);
-#endif
-
-    fscanf(snowband, "%d", &cell);
-    while ( cell != soil_con->gridcel && !feof(snowband) ) {
-      fgets(ErrStr,MAXSTRING,snowband);
-      fscanf(snowband, "%d", &cell);
-    }
-
-    if ( feof(snowband) ) {
+    if ( !snowband_index->seekToCell(soil_con->gridcel) ) {
       fprintf(stderr, "WARNING: Cannot find current gridcell (%i) in snow band file; setting cell to have one elevation band.\n",
               soil_con->gridcel);
       /** 1 band is the default; no action necessary **/
       return;
     }
+    fscanf(snowband, "%d", &cell);
 
     /** Read Area Fraction **/
     total = 0.;
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "vicNl.h"
+#include "ParamFileIndex.h"
 #include <string.h>
 #include <string>
 #include <sstream>
@@ -51,6 +52,7 @@ int getVegIndex(int vegClass, const ProgramState* state) {
 // MDF: changed return type to int so we can return numHRUs for main program to calculate the max # of HRUs across all cells,
 // used to allocate space for in the state file
 int read_vegparam(FILE *vegparam,
+                   const ParamFileIndex *vegparam_index,
                    cell_info_struct& cell,
                    const ProgramState* state)
 
@@ -95,7 +97,7 @@ int read_vegparam(FILE *vegparam,
   2010-Apr-28 Replaced GLOBAL_LAI with VEGPARAM_LAI and LAI_SRC.	TJB
 **********************************************************************/
 {
-  int             vegcel, numHRUs, skip;
+  int             vegcel, numHRUs;
   int             NoOverstory;
   char            str[500];
   char            ErrStr[MAXSTRING];
@@ -105,32 +107,14 @@ int read_vegparam(FILE *vegparam,
   char            *token;
   size_t	  length;
 
-  if(state->options.VEGPARAM_LAI) skip=2;
-  else skip=1;
-
   NoOverstory = 0;
 
-#if !NO_REWIND
-  rewind(vegparam);
-#endif  
-
-  while ( ( fscanf(vegparam, "%d %d", &vegcel, &numHRUs) == 2 ) && vegcel != cell.soil_con.gridcel ){
-    if (numHRUs < 0) {
-      sprintf(ErrStr,"ERROR number of vegetation tiles (%i) given for cell %i is < 0.\n",numHRUs,vegcel);
-      nrerror(ErrStr);
-    }
-    for (int i = 0; i <= numHRUs * skip; i++){
-      if ( fgets(str, 500, vegparam) == NULL ){
-        sprintf(ErrStr,"ERROR unexpected EOF for cell %i while reading root zones and LAI\n",vegcel);
-        nrerror(ErrStr);
-      }
-    }
-  }
-  fgets(str, 500, vegparam); // read newline at end of veg class line to advance to next line
-  if (vegcel != cell.soil_con.gridcel) {
+  if (!vegparam_index->seekToCell(cell.soil_con.gridcel)) {
     fprintf(stderr, "Error in vegetation file.  Grid cell %d not found\n", cell.soil_con.gridcel);
     exit(99);
   }
+  fscanf(vegparam, "%d %d", &vegcel, &numHRUs);
+  fgets(str, 500, vegparam); // read newline at end of veg class line to advance to next line
 
   cell.Cv_sum = 0.0;
 
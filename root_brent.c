@@ -34,6 +34,8 @@ static char vcid[] = "$Id$";
 #define MACHEPS 3e-8
 #define TSTEP   10
 #define T       1e-7   
+#define SECANT_MAXITER 20
+#define SECANT_DT      0.01  /* offset of the second starting point of the secant iteration (C) */
 
 /*****************************************************************************
   GENERAL DOCUMENTATION FOR THIS MODULE
@@ -95,6 +97,14 @@ static char vcid[] = "$Id$";
 	      yields garbage output from the target function.			TJB
 *****************************************************************************/
 double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorString)
+{
+  SolverCall call(solverType);
+  double root = brent(LowerBound, UpperBound, ErrorString);
+  if (resultIsError(root)) call.failure();
+  return root;
+}
+
+double RootBrent::brent(double LowerBound, double UpperBound, char* ErrorString)
 {
   const char *Routine = "RootBrent";
   double a;
@@ -120,8 +130,8 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
   /* initialize variable argument list */
   a = LowerBound;
   b = UpperBound;
-  fa = calculate(a);
-  fb = calculate(b);
+  fa = evaluate(a);
+  fb = evaluate(b);
  
   which_err = 0;
 
@@ -147,14 +157,14 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
     }
 
     c = 0.5*(last_bad+last_good);
-    fc = calculate(c);
+    fc = evaluate(c);
 
     /* search for valid point via bisection */
     j = 0;
     while (fc == ERROR && j < MAXITER) {
       last_bad = c;
       c = 0.5*(last_bad+last_good);
-      fc = calculate(c);
+      fc = evaluate(c);
       j++;
     }
 
@@ -185,13 +195,13 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
     if (which_err == 0) { // No undefined values were encountered
       a -= TSTEP;
       b += TSTEP;
-      fa = calculate(a);
-      fb = calculate(b);
+      fa = evaluate(a);
+      fb = evaluate(b);
     }
     else { // Undefined values were encountered
       if (which_err == -1) { // Undefined values encountered in the lower direction
         b += TSTEP;
-        fb = calculate(b);
+        fb = evaluate(b);
         if (fb == ERROR) {
           /* Undefined function values in both directions - give up */
           sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
@@ -201,7 +211,7 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
       }
       else { // Undefined values encountered in the upper direction
         a -= TSTEP;
-        fa = calculate(a);
+        fa = evaluate(a);
         if (fa == ERROR) {
           /* Undefined function values in both directions - give up */
           sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
@@ -212,12 +222,12 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
 
       /* search for valid point via bisection */
       c = 0.5*(last_good+last_bad);
-      fc = calculate(c);
+      fc = evaluate(c);
       i = 0;
       while (fc == ERROR && i < MAXITER) {
         last_bad = c;
         c = 0.5*(last_bad+last_good);
-        fc = calculate(c);
+        fc = evaluate(c);
         i++;
       }
 
@@ -320,7 +330,7 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
       a = b;
       fa = fb;
       b += (fabs(d) > tol) ? d : ((m > 0) ? tol : -tol);
-      fb = calculate(b);
+      fb = evaluate(b);
 
       // Catch ERROR values returned from Function
       if(fb == ERROR){
@@ -336,6 +346,116 @@ double RootBrent::root_brent(double LowerBound, double UpperBound, char* ErrorSt
 
 }
 
+/*****************************************************************************
+  Function name: root_warm_start()
+
+  Purpose      : Calculate the surface temperature, starting from a guess
+
+  Required     :
+    double Guess          - Starting point, usually the temperature of the
+                            previous time step or iteration
+    double LowerBound     - Lower bound for root
+    double UpperBound     - Upper bound for root
+    char *ErrorString     - For storing description of errors (if any)
+
+  Returns      :
+    double b              - Effective surface temperature (C)
+
+  Modifies     :
+    char *ErrorString     - Stores description of errors
+
+  Comments     :
+    Temperatures change little from one time step to the next, so a secant
+    iteration started from the previous temperature usually converges in a
+    few evaluations, where Brent's method spends several evaluations on
+    bracketing and bisecting from fixed bounds.  The iteration is kept inside
+    [LowerBound, UpperBound], and inside the bracket around the root once
+    one has been found (bisecting when a secant step leaves it).  If the
+    target function is undefined at an iterate, a secant step leaves the
+    bounds without a bracket, or the iteration does not converge within
+    SECANT_MAXITER evaluations, the root is found with Brent's method from
+    the original bounds, exactly as root_brent() would.
+*****************************************************************************/
+double RootBrent::root_warm_start(double Guess, double LowerBound, double UpperBound, char* ErrorString)
+{
+  double x0, x1, x2;
+  double f0, f1;
+  double a = 0, b = 0;      // bracket around the root, when bracketed
+  double fa = 0;
+  bool bracketed = false;
+  double tol;
+  int i;
+
+  SolverCall call(solverType);
+
+  x0 = Guess;
+  if (!(x0 >= LowerBound)) x0 = LowerBound;
+  if (!(x0 <= UpperBound)) x0 = UpperBound;
+  f0 = evaluate(x0);
+  if (f0 == ERROR) {
+    return fall_back(call, LowerBound, UpperBound, ErrorString);
+  }
+  if (f0 == 0) return x0;
+
+  x1 = (x0 + SECANT_DT <= UpperBound) ? x0 + SECANT_DT : x0 - SECANT_DT;
+
+  for (i = 0; i < SECANT_MAXITER; i++) {
+    f1 = evaluate(x1);
+    if (f1 == ERROR) break;
+    if (f1 == 0) return x1;
+
+    // Keep the tightest bracket around the root seen so far
+    if (bracketed) {
+      if (x1 > a && x1 < b) {
+        if ((f1 < 0) == (fa < 0)) {
+          a = x1;
+          fa = f1;
+        }
+        else {
+          b = x1;
+        }
+      }
+    }
+    else if (f0 * f1 < 0) {
+      a = (x0 < x1) ? x0 : x1;
+      fa = (x0 < x1) ? f0 : f1;
+      b = (x0 < x1) ? x1 : x0;
+      bracketed = true;
+    }
+
+    if (f1 == f0) break;
+    x2 = x1 - f1 * (x1 - x0) / (f1 - f0);
+
+    if (bracketed) {
+      if (!(x2 > a && x2 < b)) x2 = 0.5 * (a + b);
+    }
+    else if (!(x2 >= LowerBound && x2 <= UpperBound)) {
+      break;
+    }
+
+    tol = 2 * MACHEPS * fabs(x1) + T;
+    if (fabs(x2 - x1) <= tol || (bracketed && (b - a) <= 2 * tol)) {
+      return x2;
+    }
+
+    x0 = x1;
+    f0 = f1;
+    x1 = x2;
+  }
+
+  return fall_back(call, LowerBound, UpperBound, ErrorString);
+}
+
+double RootBrent::fall_back(SolverCall& call, double LowerBound, double UpperBound, char* ErrorString)
+{
+  call.fallback();
+  double root = brent(LowerBound, UpperBound, ErrorString);
+  if (resultIsError(root)) call.failure();
+  return root;
+}
+
+#undef SECANT_MAXITER
+#undef SECANT_DT
 #undef MAXTRIES
 #undef MAXITER
 #undef MACHEPS
@@ -1,15 +1,32 @@
-
 #ifndef ROOT_BRENT_H_
 #define ROOT_BRENT_H_
 
+#include "SolverStats.h"
+
 class RootBrent {
 public:
-  RootBrent() {}
+  // solverType selects the counters of SolverStats::current which this solver updates.
+  RootBrent(SolverType solverType) : solverType(solverType) {}
   virtual ~RootBrent() {}
   double root_brent(double LowerBound, double UpperBound, char* ErrorString);
+  // Starts from Guess (e.g. the temperature of the previous time step) with a safeguarded secant iteration,
+  // and falls back to root_brent(LowerBound, UpperBound) if that does not converge within the bounds.
+  double root_warm_start(double Guess, double LowerBound, double UpperBound, char* ErrorString);
+  // Calls root_warm_start() if warmStart (options.WARM_START) is set, root_brent() otherwise.
+  double solve(double Guess, double LowerBound, double UpperBound, char* ErrorString, bool warmStart) {
+    return warmStart ? root_warm_start(Guess, LowerBound, UpperBound, ErrorString) : root_brent(LowerBound, UpperBound, ErrorString);
+  }
   virtual double calculate(double) = 0;
   //if the result of any calculation is less than -998 (ie -999) then there is an error
   static bool resultIsError(double result) { return result <= -998; }
+private:
+  double brent(double LowerBound, double UpperBound, char* ErrorString);
+  double fall_back(SolverCall& call, double LowerBound, double UpperBound, char* ErrorString);
+  double evaluate(double x) {
+    SolverStats::current.counters[solverType].iterations++;
+    return calculate(x);
+  }
+  const SolverType solverType;
 };
 
 #endif /* ROOT_BRENT_H_ */
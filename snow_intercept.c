@@ -373,7 +373,8 @@ int snow_intercept(double  Dt,
         LatentHeatSub, LongOverOut, NetLongOver, &NetRadiation, &RefreezeEnergy,
         SensibleHeat, VaporMassFlux, state);
 
-    *Tfoliage = canopyEnergyBalance.root_brent(Tlower, Tupper, ErrorString);
+    *Tfoliage = canopyEnergyBalance.solve(*Tfoliage, Tlower, Tupper, ErrorString,
+        state->options.WARM_START);
     
     if (canopyEnergyBalance.resultIsError(*Tfoliage)) {
       if (state->options.TFALLBACK) {
@@ -229,9 +229,10 @@ int snow_melt_glac(double latent_heat_Le,
           &RefreezeEnergy, &sensible_heat, &snow->vapor_flux,
           &snow->blowing_flux, &snow->surface_flux);
 
-    snow->surf_temp = snowPackEnergyBalance.root_brent(
+    snow->surf_temp = snowPackEnergyBalance.solve(snow->surf_temp,
           (double) (snow->surf_temp - SNOW_DT),
-          (double) (snow->surf_temp + SNOW_DT), ErrorString);
+          (double) (snow->surf_temp + SNOW_DT), ErrorString,
+          state->options.WARM_START);
 
     if (snowPackEnergyBalance.resultIsError(snow->surf_temp)) {
       if (state->options.TFALLBACK) {
@@ -1,17 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include "vicNl.h"
 
 static char vcid[] = "$Id$";
 
-double soil_conductivity(double moist, 
-			 double Wu, 
-			 double soil_dens_min, 
-			 double bulk_dens_min,
-			 double quartz,
-			 double soil_density, 
-			 double bulk_density,
-			 double organic) {
+static double johansen_conductivity(double moist,
+				    double Wu,
+				    double soil_dens_min,
+				    double bulk_dens_min,
+				    double quartz,
+				    double soil_density,
+				    double bulk_density,
+				    double organic,
+				    double *dK_dWu) {
 /**********************************************************************
   Soil thermal conductivity calculated using Johansen's method.
 
@@ -40,6 +42,7 @@ double soil_conductivity(double moist,
   double organic       total soil organic content (fraction of total solid soil volume)
                          i.e., organic fraction of solid soil = organic*(1-porosity)
                                mineral fraction of solid soil = (1-organic)*(1-porosity)
+  double *dK_dWu       if not NULL, returns the derivative of K with respect to Wu
 
   Modifications:
 
@@ -62,6 +65,8 @@ double soil_conductivity(double moist,
   double K;
   double porosity;
 
+  if (dK_dWu != NULL) *dK_dWu = 0;
+
   /* Calculate dry conductivity as weighted average of mineral and organic fractions. */
   Kdry_min = (0.135*bulk_dens_min+64.7)/(soil_dens_min-0.947*bulk_dens_min);
   Kdry = (1-organic)*Kdry_min + organic*Kdry_org;
@@ -93,10 +98,15 @@ double soil_conductivity(double moist,
       Ksat = pow(Ks,1.0-porosity) * pow(Ki,porosity-Wu) * pow(Kw,Wu);
       Ke = Sr;
 
+      if (dK_dWu != NULL) *dK_dWu = Ke * Ksat * log(Kw/Ki);
+
     }
 
     K = (Ksat-Kdry)*Ke+Kdry;
-    if(K<Kdry) K=Kdry;
+    if(K<Kdry) {
+      K=Kdry;
+      if (dK_dWu != NULL) *dK_dWu = 0;
+    }
 
   }
   else K=Kdry;
@@ -104,6 +114,37 @@ double soil_conductivity(double moist,
   return (K);
 }
 
+double soil_conductivity(double moist,
+			 double Wu,
+			 double soil_dens_min,
+			 double bulk_dens_min,
+			 double quartz,
+			 double soil_density,
+			 double bulk_density,
+			 double organic) {
+  return johansen_conductivity(moist, Wu, soil_dens_min, bulk_dens_min, quartz,
+                               soil_density, bulk_density, organic, NULL);
+}
+
+/**********************************************************************
+  Derivative of soil_conductivity() with respect to the liquid water
+  content Wu, for the analytic Jacobian of the implicit soil temperature
+  solution.  Zero where the soil is unfrozen (Wu == moist).
+**********************************************************************/
+double soil_conductivity_dWu(double moist,
+			     double Wu,
+			     double soil_dens_min,
+			     double bulk_dens_min,
+			     double quartz,
+			     double soil_density,
+			     double bulk_density,
+			     double organic) {
+  double dK_dWu;
+  johansen_conductivity(moist, Wu, soil_dens_min, bulk_dens_min, quartz,
+                        soil_density, bulk_density, organic, &dK_dWu);
+  return (dK_dWu);
+}
+
 
 double volumetric_heat_capacity(double soil_fract,
                                 double water_fract,
@@ -152,7 +193,7 @@ void set_node_parameters(double   *dz_node,
 			 double   *expt,
 			 double   *bubble,
 			 double   *quartz,
-			 double ***ufwc_table_node,
+			 const UfwcTable **ufwc_table_node,
 			 double    *porosity,
 			 double    *effective_porosity,
 			 double    *porosity_node,
@@ -180,7 +221,7 @@ void set_node_parameters(double   *dz_node,
   double   *max_moist        soil moisture layer maximum moisture content (mm)
   double   *bubble           soil moisture layer bubbling pressure (cm)
   double    quartz           soil quartz content (fract)
-  double ***ufwc_table_node  table of unfrozen water contents ()
+  const UfwcTable **ufwc_table_node  table of unfrozen water contents (QUICK_FS)
   double   *porosity         soil layer porosity 
   double   *effective_porosity   effective soil layer porosity
   double   *porosity_node       thermal node porosity
@@ -209,18 +250,11 @@ void set_node_parameters(double   *dz_node,
   2009-Jul-31 Removed unused layer_node_fract array.			TJB
 **********************************************************************/
 
-#if QUICK_FS
-  extern const double temps[];
-#endif
-
   char   PAST_BOTTOM;
   int    nidx, lidx;
   double Lsum; /* cumulative depth of moisture layer */
   double Zsum; /* upper boundary of node thermal layer */
   double deltaL[MAX_LAYERS+1];
-  int    ii;
-  double Aufwc;
-  double Bufwc;
 
   PAST_BOTTOM = FALSE;
   lidx = 0;
@@ -275,28 +309,13 @@ void set_node_parameters(double   *dz_node,
   }
 
 
-#if QUICK_FS
-
-  /* If quick frozen soil solution activated, prepare a linearized
-     estimation on the maximum unfrozen water content equation */
-
-  if(FS_ACTIVE && state->options.FROZEN_SOIL) {
-    for(nidx=0;nidx<Nnodes;nidx++) { 
-      for(ii=0;ii<QUICK_FS_TEMPS;ii++) {
-	Aufwc = maximum_unfrozen_water(temps[ii], 1.0, 
-				       bubble_node[nidx], 
-				       expt_node[nidx]);
-	Bufwc = maximum_unfrozen_water(temps[ii+1], 1.0, 
-				       bubble_node[nidx], 
-				       expt_node[nidx]);
-	ufwc_table_node[nidx][ii][0] 
-	  = linear_interp(0., temps[ii], temps[ii+1], Aufwc, Bufwc);
-	ufwc_table_node[nidx][ii][1] 
-	  = (Bufwc - Aufwc) / (temps[ii+1] - temps[ii]);
-      }
-    }
+  /* If quick frozen soil solution activated, look up the linearized
+     estimation of the maximum unfrozen water content equation */
+
+  if(FS_ACTIVE && state->options.FROZEN_SOIL && state->options.QUICK_FS) {
+    for(nidx=0;nidx<Nnodes;nidx++)
+      ufwc_table_node[nidx] = UfwcTable::get(bubble_node[nidx], expt_node[nidx]);
   }
-#endif
 }
 
 #define N_INTS 5
@@ -392,18 +411,17 @@ int distribute_node_moisture_properties(energy_bal_struct* energy, const soil_co
 
     if(energy->T[nidx] < 0 && (soil_con->FS_ACTIVE && state->options.FROZEN_SOIL)) {
       /* compute moisture and ice contents */
-#if QUICK_FS
-      ice_node[nidx] 
-	= moist_node[nidx] - maximum_unfrozen_water_quick(T_node[nidx],
-						   max_moist_node[nidx], 
-						   ufwc_table_node[nidx]);
-#else
-      energy->ice_content[nidx]
-	= energy->moist[nidx] - maximum_unfrozen_water(energy->T[nidx],
-	    soil_con->max_moist_node[nidx],
-	    soil_con->bubble_node[nidx],
-	    soil_con->expt_node[nidx]);
-#endif
+      if (state->options.QUICK_FS)
+        energy->ice_content[nidx]
+	  = energy->moist[nidx] - maximum_unfrozen_water_quick(energy->T[nidx],
+	      soil_con->max_moist_node[nidx],
+	      soil_con->ufwc_table_node[nidx]);
+      else
+        energy->ice_content[nidx]
+	  = energy->moist[nidx] - maximum_unfrozen_water(energy->T[nidx],
+	      soil_con->max_moist_node[nidx],
+	      soil_con->bubble_node[nidx],
+	      soil_con->expt_node[nidx]);
       if(energy->ice_content[nidx]<0) energy->ice_content[nidx]=0;
 
       /* compute thermal conductivity */
@@ -567,14 +585,14 @@ int estimate_layer_ice_content(layer_data_struct *layer,
     if (state->options.FROZEN_SOIL && soil_con->FS_ACTIVE) {
       for ( nidx = min_nidx; nidx <= max_nidx; nidx++ ) {
         for ( frost_area = 0; frost_area < Nfrost; frost_area++ ) {
-	  tmp_ice[nidx][frost_area] = layer[lidx].moist 
-#if QUICK_FS
-	    - maximum_unfrozen_water_quick(tmpT[nidx][frost_area], max_moist[lidx], 
-					   ufwc_table_layer[lidx]);
-#else
-            - maximum_unfrozen_water(tmpT[nidx][frost_area], soil_con->max_moist[lidx],
-                soil_con->bubble[lidx], soil_con->expt[lidx]);
-#endif
+          if (state->options.QUICK_FS)
+	    tmp_ice[nidx][frost_area] = layer[lidx].moist
+	      - maximum_unfrozen_water_quick(tmpT[nidx][frost_area], soil_con->max_moist[lidx],
+	          soil_con->ufwc_table_layer[lidx]);
+          else
+	    tmp_ice[nidx][frost_area] = layer[lidx].moist
+              - maximum_unfrozen_water(tmpT[nidx][frost_area], soil_con->max_moist[lidx],
+                  soil_con->bubble[lidx], soil_con->expt[lidx]);
 	  if ( tmp_ice[nidx][frost_area] < 0 ) tmp_ice[nidx][frost_area] = 0.;
         }
       }
@@ -676,15 +694,15 @@ int estimate_layer_ice_content_quick_flux(layer_data_struct *layer,
         if ( frost_area == 0 ) tmp_fract = frost_fract[0] / 2.;
         else tmp_fract += (frost_fract[frost_area-1] / 2. + frost_fract[frost_area] / 2.);
         tmpT = linear_interp(tmp_fract, 0, 1, min_temp, max_temp);
-        tmp_ice = layer[lidx].moist
-#if QUICK_FS
-	    - maximum_unfrozen_water_quick(tmpT, soil_con->max_moist[lidx], soil_con->ufwc_table_layer[lidx]);
-#else
+        if (state->options.QUICK_FS)
+          tmp_ice = layer[lidx].moist
+	      - maximum_unfrozen_water_quick(tmpT, soil_con->max_moist[lidx], soil_con->ufwc_table_layer[lidx]);
+        else
+          tmp_ice = layer[lidx].moist
 #if EXCESS_ICE
-            - maximum_unfrozen_water(tmpT, soil_con->porosity[lidx], soil_con->effective_porosity[lidx], soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
+              - maximum_unfrozen_water(tmpT, soil_con->porosity[lidx], soil_con->effective_porosity[lidx], soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
 #else
-	    - maximum_unfrozen_water(tmpT, soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
-#endif
+	      - maximum_unfrozen_water(tmpT, soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
 #endif
         layer[lidx].soil_ice[frost_area] = frost_fract[frost_area] * tmp_ice;
         if (layer[lidx].soil_ice[frost_area] < 0) {
@@ -698,12 +716,12 @@ int estimate_layer_ice_content_quick_flux(layer_data_struct *layer,
 
 #else
 
-      layer[lidx].soil_ice = layer[lidx].moist
-#if QUICK_FS
+      if (state->options.QUICK_FS)
+        layer[lidx].soil_ice = layer[lidx].moist
 	    - maximum_unfrozen_water_quick(layer[lidx].T, soil_con->max_moist[lidx], soil_con->ufwc_table_layer[lidx]);
-#else
-      - maximum_unfrozen_water(layer[lidx].T, soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
-#endif
+      else
+        layer[lidx].soil_ice = layer[lidx].moist
+            - maximum_unfrozen_water(layer[lidx].T, soil_con->max_moist[lidx], soil_con->bubble[lidx], soil_con->expt[lidx]);
 
       if (layer[lidx].soil_ice < 0) {
         layer[lidx].soil_ice = 0;
@@ -862,29 +880,53 @@ double maximum_unfrozen_water(double T,
   
 }
 
-#if QUICK_FS
+double maximum_unfrozen_water_dT(double T,
+                                 double max_moist,
+                                 double bubble,
+                                 double expt) {
+/**********************************************************************
+  This subroutine computes the derivative of maximum_unfrozen_water()
+  with respect to T.  For T < 0, unfrozen = max_moist * (c * -T)^p with
+  p = -2 / (expt - 3), so d(unfrozen)/dT = p * unfrozen / T.  The
+  derivative is zero where unfrozen is limited to [0, max_moist].
+**********************************************************************/
+
+  double unfrozen;
+  double p;
+
+  if ( T < 0 ) {
+    p = -(2.0 / (expt - 3.0));
+    unfrozen = max_moist * pow((-Lf * T) / 273.16 / (9.81 * bubble / 100.), p);
+    if (unfrozen > max_moist || unfrozen < 0) return (0.);
+    return (p * unfrozen / T);
+  }
+  return (0.);
+
+}
+
 double maximum_unfrozen_water_quick(double   T,
 				    double   max_moist,
-				    double **table) {
+				    const UfwcTable *table) {
 /**********************************************************************
   This subroutine computes the maximum amount of unfrozen water that
-  can exist at the current temperature.
+  can exist at the current temperature, from the linearized curve of
+  the QUICK_FS option (see UfwcTable.h).  The segment is found by
+  counting the segment boundaries above T rather than by searching,
+  so there are no data dependent branches; temperatures above the
+  warmest and below the coldest boundary extend the first and last
+  segment.
 **********************************************************************/
 
-  extern double temps[];
-
   int i;
+  int j;
   double unfrozen;
 
-  i = 1;
-  while(T < temps[i] && i < QUICK_FS_TEMPS) i++;
-  unfrozen = max_moist * (table[i-1][0] + table[i-1][1] * T);
-  if(unfrozen > max_moist) unfrozen = max_moist;
-  if(unfrozen < 0) unfrozen = 0;
+  i = 0;
+  for(j=1;j<QUICK_FS_TEMPS;j++) i += (T < UfwcTable::temps[j]);
+  unfrozen = max_moist * (table->intercept[i] + table->slope[i] * T);
 
-  return (unfrozen);
+  return (std::min(std::max(unfrozen, 0.), max_moist));
 }
-#endif
 
 layer_data_struct find_average_layer(layer_data_struct *wet,
 				     layer_data_struct *dry,
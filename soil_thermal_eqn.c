@@ -28,12 +28,11 @@ double SoilThermalEqn::calculate(double T) {
   double flux_term2;
 
   if(T<0.) {
-#if QUICK_FS
-    ice = moist - maximum_unfrozen_water_quick(T, max_moist,
-					       ufwc_table);
-#else
-    ice = moist - maximum_unfrozen_water(T,max_moist,bubble,expt);
-#endif
+    if(ufwc_table)
+      ice = moist - maximum_unfrozen_water_quick(T, max_moist,
+					         ufwc_table);
+    else
+      ice = moist - maximum_unfrozen_water(T,max_moist,bubble,expt);
     if(ice<0.) ice=0.;
     if(ice>max_moist) ice=max_moist;
   }
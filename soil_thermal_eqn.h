@@ -6,10 +6,10 @@
 class SoilThermalEqn : public RootBrent {
 public:
   SoilThermalEqn(double TL, double TU, double T0, double moist,
-      double max_moist, double** ufwc_table, double bubble, double expt,
+      double max_moist, const UfwcTable* ufwc_table, double bubble, double expt,
       double ice0, double gamma, double A, double B, double C, double D,
       double E, int EXP_TRANS, int node) :
-      TL(TL), TU(TU), T0(T0), moist(moist), max_moist(max_moist), ufwc_table(ufwc_table), bubble(bubble),
+      RootBrent(SOLVER_TSOIL_NODE), TL(TL), TU(TU), T0(T0), moist(moist), max_moist(max_moist), ufwc_table(ufwc_table), bubble(bubble),
       expt(expt), ice0(ice0), gamma(gamma), A(A),
       B(B), C(C), D(D), E(E), EXP_TRANS(EXP_TRANS), node(node) {
   }
@@ -21,7 +21,7 @@ private:
   double T0;
   double moist;
   double max_moist;
-  double** ufwc_table;
+  const UfwcTable* ufwc_table;  // QUICK_FS table of the node, NULL without QUICK_FS
   double bubble;
   double expt;
   double ice0;
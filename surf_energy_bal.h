@@ -34,7 +34,7 @@ public:
       double* latent_heat_sub, double* sensible_heat, double* snow_flux,
       double* store_error, const ProgramState* state) :
 
-      rec(rec), nrecs(nrecs), month(month), VEG(VEG), veg_class(veg_class),
+      RootBrent(SOLVER_TSURF), rec(rec), nrecs(nrecs), month(month), VEG(VEG), veg_class(veg_class),
           delta_t(delta_t), Cs1(Cs1), Cs2(Cs2), D1(D1), D2(D2), T1_old(
           T1_old), T2(T2), Ts_old(Ts_old), bubble(bubble), dp(dp), expt(expt), ice0(
           ice0), kappa1(kappa1), kappa2(kappa2), max_moist(max_moist), moist(
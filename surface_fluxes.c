@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 #include "vicNl.h"
 #include <math.h>
 
@@ -14,6 +16,19 @@ static char vcid[] = "$Id$";
 #define GRND_TOL 0.001
 #define OVER_TOL 0.001
 
+/**********************************************************************
+  copy_energy_bal()
+
+  Copies an energy balance structure, including its Nnode soil thermal
+  node values, into dst and the node storage of dst.  The surface flux
+  routines copy it for every iteration and sub-model time step.
+**********************************************************************/
+void copy_energy_bal(energy_bal_struct *dst, const energy_bal_struct *src, int Nnode) {
+  memcpy(dst, src, offsetof(energy_bal_struct, Cs_node));
+  // The node arrays of a structure are contiguous (see attach_energy_nodes()).
+  memcpy(dst->Cs_node, src->Cs_node, energy_nodes_size(Nnode));
+}
+
 int surface_fluxes(char         overstory,
 		   double               BareAlbedo,
 		   double               height,
@@ -206,7 +221,7 @@ int surface_fluxes(char         overstory,
   double                 step_out_snow;
   double                 step_ppt[2];
   double                 step_prec[2];
-  AeroResistUsed         *step_aero_resist;
+  AeroResistUsed         *step_aero_resist = EnergyWorkspace::current.step_aero_resist;
 
   // Quantities that need to be summed or averaged over multiple snow steps
   // energy structure
@@ -260,16 +275,16 @@ int surface_fluxes(char         overstory,
   double                 store_pot_evap[N_PET_TYPES];
 
   // Structures holding values for current snow step
-  energy_bal_struct      snow_energy; // energy fluxes at snowpack surface
-  energy_bal_struct      soil_energy; // energy fluxes at soil surface
+  energy_bal_struct&     snow_energy = EnergyWorkspace::current.energy_copy(0, state->options.Nnode); // energy fluxes at snowpack surface
+  energy_bal_struct&     soil_energy = EnergyWorkspace::current.energy_copy(1, state->options.Nnode); // energy fluxes at soil surface
   veg_var_struct         snow_veg_var[2]; // veg fluxes/storages in presence of snow
   veg_var_struct         soil_veg_var[2]; // veg fluxes/storages in soil energy balance
   snow_data_struct       step_snow;
   layer_data_struct      step_layer[2][MAX_LAYERS];
 
   // Structures holding values for current iteration
-  energy_bal_struct      iter_snow_energy; // energy fluxes at snowpack surface
-  energy_bal_struct      iter_soil_energy; // energy fluxes at soil surface
+  energy_bal_struct&     iter_snow_energy = EnergyWorkspace::current.energy_copy(2, state->options.Nnode); // energy fluxes at snowpack surface
+  energy_bal_struct&     iter_soil_energy = EnergyWorkspace::current.energy_copy(3, state->options.Nnode); // energy fluxes at soil surface
   veg_var_struct         iter_snow_veg_var[2]; // veg fluxes/storages in presence of snow
   veg_var_struct         iter_soil_veg_var[2]; // veg fluxes/storages in soil energy balance
   snow_data_struct       iter_snow;
@@ -284,7 +299,6 @@ int surface_fluxes(char         overstory,
   double A_tol_under;
   double A_snow_flux;
 
-  step_aero_resist = new AeroResistUsed[N_PET_TYPES];
 
   // Snowfall redistribution parameters
   double Gmod = 0.0;
@@ -303,8 +317,8 @@ int surface_fluxes(char         overstory,
     snow_flux = -(energy->grnd_flux + energy->deltaH + energy->fusion);
   energy->refreeze_energy = 0;
   coverage = snow->coverage;
-  snow_energy = (*energy);
-  soil_energy = (*energy);
+  copy_energy_bal(&snow_energy, energy, state->options.Nnode);
+  copy_energy_bal(&soil_energy, energy, state->options.Nnode);
   snow_veg_var[WET] = (*veg_var_wet);
   snow_veg_var[DRY] = (*veg_var_dry);
   soil_veg_var[WET] = (*veg_var_wet);
@@ -474,203 +488,314 @@ int surface_fluxes(char         overstory,
     } else
       step_snow.blowing_flux = 0.0;
 
-    do {
-
-      /** Iterate for overstory solution **/
+    if (step_snow.swq == 0 && snowfall[WET] == 0 && !(step_snow.snow_canopy > 0 && overstory)) {
+
+      /**************************************************
+       Snow-free surface: there is no snow on the ground or
+       in the canopy, and none is falling, so solve_snow()
+       has nothing to do and the energy balance needs no
+       iteration.  Set what solve_snow() sets without snow
+       and solve the surface energy balance directly on the
+       sub-model time step variables.
+       **************************************************/
+
+      snow_veg_var[WET].Wdew = step_Wdew[WET];
+      snow_veg_var[DRY].Wdew = step_Wdew[DRY];
+      soil_veg_var[WET].Wdew = step_Wdew[WET];
+      soil_veg_var[DRY].Wdew = step_Wdew[DRY];
+      for (dist = 0; dist < Ndist; dist++) {
+        snow_veg_var[dist].canopyevap = 0;
+        soil_veg_var[dist].canopyevap = 0;
+        for (lidx = 0; lidx < Nlayers; lidx++)
+          step_layer[dist][lidx].evap = 0;
+      }
 
-      over_iter++;
-      last_tol_over = tol_over;
+      iter_aero_resist = aero_resist[N_PET_TYPES];  // This copies all variables in the struct.
+
+      iter_aero_resist_used.surface = cell_wet->aero_resist.surface;
+      iter_aero_resist_used.overstory = cell_wet->aero_resist.overstory;
+      step_snow.canopy_vapor_flux = 0;
+      step_snow.vapor_flux = 0;
+      step_snow.surface_flux = 0;
+
+      // as set by solve_snow() when no snow is present or falling
+      step_melt = 0;
+      step_melt_energy = 0;
+      step_ppt[WET] = 0;
+      step_ppt[DRY] = 0;
+      (*latent_heat_Le) = (2.501e6 - 0.002361e6 * Tair);
+      UnderStory = VegConditions::SNOW_FREE_CASE;
+      ShortUnderIn = atmos->shortwave[hidx];
+      LongUnderIn = atmos->longwave[hidx];
+      energy->AlbedoUnder = BareAlbedo;
+      NetLongSnow = 0.;
+      NetShortSnow = 0.;
+      NetShortGrnd = 0.;
+      delta_coverage = 0.;
+      snow_energy.AlbedoOver = 0.;
+      snow_energy.NetLongOver = 0.;
+      snow_energy.LongOverIn = 0.;
+      snow_energy.NetShortOver = 0.;
+      snow_energy.ShortOverIn = 0.;
+      snow_energy.latent = 0.;
+      snow_energy.latent_sub = 0.;
+      snow_energy.sensible = 0.;
+      snow_energy.Tfoliage = Tcanopy;
+      snow_energy.melt_energy *= -1.;
+      step_snow.snow = FALSE;
+      step_snow.store_swq = 0;
+      step_snow.store_coverage = 1;
+      step_snow.MELTING = FALSE;
+      step_snow.last_snow = INVALID_INT;
+      step_snow.albedo = soil_con->NEW_SNOW_ALB;
+      INCLUDE_SNOW = FALSE;
+
+      Tsurf = calc_surf_energy_bal((*latent_heat_Le), LongUnderIn, NetLongSnow, NetShortGrnd,
+          NetShortSnow, OldTSurf, ShortUnderIn, step_snow.albedo, snow_energy.latent,
+          snow_energy.latent_sub, snow_energy.sensible, Tcanopy, VPDcanopy, VPcanopy,
+          snow_energy.advection, step_snow.coldcontent, delta_coverage, dp, ice0,
+          step_melt_energy, moist0, hru.mu, step_snow.coverage, step_snow.depth,
+          BareAlbedo, surf_atten, step_snow.vapor_flux, iter_aero_resist, iter_aero_resist_used,
+          displacement, &step_melt, step_ppt, rainfall, ref_height, roughness, snowfall, wind_speed,
+          root, INCLUDE_SNOW, UnderStory, state->options.Nnode, step_dt, hidx, state->options.Nlayer,
+          (int) overstory, rec, veg_class, hru.isArtificialBareSoil, atmos, &(dmy[rec]), &soil_energy,
+          step_layer[DRY], step_layer[WET], &step_snow, soil_con, &soil_veg_var[DRY],
+          &soil_veg_var[WET], state->global_param.nrecs, state);
+
+      if ((int) Tsurf == ERROR) {
+        // Return error flag to skip rest of grid cell
+        return (ERROR);
+      }
 
-      under_iter = 0;
-      tol_under = INVALID;
-      UnderStory = VegConditions::NUM_VEGETATION_CONDITIONS;  // Uninitialized for first use (this is checked in solve_snow)
+      // without snow there is no canopy energy balance to close, see the iteration below
+      soil_energy.AtmosLatent = soil_energy.latent;
+      soil_energy.AtmosLatentSub = soil_energy.latent_sub;
+      soil_energy.AtmosSensible = soil_energy.sensible;
+      soil_energy.NetLongAtmos = soil_energy.NetLongUnder;
+      soil_energy.NetShortAtmos = soil_energy.NetShortUnder;
+      soil_energy.Tcanopy = Tcanopy;
+      snow_energy.Tcanopy = Tcanopy;
 
-      UNSTABLE_CNT = 0;
+    } else {
 
-      // bisect understory
-      BISECT_UNDER = FALSE;
-      A_tol_under = INVALID;
-      store_tol_under = INVALID;
+      SolverCall energyBalanceIteration(SOLVER_SURF_FLUXES);
 
       do {
 
-        /** Iterate for understory solution - iterates to find snow flux **/
+        /** Iterate for overstory solution **/
 
-        under_iter++;
-        last_tol_under = tol_under;
+        over_iter++;
+        last_tol_over = tol_over;
 
-        if (IS_VALID(last_Tcanopy))
-          Tcanopy = (last_Tcanopy + Tcanopy) / 2.;
-        last_Tcanopy = Tcanopy;
+        under_iter = 0;
+        tol_under = INVALID;
+        UnderStory = VegConditions::NUM_VEGETATION_CONDITIONS;  // Uninitialized for first use (this is checked in solve_snow)
 
-        // update understory energy balance terms for iteration
-        if (IS_VALID(last_snow_flux)) {
-          if ((fabs(store_tol_under) > fabs(A_tol_under) && IS_VALID(A_tol_under)
-              && fabs(store_tol_under - A_tol_under) > 1.) || tol_under < 0) { // stepped the correct way
-            UNSTABLE_CNT++;
-            if (UNSTABLE_CNT > 3 || tol_under < 0)
-              UNSTABLE_SNOW = TRUE;
-          } else if (!INCLUDE_SNOW) { // stepped the wrong way
-            snow_flux = (last_snow_flux + iter_soil_energy.snow_flux) / 2.;
-          }
-        }
-        last_snow_flux = snow_flux;
-        A_tol_under = store_tol_under;
-        A_snow_flux = snow_flux;
-
-        snow_grnd_flux = -snow_flux;
-
-        // Initialize structures for new iteration
-        iter_snow_energy = snow_energy;
-        iter_soil_energy = soil_energy;
-        iter_snow_veg_var[WET] = snow_veg_var[WET];
-        iter_snow_veg_var[DRY] = snow_veg_var[DRY];
-        iter_soil_veg_var[WET] = soil_veg_var[WET];
-        iter_soil_veg_var[DRY] = soil_veg_var[DRY];
-        iter_snow = step_snow;
-        for (lidx = 0; lidx < Nlayers; lidx++) {
-          iter_layer[WET][lidx] = step_layer[WET][lidx];
-          iter_layer[DRY][lidx] = step_layer[DRY][lidx];
-        }
-        iter_snow_veg_var[WET].Wdew = step_Wdew[WET];
-        iter_snow_veg_var[DRY].Wdew = step_Wdew[DRY];
-        iter_soil_veg_var[WET].Wdew = step_Wdew[WET];
-        iter_soil_veg_var[DRY].Wdew = step_Wdew[DRY];
-        for (dist = 0; dist < Ndist; dist++) {
-          iter_snow_veg_var[dist].canopyevap = 0;
-          iter_soil_veg_var[dist].canopyevap = 0;
-          for (lidx = 0; lidx < Nlayers; lidx++)
-            iter_layer[dist][lidx].evap = 0;
-        }
+        UNSTABLE_CNT = 0;
 
-        iter_aero_resist = aero_resist[N_PET_TYPES];  // This copies all variables in the struct.
-
-        iter_aero_resist_used.surface = cell_wet->aero_resist.surface;
-        iter_aero_resist_used.overstory = cell_wet->aero_resist.overstory;
-        iter_snow.canopy_vapor_flux = 0;
-        iter_snow.vapor_flux = 0;
-        iter_snow.surface_flux = 0;
-        /* iter_snow.blowing_flux has already been reset to step_snow.blowing_flux */
-        LongUnderOut = iter_soil_energy.LongUnderOut;
-
-        /** Solve snow accumulation, ablation and interception **/
-        step_melt = solve_snow(overstory, BareAlbedo, LongUnderOut, Tcanopy, Tgrnd, Tair,
-            hru.mu, snow_grnd_flux, &energy->AlbedoUnder, latent_heat_Le, &LongUnderIn,
-            &NetLongSnow, &NetShortGrnd, &NetShortSnow, &ShortUnderIn, &OldTSurf,
-            iter_aero_resist, iter_aero_resist_used, &coverage, &delta_coverage, displacement,
-            &step_melt_energy, step_ppt, rainfall, ref_height, roughness, snow_inflow, snowfall,
-            &surf_atten, wind_speed, root, UNSTABLE_SNOW, step_dt, rec, hidx, veg_class,
-            hru.isArtificialBareSoil, UnderStory, dmy, *atmos, &(iter_snow_energy), iter_layer[DRY],
-            iter_layer[WET], &(iter_snow), soil_con, &(iter_snow_veg_var[DRY]), &(iter_snow_veg_var[WET]),
-            state);
-
-// iter_snow_energy.sensible + iter_snow_energy.latent + iter_snow_energy.latent_sub + NetShortSnow + NetLongSnow + ( snow_grnd_flux + iter_snow_energy.advection - iter_snow_energy.deltaCC + iter_snow_energy.refreeze_energy + iter_snow_energy.advected_sensible ) * step_snow.coverage
-        if (step_melt == ERROR)
-          return (ERROR);
-
-        /* Check that the snow surface temperature was estimated, if not
-         prepare to include thin snowpack in the estimation of the
-         snow-free surface energy balance */
-        if ((IS_INVALID(iter_snow.surf_temp) || UNSTABLE_SNOW) && iter_snow.swq > 0) {
-          INCLUDE_SNOW = UnderStory + 1;
-          iter_soil_energy.advection = iter_snow_energy.advection;
-          iter_snow.surf_temp = step_snow.surf_temp;
-          step_melt_energy = 0;
-        } else {
-          INCLUDE_SNOW = FALSE;
-        }
+        // bisect understory
+        BISECT_UNDER = FALSE;
+        A_tol_under = INVALID;
+        store_tol_under = INVALID;
 
-        /**************************************************
-         Solve Energy Balance Components at Soil Surface
-         **************************************************/
-
-        Tsurf = calc_surf_energy_bal((*latent_heat_Le), LongUnderIn, NetLongSnow, NetShortGrnd,
-            NetShortSnow, OldTSurf, ShortUnderIn, iter_snow.albedo, iter_snow_energy.latent,
-            iter_snow_energy.latent_sub, iter_snow_energy.sensible, Tcanopy, VPDcanopy, VPcanopy,
-            iter_snow_energy.advection, step_snow.coldcontent, delta_coverage, dp, ice0,
-            step_melt_energy, moist0, hru.mu, iter_snow.coverage, (step_snow.depth + iter_snow.depth) / 2.,
-            BareAlbedo, surf_atten, iter_snow.vapor_flux, iter_aero_resist, iter_aero_resist_used,
-            displacement, &step_melt, step_ppt, rainfall, ref_height, roughness, snowfall, wind_speed,
-            root, INCLUDE_SNOW, UnderStory, state->options.Nnode, step_dt, hidx, state->options.Nlayer,
-            (int) overstory, rec, veg_class, hru.isArtificialBareSoil, atmos, &(dmy[rec]), &iter_soil_energy,
-            iter_layer[DRY], iter_layer[WET], &(iter_snow), soil_con, &iter_soil_veg_var[DRY],
-            &iter_soil_veg_var[WET], state->global_param.nrecs, state);
-
-        if ((int) Tsurf == ERROR) {
-          // Return error flag to skip rest of grid cell
-          return (ERROR);
-        }
+        do {
 
-        if (INCLUDE_SNOW) {
-          /* store melt from thin snowpack */
-          step_ppt[WET] += step_melt;
-        }
+          /** Iterate for understory solution - iterates to find snow flux **/
 
-        /*****************************************
-         Compute energy balance with atmosphere
-         *****************************************/
-        if (iter_snow.snow && overstory && MAX_ITER > 0) {
-          // do this if overstory is active and energy balance is closed
-          Tcanopy = calc_atmos_energy_bal(iter_snow_energy.canopy_sensible,
-              iter_soil_energy.sensible, iter_snow_energy.canopy_latent,
-              iter_soil_energy.latent, iter_snow_energy.canopy_latent_sub,
-              iter_soil_energy.latent_sub, (*latent_heat_Le), iter_snow_energy.NetLongOver,
-              iter_soil_energy.NetLongUnder, iter_snow_energy.NetShortOver,
-              iter_soil_energy.NetShortUnder, iter_aero_resist_used.overstory, Tair,
-              atmos->density[hidx], atmos->vp[hidx], atmos->vpd[hidx],
-              &iter_soil_energy.AtmosError, &iter_soil_energy.AtmosLatent,
-              &iter_soil_energy.AtmosLatentSub, &iter_soil_energy.NetLongAtmos,
-              &iter_soil_energy.NetShortAtmos, &iter_soil_energy.AtmosSensible,
-              &VPcanopy, &VPDcanopy, &iter_soil_energy.Tcanopy_fbflag,
-              &iter_soil_energy.Tcanopy_fbcount, state);
-          /* iterate to find Tcanopy which will solve the atmospheric energy
-           balance.  Since I do not know vp in the canopy, use the
-           sum of latent heats from the ground and foliage, and iterate
-           on the temperature used for the sensible heat flux from the
-           canopy air to the mixing level */
-          if ((int) Tcanopy == ERROR) {
-            // Return error flag to skip rest of grid cell
-            return (ERROR);
+          under_iter++;
+          last_tol_under = tol_under;
+          energyBalanceIteration.iteration();
+
+          if (IS_VALID(last_Tcanopy))
+            Tcanopy = (last_Tcanopy + Tcanopy) / 2.;
+          last_Tcanopy = Tcanopy;
+
+          // update understory energy balance terms for iteration
+          if (IS_VALID(last_snow_flux)) {
+            if ((fabs(store_tol_under) > fabs(A_tol_under) && IS_VALID(A_tol_under)
+                && fabs(store_tol_under - A_tol_under) > 1.) || tol_under < 0) { // stepped the correct way
+              UNSTABLE_CNT++;
+              if (UNSTABLE_CNT > 3 || tol_under < 0)
+                UNSTABLE_SNOW = TRUE;
+            } else if (!INCLUDE_SNOW) { // stepped the wrong way
+              snow_flux = (last_snow_flux + iter_soil_energy.snow_flux) / 2.;
+            }
+          }
+          last_snow_flux = snow_flux;
+          A_tol_under = store_tol_under;
+          A_snow_flux = snow_flux;
+
+          snow_grnd_flux = -snow_flux;
+
+          // Initialize structures for new iteration
+          copy_energy_bal(&iter_snow_energy, &snow_energy, state->options.Nnode);
+          copy_energy_bal(&iter_soil_energy, &soil_energy, state->options.Nnode);
+          iter_snow_veg_var[WET] = snow_veg_var[WET];
+          iter_snow_veg_var[DRY] = snow_veg_var[DRY];
+          iter_soil_veg_var[WET] = soil_veg_var[WET];
+          iter_soil_veg_var[DRY] = soil_veg_var[DRY];
+          iter_snow = step_snow;
+          for (lidx = 0; lidx < Nlayers; lidx++) {
+            iter_layer[WET][lidx] = step_layer[WET][lidx];
+            iter_layer[DRY][lidx] = step_layer[DRY][lidx];
+          }
+          iter_snow_veg_var[WET].Wdew = step_Wdew[WET];
+          iter_snow_veg_var[DRY].Wdew = step_Wdew[DRY];
+          iter_soil_veg_var[WET].Wdew = step_Wdew[WET];
+          iter_soil_veg_var[DRY].Wdew = step_Wdew[DRY];
+          for (dist = 0; dist < Ndist; dist++) {
+            iter_snow_veg_var[dist].canopyevap = 0;
+            iter_soil_veg_var[dist].canopyevap = 0;
+            for (lidx = 0; lidx < Nlayers; lidx++)
+              iter_layer[dist][lidx].evap = 0;
           }
-        } else {
-          // else put surface fluxes into atmospheric flux storage so that
-          // the model will continue to function
-          iter_soil_energy.AtmosLatent = iter_soil_energy.latent;
-          iter_soil_energy.AtmosLatentSub = iter_soil_energy.latent_sub;
-          iter_soil_energy.AtmosSensible = iter_soil_energy.sensible;
-          iter_soil_energy.NetLongAtmos = iter_soil_energy.NetLongUnder;
-          iter_soil_energy.NetShortAtmos = iter_soil_energy.NetShortUnder;
-        }
-        iter_soil_energy.Tcanopy = Tcanopy;
-        iter_snow_energy.Tcanopy = Tcanopy;
 
-        /*****************************************
-         Compute iteration tolerance statistics
-         *****************************************/
+          iter_aero_resist = aero_resist[N_PET_TYPES];  // This copies all variables in the struct.
+
+          iter_aero_resist_used.surface = cell_wet->aero_resist.surface;
+          iter_aero_resist_used.overstory = cell_wet->aero_resist.overstory;
+          iter_snow.canopy_vapor_flux = 0;
+          iter_snow.vapor_flux = 0;
+          iter_snow.surface_flux = 0;
+          /* iter_snow.blowing_flux has already been reset to step_snow.blowing_flux */
+          LongUnderOut = iter_soil_energy.LongUnderOut;
+
+          /** Solve snow accumulation, ablation and interception **/
+          step_melt = solve_snow(overstory, BareAlbedo, LongUnderOut, Tcanopy, Tgrnd, Tair,
+              hru.mu, snow_grnd_flux, &energy->AlbedoUnder, latent_heat_Le, &LongUnderIn,
+              &NetLongSnow, &NetShortGrnd, &NetShortSnow, &ShortUnderIn, &OldTSurf,
+              iter_aero_resist, iter_aero_resist_used, &coverage, &delta_coverage, displacement,
+              &step_melt_energy, step_ppt, rainfall, ref_height, roughness, snow_inflow, snowfall,
+              &surf_atten, wind_speed, root, UNSTABLE_SNOW, step_dt, rec, hidx, veg_class,
+              hru.isArtificialBareSoil, UnderStory, dmy, *atmos, &(iter_snow_energy), iter_layer[DRY],
+              iter_layer[WET], &(iter_snow), soil_con, &(iter_snow_veg_var[DRY]), &(iter_snow_veg_var[WET]),
+              state);
+
+  // iter_snow_energy.sensible + iter_snow_energy.latent + iter_snow_energy.latent_sub + NetShortSnow + NetLongSnow + ( snow_grnd_flux + iter_snow_energy.advection - iter_snow_energy.deltaCC + iter_snow_energy.refreeze_energy + iter_snow_energy.advected_sensible ) * step_snow.coverage
+          if (step_melt == ERROR)
+            return (ERROR);
 
-        // compute understory tolerance
-        if (INCLUDE_SNOW || (iter_snow.swq == 0 && delta_coverage == 0)) {
-          store_tol_under = 0;
-          tol_under = 0;
-        } else {
-          store_tol_under = snow_flux - iter_soil_energy.snow_flux;
-          tol_under = fabs(store_tol_under);
-        }
-        if (fabs(tol_under - last_tol_under) < GRND_TOL && tol_under > 1.)
-          tol_under = INVALID;
+          /* Check that the snow surface temperature was estimated, if not
+           prepare to include thin snowpack in the estimation of the
+           snow-free surface energy balance */
+          if ((IS_INVALID(iter_snow.surf_temp) || UNSTABLE_SNOW) && iter_snow.swq > 0) {
+            INCLUDE_SNOW = UnderStory + 1;
+            iter_soil_energy.advection = iter_snow_energy.advection;
+            iter_snow.surf_temp = step_snow.surf_temp;
+            step_melt_energy = 0;
+          } else {
+            INCLUDE_SNOW = FALSE;
+          }
 
-        // compute overstory tolerance
-        if (overstory && iter_snow.snow) {
-          tol_over = fabs(Tcanopy - last_Tcanopy);
-        } else {
-          tol_over = 0;
-        }
+          /**************************************************
+           Solve Energy Balance Components at Soil Surface
+           **************************************************/
+
+          Tsurf = calc_surf_energy_bal((*latent_heat_Le), LongUnderIn, NetLongSnow, NetShortGrnd,
+              NetShortSnow, OldTSurf, ShortUnderIn, iter_snow.albedo, iter_snow_energy.latent,
+              iter_snow_energy.latent_sub, iter_snow_energy.sensible, Tcanopy, VPDcanopy, VPcanopy,
+              iter_snow_energy.advection, step_snow.coldcontent, delta_coverage, dp, ice0,
+              step_melt_energy, moist0, hru.mu, iter_snow.coverage, (step_snow.depth + iter_snow.depth) / 2.,
+              BareAlbedo, surf_atten, iter_snow.vapor_flux, iter_aero_resist, iter_aero_resist_used,
+              displacement, &step_melt, step_ppt, rainfall, ref_height, roughness, snowfall, wind_speed,
+              root, INCLUDE_SNOW, UnderStory, state->options.Nnode, step_dt, hidx, state->options.Nlayer,
+              (int) overstory, rec, veg_class, hru.isArtificialBareSoil, atmos, &(dmy[rec]), &iter_soil_energy,
+              iter_layer[DRY], iter_layer[WET], &(iter_snow), soil_con, &iter_soil_veg_var[DRY],
+              &iter_soil_veg_var[WET], state->global_param.nrecs, state);
+
+          if ((int) Tsurf == ERROR) {
+            // Return error flag to skip rest of grid cell
+            return (ERROR);
+          }
 
-      } while ((fabs(tol_under - last_tol_under) > GRND_TOL) && (tol_under != 0)
-          && (under_iter < MAX_ITER));
+          if (INCLUDE_SNOW) {
+            /* store melt from thin snowpack */
+            step_ppt[WET] += step_melt;
+          }
 
-    } while ((fabs(tol_over - last_tol_over) > OVER_TOL && overstory)
-        && (tol_over != 0) && (over_iter < MAX_ITER));
+          /*****************************************
+           Compute energy balance with atmosphere
+           *****************************************/
+          if (iter_snow.snow && overstory && MAX_ITER > 0) {
+            // do this if overstory is active and energy balance is closed
+            Tcanopy = calc_atmos_energy_bal(iter_snow_energy.canopy_sensible,
+                iter_soil_energy.sensible, iter_snow_energy.canopy_latent,
+                iter_soil_energy.latent, iter_snow_energy.canopy_latent_sub,
+                iter_soil_energy.latent_sub, (*latent_heat_Le), iter_snow_energy.NetLongOver,
+                iter_soil_energy.NetLongUnder, iter_snow_energy.NetShortOver,
+                iter_soil_energy.NetShortUnder, iter_aero_resist_used.overstory, Tair,
+                atmos->density[hidx], atmos->vp[hidx], atmos->vpd[hidx],
+                &iter_soil_energy.AtmosError, &iter_soil_energy.AtmosLatent,
+                &iter_soil_energy.AtmosLatentSub, &iter_soil_energy.NetLongAtmos,
+                &iter_soil_energy.NetShortAtmos, &iter_soil_energy.AtmosSensible,
+                &VPcanopy, &VPDcanopy, &iter_soil_energy.Tcanopy_fbflag,
+                &iter_soil_energy.Tcanopy_fbcount, state);
+            /* iterate to find Tcanopy which will solve the atmospheric energy
+             balance.  Since I do not know vp in the canopy, use the
+             sum of latent heats from the ground and foliage, and iterate
+             on the temperature used for the sensible heat flux from the
+             canopy air to the mixing level */
+            if ((int) Tcanopy == ERROR) {
+              // Return error flag to skip rest of grid cell
+              return (ERROR);
+            }
+          } else {
+            // else put surface fluxes into atmospheric flux storage so that
+            // the model will continue to function
+            iter_soil_energy.AtmosLatent = iter_soil_energy.latent;
+            iter_soil_energy.AtmosLatentSub = iter_soil_energy.latent_sub;
+            iter_soil_energy.AtmosSensible = iter_soil_energy.sensible;
+            iter_soil_energy.NetLongAtmos = iter_soil_energy.NetLongUnder;
+            iter_soil_energy.NetShortAtmos = iter_soil_energy.NetShortUnder;
+          }
+          iter_soil_energy.Tcanopy = Tcanopy;
+          iter_snow_energy.Tcanopy = Tcanopy;
+
+          /*****************************************
+           Compute iteration tolerance statistics
+           *****************************************/
+
+          // compute understory tolerance
+          if (INCLUDE_SNOW || (iter_snow.swq == 0 && delta_coverage == 0)) {
+            store_tol_under = 0;
+            tol_under = 0;
+          } else {
+            store_tol_under = snow_flux - iter_soil_energy.snow_flux;
+            tol_under = fabs(store_tol_under);
+          }
+          if (fabs(tol_under - last_tol_under) < GRND_TOL && tol_under > 1.)
+            tol_under = INVALID;
+
+          // compute overstory tolerance
+          if (overstory && iter_snow.snow) {
+            tol_over = fabs(Tcanopy - last_Tcanopy);
+          } else {
+            tol_over = 0;
+          }
+
+        } while ((fabs(tol_under - last_tol_under) > GRND_TOL) && (tol_under != 0)
+            && (under_iter < MAX_ITER));
+
+      } while ((fabs(tol_over - last_tol_over) > OVER_TOL && overstory)
+          && (tol_over != 0) && (over_iter < MAX_ITER));
+
+      if (MAX_ITER > 0 && (over_iter >= MAX_ITER || under_iter >= MAX_ITER))
+        energyBalanceIteration.failure();
+      energyBalanceIteration.stop();
+
+      /** Store the iteration results for this sub-model time step **/
+      copy_energy_bal(&snow_energy, &iter_snow_energy, state->options.Nnode);
+      copy_energy_bal(&soil_energy, &iter_soil_energy, state->options.Nnode);
+      snow_veg_var[WET] = iter_snow_veg_var[WET];
+      snow_veg_var[DRY] = iter_snow_veg_var[DRY];
+      soil_veg_var[WET] = iter_soil_veg_var[WET];
+      soil_veg_var[DRY] = iter_soil_veg_var[DRY];
+      step_snow = iter_snow;
+      for (lidx = 0; lidx < state->options.Nlayer; lidx++) {
+        step_layer[WET][lidx] = iter_layer[WET][lidx];
+        step_layer[DRY][lidx] = iter_layer[DRY][lidx];
+      }
+    }
 
     /**************************************
      Compute Potential Evap
@@ -706,25 +831,13 @@ int surface_fluxes(char         overstory,
 
     // Finally, compute pot_evap
     compute_pot_evap(veg_class, dmy, rec, state->global_param.dt, atmos->shortwave[hidx],
-        iter_soil_energy.NetLongAtmos, Tair, VPDcanopy, soil_con->elevation,
+        soil_energy.NetLongAtmos, Tair, VPDcanopy, soil_con->elevation,
         step_aero_resist, iter_pot_evap, state);
 
     /**************************************
      Store sub-model time step variables
      **************************************/
 
-    snow_energy = iter_snow_energy;
-    soil_energy = iter_soil_energy;
-    snow_veg_var[WET] = iter_snow_veg_var[WET];
-    snow_veg_var[DRY] = iter_snow_veg_var[DRY];
-    soil_veg_var[WET] = iter_soil_veg_var[WET];
-    soil_veg_var[DRY] = iter_soil_veg_var[DRY];
-    step_snow = iter_snow;
-    for (lidx = 0; lidx < state->options.Nlayer; lidx++) {
-      step_layer[WET][lidx] = iter_layer[WET][lidx];
-      step_layer[DRY][lidx] = iter_layer[DRY][lidx];
-    }
-
     for (dist = 0; dist < Ndist; dist++) {
 
       if (hru.isArtificialBareSoil == false) {
@@ -856,7 +969,7 @@ int surface_fluxes(char         overstory,
    Store energy flux averages for sub-model time steps
    ******************************************************/
 
-  (*energy) = soil_energy;
+  copy_energy_bal(energy, &soil_energy, state->options.Nnode);
   energy->AlbedoOver = store_AlbedoOver / (double) N_steps;
   energy->AlbedoUnder = store_AlbedoUnder / (double) N_steps;
   energy->AtmosLatent = store_AtmosLatent / (double) N_steps;
@@ -946,7 +1059,6 @@ int surface_fluxes(char         overstory,
   for (p = 0; p < N_PET_TYPES; p++)
     cell_wet->pot_evap[p] = store_pot_evap[p] / (double) N_steps;
 
-  delete [] step_aero_resist;
 
   /********************************************************
    Compute Runoff, Baseflow, and Soil Moisture Transport
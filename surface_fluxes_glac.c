@@ -81,7 +81,7 @@ int surface_fluxes_glac(
   double                 step_out_snow;
   double                 step_ppt[2];
   double                 step_prec[2];
-  AeroResistUsed        *step_aero_resist;
+  AeroResistUsed        *step_aero_resist = EnergyWorkspace::current.step_aero_resist;
   double step_melt_glac;
 
   // Quantities that need to be summed or averaged over multiple snow steps
@@ -143,7 +143,7 @@ int surface_fluxes_glac(
   double                 store_pot_evap[N_PET_TYPES];
 
   // Structures holding values for current snow step
-  energy_bal_struct      step_energy; // energy fluxes at snowpack surface and glacier surface
+  energy_bal_struct&     step_energy = EnergyWorkspace::current.energy_copy(0, state->options.Nnode); // energy fluxes at snowpack surface and glacier surface
   veg_var_struct         snow_veg_var[2]; // veg fluxes/storages in presence of snow
   veg_var_struct         soil_veg_var[2]; // veg fluxes/storages in soil energy balance
   snow_data_struct       step_snow;
@@ -156,7 +156,6 @@ int surface_fluxes_glac(
   double                 stability_factor[2];
   double                 step_pot_evap[N_PET_TYPES];
 
-  step_aero_resist = new AeroResistUsed[N_PET_TYPES];
 
   // Snowfall redistribution parameters
   double Gmod = 0.0;
@@ -168,7 +167,7 @@ int surface_fluxes_glac(
    ***********************************************************************/
 
   coverage = hru.snow.coverage;
-  step_energy = hru.energy;
+  copy_energy_bal(&step_energy, &hru.energy, state->options.Nnode);
   snow_veg_var[WET] = hru.veg_var[WET];
   snow_veg_var[DRY] = hru.veg_var[DRY];
   soil_veg_var[WET] = hru.veg_var[WET];
@@ -494,7 +493,7 @@ int surface_fluxes_glac(
    Store energy flux averages for sub-model time steps
    ******************************************************/
 
-  hru.energy = step_energy;
+  copy_energy_bal(&hru.energy, &step_energy, state->options.Nnode);
   hru.energy.AlbedoOver = store_AlbedoOver / (double) N_steps;
   hru.energy.AlbedoUnder = store_AlbedoUnder / (double) N_steps;
   hru.energy.AtmosLatent = store_AtmosLatent / (double) N_steps;
@@ -582,7 +581,6 @@ int surface_fluxes_glac(
   for (int p = 0; p < N_PET_TYPES; p++)
     hru.cell[WET].pot_evap[p] = store_pot_evap[p] / (double) N_steps;
 
-  delete [] step_aero_resist;
 
   /********************************************************
    Compute Runoff, Baseflow, and Soil Moisture Transport
@@ -4,7 +4,7 @@
 
 static char vcid[] = "$Id$";
 
-double svp(double temp)
+double svp_reference(double temp)
 /**********************************************************************
   This routine computes the saturated vapor pressure using Handbook
   of Hydrology eqn 4.2.2
@@ -22,6 +22,87 @@ double svp(double temp)
   return (SVP*1000.);
 }
 
+/**********************************************************************
+  Table of svp_reference() for svp_fast().  Each interval of the table
+  holds the cubic Hermite interpolant of svp_reference() through its
+  end points, built from the values and (one sided) derivatives there,
+  so the interpolant follows the kink at 0 C.  The relative error of
+  the interpolant is below 1e-7 within the table; outside of it
+  svp_fast() falls back to svp_reference().
+**********************************************************************/
+#define SVP_TABLE_TMIN  -100.  /* lowest temperature in the table (C) */
+#define SVP_TABLE_TMAX    60.  /* highest temperature in the table (C) */
+#define SVP_TABLE_STEP   0.25  /* table interval (C), a divisor of TMIN so 0 C is a node */
+#define SVP_TABLE_SIZE ((int)((SVP_TABLE_TMAX - SVP_TABLE_TMIN) / SVP_TABLE_STEP))
+
+class SvpTable {
+public:
+  SvpTable() {
+    for (int i = 0; i < SVP_TABLE_SIZE; i++) {
+      double T0 = SVP_TABLE_TMIN + i * SVP_TABLE_STEP;
+      double T1 = T0 + SVP_TABLE_STEP;
+      // Inside the interval both ends follow the same branch of svp_reference().
+      double f0 = svp_reference(T0);
+      double f1 = svp_reference(T1);
+      double d0 = derivative(T0, T0 < 0) * SVP_TABLE_STEP;
+      double d1 = derivative(T1, T1 <= 0) * SVP_TABLE_STEP;
+      coef[i][0] = f0;
+      coef[i][1] = d0;
+      coef[i][2] = 3. * (f1 - f0) - 2. * d0 - d1;
+      coef[i][3] = 2. * (f0 - f1) + d0 + d1;
+    }
+  }
+  double evaluate(double temp) const {
+    double x = (temp - SVP_TABLE_TMIN) * (1. / SVP_TABLE_STEP);
+    int i = (int)x;
+    if (i >= SVP_TABLE_SIZE) i = SVP_TABLE_SIZE - 1;  // rounding just below TMAX
+    double t = x - i;
+    const double *c = coef[i];
+    return ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+  }
+private:
+  // d(svp_reference)/dT in Pa/C, taking the polynomial correction if frozen.
+  static double derivative(double temp, bool frozen) {
+    double E = A_SVP * exp((B_SVP * temp)/(C_SVP+temp)) * 1000.;
+    double dE = B_SVP * C_SVP / ((C_SVP + temp) * (C_SVP + temp)) * E;
+    if (!frozen) return dE;
+    double P = 1.0 + .00972 * temp + .000042 * temp * temp;
+    return dE * P + E * (.00972 + 2. * .000042 * temp);
+  }
+  double coef[SVP_TABLE_SIZE][4];
+};
+
+static const SvpTable svpTable;
+
+double svp_fast(double temp)
+/**********************************************************************
+  Table lookup version of svp_reference(), see SvpTable above.
+
+  Pressure in Pa
+**********************************************************************/
+{
+  if (temp >= SVP_TABLE_TMIN && temp < SVP_TABLE_TMAX)
+    return svpTable.evaluate(temp);
+  return svp_reference(temp);
+}
+
+#undef SVP_TABLE_TMIN
+#undef SVP_TABLE_TMAX
+#undef SVP_TABLE_STEP
+#undef SVP_TABLE_SIZE
+
+double svp(double temp)
+/**********************************************************************
+  Saturated vapor pressure (Pa), from the table when FAST_SVP is TRUE.
+**********************************************************************/
+{
+#if FAST_SVP
+  return svp_fast(temp);
+#else
+  return svp_reference(temp);
+#endif
+}
+
 double svp_slope(double temp)
 /**********************************************************************
   This routine computes the gradient of d(svp)/dT using Handbook
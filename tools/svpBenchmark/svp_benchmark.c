@@ -0,0 +1,56 @@
+/*
+ * svp_benchmark.c
+ *
+ * Compares the table lookup svp_fast() with svp_reference() (see svp.c):
+ * the largest relative difference, and the time per call of each.  The
+ * relative difference of svp_slope() is the same, as it scales svp().
+ *
+ * Build and run from the source directory, with the same flags as the model:
+ *   g++ -O3 -I. -o svp_benchmark tools/svpBenchmark/svp_benchmark.c svp.c
+ *   ./svp_benchmark
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "vicNl.h"
+
+template <class Function>
+static double seconds_per_call(Function f, const std::vector<double>& temps, int repeats, double *sum) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++)
+    for (unsigned int i = 0; i < temps.size(); i++)
+      *sum += f(temps[i]);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return elapsed / ((double)repeats * temps.size());
+}
+
+int main() {
+
+  /* Accuracy, sampled densely over the range of the table and beyond it */
+  double max_error = 0, max_error_T = 0;
+  for (double temp = -110; temp <= 70; temp += 0.00173) {
+    double ref = svp_reference(temp);
+    double fast = svp_fast(temp);
+    double error = fabs(fast - ref) / ref;
+    if (error > max_error) {
+      max_error = error;
+      max_error_T = temp;
+    }
+  }
+  printf("largest relative difference: %.3e (at %.3f C)\n", max_error, max_error_T);
+
+  /* Speed, for air and surface temperatures typical of the energy balance solvers */
+  std::vector<double> temps;
+  for (int i = 0; i < 4096; i++)
+    temps.push_back(-40. + 75. * ((i * 2654435761u) % 4096) / 4096.);
+  double sum = 0;
+  double reference = seconds_per_call(svp_reference, temps, 2000, &sum);
+  double fast = seconds_per_call(svp_fast, temps, 2000, &sum);
+  printf("svp_reference: %.2f ns/call\nsvp_fast:      %.2f ns/call\nspeedup:       %.2fx\n",
+      reference * 1e9, fast * 1e9, reference / fast);
+  printf("(checksum %g)\n", sum);
+
+  return 0;
+}
@@ -41,12 +41,11 @@
        code *****/
 #define LINK_DEBUG TRUE
 
-/***** If TRUE VIC uses a system of linear equations defined in global.h
-       to estimate the maximum unfrozen water content equation.  This 
-       significantly reduces the run time with frozen soil, but may
-       introduce new errors (STILL UNDER TESTING, ALSO NEEDS DEBUGGING) *****/
-#define QUICK_FS FALSE
-#define QUICK_FS_TEMPS 7
+/***** If TRUE svp() and svp_slope() interpolate the saturated vapor
+       pressure from a table rather than evaluating an exponential on
+       every call (see svp.c).  The relative difference is below 1e-7
+       between -100 and 60 C. *****/
+#define FAST_SVP FALSE
 
 /***** If TRUE VIC uses the linear interpolation of the logarithm of the
        matric potential from the two surrounding layers to estimate the 
@@ -56,10 +55,11 @@
 #define LOW_RES_MOIST FALSE
 
 
-/***** If TRUE VIC does not rewind the vegetation, state, and snow
-       band files before read data for each cell.  This saves time
-       but requires that all grid cells are listed in the same
-       order as the soil parameter file *****/
+/***** If TRUE VIC does not rewind the state file before reading data
+       for each cell.  This saves time but requires that all grid cells
+       are listed in the same order as the soil parameter file.  The
+       vegetation, snow band and lake parameter files are indexed once
+       when they are opened, so they are never rewound. *****/
 #define NO_REWIND FALSE
 
 /***** If TRUE VIC computes the mean, standard deviation, and sum
@@ -228,7 +228,12 @@ void ProgramState:: build_output_variable_mapping() {
 		{"OUT_GLAC_OUTFLOW_BAND",	VariableMetaData("mm", "GLAC_OUTFLOW_BAND", "", "Glacier water outflow", "time: mean area: mean")},
 		{"OUT_GLAC_SUB_BAND",    	VariableMetaData("mm", "GLAC_SUB_BAND", "", "Net sublimation of glacier ice", "time: mean area: mean")},
 		{"OUT_GLAC_DELTACC_BAND", 	VariableMetaData("W m-2", "GLAC_DELTACC_BAND", "", "Rate of change of cold content in glacier surface layer", "time: mean area: mean")},
-		{"OUT_GLAC_FLUX_BAND",     	VariableMetaData("W m-2", "GLAC_FLUX_BAND", "", "Energy flux through glacier surface layer", "time: mean area: mean")}
+		{"OUT_GLAC_FLUX_BAND",     	VariableMetaData("W m-2", "GLAC_FLUX_BAND", "", "Energy flux through glacier surface layer", "time: mean area: mean")},
+		//Solver diagnostics, one value per solver (see SolverStats.h)
+		{"OUT_SOLVER_CALLS",		VariableMetaData("", "SOLVER_CALLS", "", "Count of solver calls", "time: sum")},
+		{"OUT_SOLVER_ITER",		VariableMetaData("", "SOLVER_ITER", "", "Count of solver iterations", "time: sum")},
+		{"OUT_SOLVER_FAIL",		VariableMetaData("", "SOLVER_FAIL", "", "Count of solver calls which failed to converge", "time: sum")},
+		{"OUT_SOLVER_TIME",		VariableMetaData("s", "SOLVER_TIME", "", "Wall time spent in the solver", "time: sum")}
 	};
 }
 
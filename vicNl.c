@@ -4,9 +4,13 @@
 #include "vicNl.h"
 #include "global.h"
 #include "StateIOContext.h"
+#include "StateIOBuffer.h"
+#include "ParamFileIndex.h"
+#include "NetCDFForcingReader.h"
 #include <assert.h>
 #include <omp.h>
 #include <unistd.h>
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -33,6 +37,11 @@ int initializeCell(cell_info_struct& cell,
     filep_struct filep, dmy_struct* dmy, filenames_struct filenames,
     const ProgramState* state);
 
+int forcingWindowRecs(const ProgramState* state);
+
+void loadForcingWindow(cell_info_struct& cell, int firstRec, filep_struct filep, filenames_struct filenames,
+    const dmy_struct* dmy, const ProgramState* state);
+
 int main(int argc, char *argv[])
 /**********************************************************************
 	vicNl.c		Dag Lohmann		January 1996
@@ -138,6 +147,7 @@ int main(int argc, char *argv[])
   OutputData *out_data_list = create_output_list(&state);
   out_data_file_struct *out_data_files = set_output_defaults(out_data_list, &state);
   parse_output_info(filenames.global, out_data_files, out_data_list, &state);
+  state.build_output_plan(out_data_files);
 
   /** Check and Open Files **/
   filep_struct filep = get_files(&filenames, &state);
@@ -165,10 +175,17 @@ int main(int argc, char *argv[])
   initializeNetCDFOutput(&filenames, out_data_files, out_data_list, &state); // Create and initialize a NetCDF output file
   state.initCellMask(cell_data_structs); // Create mask to account for invalid cells included in the output NetCDF spatial domain
 
+  /** Open NetCDF forcing files once for all cells **/
+  for (int file_num = 0; file_num < 2; file_num++) {
+    if (state.param_set.FORCE_FORMAT[file_num] == NETCDF && (file_num == 0 || strcasecmp(filenames.f_path_pfx[1], "MISSING") != 0)) {
+      filep.forcing_reader[file_num] = new NetCDFForcingReader(filenames.f_path_pfx[file_num], file_num, cell_data_structs, &state);
+    }
+  }
+
   if (!state.options.OUTPUT_FORCE) {
     /** Read Grid Cell Vegetation Parameters **/
     for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
-      int numHRUs = read_vegparam(filep.vegparam, cell_data_structs[cellidx], &state);
+      int numHRUs = read_vegparam(filep.vegparam, filep.vegparam_index, cell_data_structs[cellidx], &state);
       if (numHRUs > state.max_num_HRUs) {
       	state.update_max_num_HRUs(numHRUs);
       }
@@ -181,12 +198,12 @@ int main(int argc, char *argv[])
       StateIOContext context(filenames.statefile, StateIO::Writer, &state);
       context.stream->initializeOutput();
     }
-    // Set the number of parallel threads allowed during regular simulation run
-  #if PARALLEL_AVAILABLE
-    omp_set_num_threads(state.global_param.num_threads);
-    omp_set_dynamic(0);
-  #endif
   }
+  // Set the number of parallel threads allowed during the simulation run (or forcing disaggregation)
+#if PARALLEL_AVAILABLE
+  omp_set_num_threads(state.global_param.num_threads);
+  omp_set_dynamic(0);
+#endif
 
   runModel(cell_data_structs, filep, filenames, out_data_files, out_data_list, dmy, &state);
 
@@ -195,14 +212,21 @@ int main(int argc, char *argv[])
   delete [] out_data_files;
   if (!state.options.OUTPUT_FORCE) {
     free_veglib(&state.veg_lib);
+    delete filep.vegparam_index;
     fclose(filep.vegparam);
     fclose(filep.veglib);
-    if (state.options.SNOW_BAND > 1)
+    if (state.options.SNOW_BAND > 1) {
+      delete filep.snowband_index;
       fclose(filep.snowband);
-    if (state.options.LAKES)
+    }
+    if (state.options.LAKES) {
+      delete filep.lakeparam_index;
       fclose(filep.lakeparam);
+    }
   }
   fclose(filep.soilparam);
+  delete filep.forcing_reader[0];
+  delete filep.forcing_reader[1];
 
 #if VERBOSE
   fprintf(stderr, "\nVIC exiting.\n");
@@ -217,8 +241,14 @@ int main(int argc, char *argv[])
 //the amount of RAM available shouldn't be an issue (although it may still take a while).
 void sanityCheckNumberOfCells(const int nCells, const ProgramState* state) {
   double GigsOfRam = state->options.MAX_MEMORY;
-  const double approxBytesPerCell = 96000; //excluding the atmos forcing data
-  double estimatedGigsOfRamUsed = approxBytesPerCell * nCells / (1024 * 1024 * 1024);
+  // The cell and (assuming 20 HRUs per cell) its HRUs, their Nnode soil thermal nodes (see alloc_cell_state()),
+  // and the lake state, which is only allocated for cells with a lake. Excluding the atmos forcing data.
+  const double approxHRUsPerCell = 20;
+  double approxBytesPerCell = sizeof(cell_info_struct) + approxHRUsPerCell * (sizeof(HRU) + energy_nodes_size(state->options.Nnode));
+  if (state->options.LAKES) approxBytesPerCell += sizeof(lake_var_struct) + energy_nodes_size(state->options.Nnode);
+  // The atmos forcing data: one record plus NR+1 values of each variable per time step held in memory (see alloc_atmos())
+  const double atmosBytesPerCell = (double) forcingWindowRecs(state) * (sizeof(atmos_data_struct) + (state->NR + 1) * (11 * sizeof(double) + sizeof(char)));
+  double estimatedGigsOfRamUsed = (approxBytesPerCell + atmosBytesPerCell) * nCells / (1024 * 1024 * 1024);
   if (GigsOfRam == 0.0) {
     fprintf(stderr, "Unlimited memory assumed.\n");
     return;
@@ -292,6 +322,47 @@ void readSoilData(std::vector<cell_info_struct>& cell_data_structs,
   sanityCheckNumberOfCells(cell_data_structs.size(), &state);
 }
 
+// Number of forcing records held in memory for each cell.
+int forcingWindowRecs(const ProgramState* state) {
+  if (state->global_param.forcing_window > 0 && !state->options.OUTPUT_FORCE) {
+    return std::min(state->global_param.nrecs, state->global_param.forcing_window * 24 / state->global_param.dt);
+  }
+  return state->global_param.nrecs;
+}
+
+// Fills cell.atmos with the forcings of the FORCING_WINDOW records starting at firstRec. The forcings are
+// read and disaggregated for the window plus FORCING_WINDOW_MARGIN days on either side (within the
+// simulation), so that MTCLIM's antecedent averages at the start of the window see the preceding days.
+void loadForcingWindow(cell_info_struct& cell, int firstRec, filep_struct filep, filenames_struct filenames,
+    const dmy_struct* dmy, const ProgramState* state) {
+  const int stepsPerDay = 24 / state->global_param.dt;
+  const int windowRecs = std::min(forcingWindowRecs(state), state->global_param.nrecs - firstRec);
+  const int firstPadded = std::max(0, firstRec - FORCING_WINDOW_MARGIN * stepsPerDay);
+  const int endPadded = std::min(state->global_param.nrecs, firstRec + windowRecs + FORCING_WINDOW_MARGIN * stepsPerDay);
+
+  // The padded window is processed as if it were the whole simulation.
+  global_param_struct window_param = state->global_param;
+  window_param.nrecs = endPadded - firstPadded;
+  window_param.startyear = dmy[firstPadded].year;
+  window_param.startmonth = dmy[firstPadded].month;
+  window_param.startday = dmy[firstPadded].day;
+  window_param.starthour = dmy[firstPadded].hour;
+  window_param.forceskip[0] += firstPadded;
+  window_param.forceskip[1] += firstPadded;
+
+  make_in_files(&filep, &filenames, &cell.soil_con, state);
+  atmos_data_struct *padded = alloc_atmos(window_param.nrecs, state->NR);
+  initialize_atmos(padded, &dmy[firstPadded], filep.forcing, filep.forcing_reader, &cell.soil_con, &window_param, state);
+  for (int i = 0; i < 2; i++) {
+    if (filep.forcing[i] != NULL)
+      fclose(filep.forcing[i]);
+  }
+
+  copy_atmos(cell.atmos, &padded[firstRec - firstPadded], windowRecs, state->NR);
+  free_atmos(window_param.nrecs, &padded);
+  cell.atmos_first_rec = firstRec;
+}
+
 int initializeCell(cell_info_struct& cell,
     filep_struct filep, dmy_struct* dmy, filenames_struct filenames,
     const ProgramState* state) {
@@ -303,23 +374,6 @@ int initializeCell(cell_info_struct& cell,
         write_soilparam(&cell.soil_con, state);
   #endif
 
-  #if QUICK_FS
-      /** Allocate Unfrozen Water Content Table **/
-      if(state->options.FROZEN_SOIL) {
-        for(int i=0;i<MAX_LAYERS;i++) {
-          cell.soil_con.ufwc_table_layer[i] = (double **)malloc((QUICK_FS_TEMPS+1)*sizeof(double *));
-          for(int j=0;j<QUICK_FS_TEMPS+1;j++)
-          cell.soil_con.ufwc_table_layer[i][j] = (double *)malloc(2*sizeof(double));
-        }
-        for(int i=0;i<MAX_NODES;i++) {
-          cell.soil_con.ufwc_table_node[i] = (double **)malloc((QUICK_FS_TEMPS+1)*sizeof(double *));
-
-          for(int j=0;j<QUICK_FS_TEMPS+1;j++)
-          cell.soil_con.ufwc_table_node[i][j] = (double *)malloc(2*sizeof(double));
-        }
-      }
-  #endif /* QUICK_FS */
-
   if (!state->options.OUTPUT_FORCE) {
     make_in_files(&filep, &filenames, &cell.soil_con, state);
     calc_root_fractions(cell.prcp.hruList, &cell.soil_con, state);
@@ -329,7 +383,11 @@ int initializeCell(cell_info_struct& cell,
     }
 #endif /* LINK_DEBUG*/
     if (state->options.LAKES) {
-      cell.lake_con = read_lakeparam(filep.lakeparam, cell.soil_con, cell.prcp.hruList, state);
+      // The parameter files are shared by all cells: seek to and read a record in one go.
+#if PARALLEL_AVAILABLE
+#pragma omp critical(param_files)
+#endif
+      cell.lake_con = read_lakeparam(filep.lakeparam, filep.lakeparam_index, cell.soil_con, cell.prcp.hruList, state);
     }
   }
   else if (state->options.OUTPUT_FORCE) {
@@ -337,7 +395,10 @@ int initializeCell(cell_info_struct& cell,
   }
   if (!state->options.OUTPUT_FORCE) {
     /** Read Elevation Band Data if Used **/
-    read_snowband(filep.snowband, &cell.soil_con, state->options.SNOW_BAND);
+#if PARALLEL_AVAILABLE
+#pragma omp critical(param_files)
+#endif
+    read_snowband(filep.snowband, filep.snowband_index, &cell.soil_con, state->options.SNOW_BAND);
   }
       /**************************************************
        Initialize Meteorological Forcing Values That
@@ -348,12 +409,17 @@ int initializeCell(cell_info_struct& cell,
 #endif
 // NOTE: this should only be done for valid cells
   /** allocate memory for the atmos_data_struct **/
-  cell.atmos = alloc_atmos(state->global_param.nrecs, state->NR);
-  initialize_atmos(cell.atmos, dmy, filep.forcing, filep.forcing_ncid, &cell.soil_con, state);
+  cell.atmos = alloc_atmos(forcingWindowRecs(state), state->NR);
+  if (state->global_param.forcing_window > 0 && !state->options.OUTPUT_FORCE) {
+    loadForcingWindow(cell, 0, filep, filenames, dmy, state);
+  }
+  else {
+    initialize_atmos(cell.atmos, dmy, filep.forcing, filep.forcing_reader, &cell.soil_con, &state->global_param, state);
+  }
 
 #if LINK_DEBUG
   if (state->debug.PRT_ATMOS)
-    write_atmosdata(cell.atmos, state->global_param.nrecs, state);
+    write_atmosdata(cell.atmos, forcingWindowRecs(state), state);
 #endif
   cell.writeDebug.initialize(cell.prcp.hruList.size(), state);
   /**************************************************
@@ -363,22 +429,25 @@ int initializeCell(cell_info_struct& cell,
 #if VERBOSE
     fprintf(stderr, "\nInitialising Model State\n");
 #endif
+	  alloc_cell_state(&cell, state);
 	  int ErrorFlag = initialize_model_state(&cell, dmy[0], filep, Ndist, filenames.init_state, state);
 
+	  // Cells may be initialized in parallel: the error is left in cell.ErrStr for the caller to report.
 	  if (ErrorFlag == ERROR) {
+		char ErrStr[MAXSTRING];
 		if (state->options.CONTINUEONERROR == TRUE) {
 		  // Handle grid cell solution error
-		  fprintf(stderr,
+		  sprintf(ErrStr,
 			  "Error initializing the model state (energy balance, water balance, and snow components) for cell %d (method initialize_model_state).  Cell has been marked as invalid and will be skipped for remainder of model run.\n",
 			  cell.soil_con.gridcel);
-		  return ERROR;
 		} else {
 		  // Else exit program on cell solution error as in previous versions
-		  sprintf(cell.ErrStr,
+		  sprintf(ErrStr,
 			  "Error initializing cell %d (method initialize_model_state).  Check your inputs before rerunning the simulation.  Exiting.\n",
 			  cell.soil_con.gridcel);
-		  vicerror(cell.ErrStr);
 		}
+		cell.ErrStr = ErrStr;
+		return ERROR;
 	  }
   }
       return 0;
@@ -394,9 +463,8 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
 
 	// Create vector for holding output data from one time iteration for all cells.
 	std::vector<OutputData*> current_output_data;
-	bool output_data_allocated = false;
 
-	// outputwriter takes care of writing all cells' data at a given time step. Only used if OUTPUT_FORCE=FALSE
+	// outputwriter takes care of writing all cells' data at a given time step, or each cell's chunks of time steps if OUTPUT_FORCE=TRUE
 	WriteOutputNetCDF *outputwriter = new WriteOutputNetCDF(state);
 	outputwriter->openFile();
 
@@ -404,10 +472,9 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
 	/* Performance timing variables can be printed to console:
 	 * elapsed_total = (end - start) measures total time from cells initialization to program completion (just before memory clean-up).
 	 * elapsed_init = (init_end - init_start) measures time spent in cells initialization
-	 * elapsed_cell = (cell_start - cell_end), measures time spent processing one cell when OUTPUT_FORCE=TRUE
 	 */
-  std::chrono::time_point<std::chrono::system_clock> start, end, init_start, init_end, cell_start, cell_end;
-  std::chrono::duration<double> elapsed_init, elapsed_cell, elapsed_total;
+  std::chrono::time_point<std::chrono::system_clock> start, end, init_start, init_end;
+  std::chrono::duration<double> elapsed_init, elapsed_total;
 	if (!state->options.OUTPUT_FORCE) {
 		init_start = std::chrono::system_clock::now();
 	}
@@ -417,79 +484,124 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
 #endif
 
   // Initializations
-  for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
-		if (state->options.OUTPUT_FORCE) {
-			init_start = std::chrono::system_clock::now();
-		}
+  if (!state->options.OUTPUT_FORCE) {
+    for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
+      // Copy the format of the out_data_files_template and allocate in cell_data_structs[cellidx].outputFormat->dataFiles
+      copy_data_file_format(out_data_files_template, cell_data_structs[cellidx].outputFormat->dataFiles, state);
 
-		// Read in forcings, veg params, snowband, atmospheric forcings, and initial state (if applicable) for this cell
-  	int initError = 0;
-    initError = initializeCell(cell_data_structs[cellidx], filep, dmy, filenames, state);
-    if (initError == ERROR) {
-  	  cell_data_structs[cellidx].isValid = FALSE;
-    }
+      /* Create output filename(s), and open (if already created, just open for appending).
+         ASCII/binary output format will make two files per grid cell; NetCDF will make one file to rule them all */
+      make_out_files(&filep, &filenames, &cell_data_structs[cellidx].soil_con, cell_data_structs[cellidx].outputFormat, state);
 
-    // Copy the format of the out_data_files_template and allocate in cell_data_structs[cellidx].outputFormat->dataFiles
-    copy_data_file_format(out_data_files_template, cell_data_structs[cellidx].outputFormat->dataFiles, state);
+      /* Copy the format of the out_data_list (which is specific to this model run) and allocate space elements of
+         current_output_data for this cell's output data */
+      // allocating one current_output_data vector element per cell (i.e. we write once per time step)
+      copy_output_data(current_output_data, out_data_list, state);
+    }
 
-    /* Create output filename(s), and open (if already created, just open for appending).
-       ASCII/binary output format will make two files per grid cell; NetCDF will make one file to rule them all */
-    make_out_files(&filep, &filenames, &cell_data_structs[cellidx].soil_con, cell_data_structs[cellidx].outputFormat, state);
+    /* Read in forcings, veg params, snowband, atmospheric forcings, and initial state (if applicable) for all cells.
+       The cells are independent, so this is done in parallel (unless the input debug files are written, which are
+       shared by the cells). Errors are reported afterwards in cell order, so the log does not depend on the threads. */
+    std::vector<char> initFailed(cell_data_structs.size(), FALSE);
+    bool parallelInit = true;
+#if LINK_DEBUG
+    parallelInit = !(state->debug.PRT_SOIL || state->debug.PRT_VEGE || state->debug.PRT_ATMOS);
+#endif
+#if PARALLEL_AVAILABLE
+#pragma omp parallel for schedule(dynamic) if(parallelInit)
+#endif
+    for (int cellidx = 0; cellidx < (int)cell_data_structs.size(); cellidx++) {
+      if (initializeCell(cell_data_structs[cellidx], filep, dmy, filenames, state) == ERROR)
+        initFailed[cellidx] = TRUE;
+    }
 
-    /* Copy the format of the out_data_list (which is specific to this model run) and allocate space elements of
-       current_output_data for this cell's output data */
-    if (!state->options.OUTPUT_FORCE) {
-    	// allocating one current_output_data vector element per cell (i.e. we write once per time step)
-    	copy_output_data(current_output_data, out_data_list, state);
+    for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
+      if (initFailed[cellidx]) {
+        cell_data_structs[cellidx].isValid = FALSE;
+        if (state->options.CONTINUEONERROR == TRUE)
+          fprintf(stderr, "%s", cell_data_structs[cellidx].ErrStr.c_str());
+        else
+          vicerror(cell_data_structs[cellidx].ErrStr.c_str());
+      }
+    }
+  }
+  else {
+    /* If OUTPUT_FORCE is set to TRUE in the global parameters file then the full disaggregated
+       forcing data array is written to file(s), and the full model run is skipped.
+       The cells are disaggregated in parallel. Each thread gathers a chunk of time steps of its current
+       cell in its own output data, and the chunks are written by the one output writer, one at a time
+       (the netCDF library is not thread safe). */
+    bool parallelDisagg = true;
+#if LINK_DEBUG
+    parallelDisagg = !(state->debug.PRT_SOIL || state->debug.PRT_ATMOS);
+#endif
+#if PARALLEL_AVAILABLE
+    const int numThreads = parallelDisagg ? omp_get_max_threads() : 1;
+#else
+    const int numThreads = 1;
+#endif
+    // allocate the output data elements of each thread for write-out of a chunk of time steps
+    std::vector<std::vector<OutputData*> > thread_output_data(numThreads);
+    for (int thread = 0; thread < numThreads; thread++) {
+      for (int i = 0; i < state->global_param.disagg_write_chunk_size; i++) {
+        copy_output_data(thread_output_data[thread], out_data_list, state);
+      }
     }
-    else {
-    	/* If OUTPUT_FORCE is set to TRUE in the global parameters file then the full disaggregated
-  	   forcing data array is written to file(s), and the full model run is skipped. */
-    	if (!output_data_allocated) {
-    		// allocate current_output_data vector elements for write-out of a chunk of time steps'
-    		for (int i = 0; i < state->global_param.disagg_write_chunk_size; i++){
-    			copy_output_data(current_output_data, out_data_list, state);
-    		}
-    		output_data_allocated = true;
-    	}
 
+#if PARALLEL_AVAILABLE
+#pragma omp parallel for schedule(dynamic) if(parallelDisagg)
+#endif
+    for (int cellidx = 0; cellidx < (int)cell_data_structs.size(); cellidx++) {
+      cell_info_struct& cell = cell_data_structs[cellidx];
+#if PARALLEL_AVAILABLE
+      std::vector<OutputData*>& chunk_output_data = thread_output_data[omp_get_thread_num()];
+#else
+      std::vector<OutputData*>& chunk_output_data = thread_output_data[0];
+#endif
 #if VERBOSE
-		  init_end = std::chrono::system_clock::now();
-		  elapsed_init = init_end - init_start;
-		  fprintf(stderr, "Elapsed time loading input forcings and allocating memory for this cell: %.3f seconds\n",  elapsed_init.count());
-		  fprintf(stderr, "Writing to output forcing file...\n");
-			cell_start = std::chrono::system_clock::now();
+      std::chrono::time_point<std::chrono::system_clock> disagg_start = std::chrono::system_clock::now();
 #endif
-		  int chunk_step_count = 0; // count how many time steps' output have been chunked together for write out
-		  int chunk_start_rec = 0;
-		  for (int rec = 0; rec < state->global_param.nrecs; rec++) {
-				// copy forcing data to current_output_data for writeout (write_forcing_file does not actually write anything to file)
-				write_forcing_file(&cell_data_structs[cellidx], rec, cell_data_structs[cellidx].outputFormat, current_output_data[chunk_step_count], state, dmy);
-				chunk_step_count++;
-		  	if (rec >= state->global_param.nrecs-1) { // write this last output data chunk to disk (handles case if chunk_size does not divide evenly into nrecs)
-		  		cell_data_structs[cellidx].outputFormat->write_data_one_cell(current_output_data, out_data_files_template, chunk_start_rec, state->global_param.nrecs-chunk_start_rec, state);
-		  	}
-		  	else if (chunk_step_count >= state->global_param.disagg_write_chunk_size) { // write this output data chunk to disk
-		  		cell_data_structs[cellidx].outputFormat->write_data_one_cell(current_output_data, out_data_files_template, chunk_start_rec, state->global_param.disagg_write_chunk_size, state);
-		  		chunk_step_count = 0;
-		  		chunk_start_rec = rec+1;
-		  	}
-		  	else if (chunk_step_count < state->global_param.disagg_write_chunk_size) { // don't write anything out; just add this chunk to current_output_data
-		  	  continue;
-		  	}
-		  }
-		  // Free all memory allocated for processing this cell
-		  free_atmos(state->global_param.nrecs, &cell_data_structs[cellidx].atmos);
-		  delete cell_data_structs[cellidx].outputFormat;
+
+      // Read in and disaggregate the forcings for this cell
+      if (initializeCell(cell, filep, dmy, filenames, state) == ERROR)
+        cell.isValid = FALSE;
+
+      int chunk_step_count = 0; // count how many time steps' output have been chunked together for write out
+      int chunk_start_rec = 0;
+      for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+        // copy forcing data to chunk_output_data for writeout (write_forcing_file does not actually write anything to file)
+        write_forcing_file(&cell, rec, cell.outputFormat, chunk_output_data[chunk_step_count], state, dmy);
+        chunk_step_count++;
+        // write the output data chunk to disk when it is full, or at the last time step (chunk_size need not divide evenly into nrecs)
+        if (chunk_step_count >= state->global_param.disagg_write_chunk_size || rec >= state->global_param.nrecs-1) {
+#if PARALLEL_AVAILABLE
+#pragma omp critical(netcdf_forcing)
+#endif
+          {
+            outputwriter->lat = cell.soil_con.lat;
+            outputwriter->lon = cell.soil_con.lng;
+            outputwriter->write_data_one_cell(chunk_output_data, out_data_files_template, chunk_start_rec, chunk_step_count, state);
+          }
+          chunk_step_count = 0;
+          chunk_start_rec = rec+1;
+        }
+      }
+      // Free all memory allocated for processing this cell
+      free_atmos(state->global_param.nrecs, &cell.atmos);
+      delete cell.outputFormat;
 
 #if VERBOSE
-		  cell_end = std::chrono::system_clock::now();
-		  elapsed_cell = cell_end - cell_start;
-		  fprintf(stderr, "Done. Elapsed time generating and writing forcings for this cell: %.3f seconds\n", elapsed_cell.count());
+      std::chrono::duration<double> elapsed_disagg = std::chrono::system_clock::now() - disagg_start;
+      fprintf(stderr, "Done. Elapsed time generating and writing forcings for cell %d: %.3f seconds\n", cell.soil_con.gridcel, elapsed_disagg.count());
 #endif
-	  }
+    }
 
-  } // for - grid cell loop
+    for (int thread = 0; thread < numThreads; thread++) {
+      for (unsigned int i = 0; i < thread_output_data[thread].size(); i++) {
+        delete [] thread_output_data[thread][i];
+      }
+    }
+  } // if - OUTPUT_FORCE
 
   if (!state->options.OUTPUT_FORCE) {
 	  init_end = std::chrono::system_clock::now();
@@ -500,118 +612,200 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
 #endif
       start = std::chrono::system_clock::now();
   }
+  // One buffer per thread to gather the model state of each cell on the state date, so that the
+  // state file is written all at once instead of one cell at a time.
+#if PARALLEL_AVAILABLE
+  std::vector<StateIOBuffer> stateBuffers(omp_get_max_threads(), StateIOBuffer(state));
+#else
+  std::vector<StateIOBuffer> stateBuffers(1, StateIOBuffer(state));
+#endif
+  // Hands out the cells to the threads by decreasing cost.
+  CellScheduler scheduler(cell_data_structs, state);
+
+  /* Each cell is advanced by a block of TIME_BLOCK time steps (0 = the output interval) before the thread
+     moves on to the next cell, so the state of the cell stays in the cache from one step to the next, and
+     the threads meet once per block instead of once per time step. A block ends early where the forcings
+     of the next window are loaded and after the record at which the model state is saved. */
+  const int blockRecs = state->global_param.time_block > 0 ? state->global_param.time_block : state->out_step_ratio;
+  const int windowRecs = forcingWindowRecs(state);
+
+  /* Save model state at assigned date
+     (after the final time step of the assigned date) */
+  int stateRec = -1;
+  for (int rec = 0; state->options.SAVE_STATE == TRUE && rec < state->global_param.nrecs; rec++) {
+    if (dmy[rec].year == state->global_param.stateyear
+        && dmy[rec].month == state->global_param.statemonth
+        && dmy[rec].day == state->global_param.stateday
+        && (rec + 1 == state->global_param.nrecs
+        || dmy[rec + 1].day != state->global_param.stateday)) {
+      stateRec = rec;
+      break;
+    }
+  }
+
+  // The output of a block may span several output intervals (OUT_STEP): each cell aggregates the output
+  // of each interval in its own set of output data, and the completed intervals are written after the block.
+  // output_records[0] holds the output interval in which the block starts.
+  std::vector<std::vector<OutputData*> > output_records(1);
+  output_records[0].swap(current_output_data);
+  if (!state->options.OUTPUT_FORCE) {
+    const int numOutputRecords = (blockRecs + state->out_step_ratio - 2) / state->out_step_ratio + 1;
+    output_records.resize(numOutputRecords);
+    for (int i = 1; i < numOutputRecords; i++) {
+      for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
+        copy_output_data(output_records[i], out_data_list, state);
+      }
+    }
+  }
+
   /********************************************************
-     Run Model for all Grid Cells, one Time Step at a time
+     Run Model for all Grid Cells, one block of Time Steps at a time
   ********************************************************/
-  for (int rec = 0; rec < state->global_param.nrecs; rec++) {
+  for (int blockStart = 0, blockEnd = 0; blockStart < state->global_param.nrecs; blockStart = blockEnd) {
 
   	// If OUTPUT_FORCE=TRUE then we have already generated disaggregated meteorological forcings above, and can exit
   	if (state->options.OUTPUT_FORCE) break;
 
-  	// Increment the intra-record time step count (important when writing out at lower frequency than the simulation time step)
-    if (rec >= 0) (state->step_count)++;
+    blockEnd = std::min(state->global_param.nrecs, blockStart + blockRecs);
+    blockEnd = std::min(blockEnd, (blockStart / windowRecs + 1) * windowRecs);
+    if (stateRec >= blockStart && stateRec < blockEnd) blockEnd = stateRec + 1;
+
+    // Forcings are streamed a window at a time when FORCING_WINDOW is set.
+    bool loadForcings = (blockStart > 0 && blockStart % windowRecs == 0);
+    bool saveState = (stateRec == blockEnd - 1);
+    const int firstOutputRecord = blockStart / state->out_step_ratio;
+
+    // The netCDF library is not thread safe: let the output writer thread finish before forcings are read.
+    if (loadForcings) outputwriter->waitForWrites();
 
 #if PARALLEL_AVAILABLE
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 #endif
-    for (unsigned int cellidx = 0; cellidx < cell_data_structs.size(); cellidx++) {
+    for (int i = 0; i < scheduler.size(); i++) {
+      const int cellidx = scheduler.cell(i);
       //printThreadInformation();
 
-      // If this cell has been deemed invalid due to an error in an earlier time step, we don't process it.
-      if (cell_data_structs[cellidx].isValid == FALSE) continue;
+      std::chrono::steady_clock::time_point cell_start = std::chrono::steady_clock::now();
+
+      for (int rec = blockStart; rec < blockEnd; rec++) {
+
+        // If this cell has been deemed invalid due to an error in an earlier time step, we don't process it.
+        if (cell_data_structs[cellidx].isValid == FALSE) break;
+
+        OutputData* out_data = output_records[rec / state->out_step_ratio - firstOutputRecord][cellidx];
+
+        // Initialize storage terms on first time step
+        if (rec == 0) {
+          // Initialize the storage terms in the water and energy balances
+          int putDataError = put_data(&cell_data_structs[cellidx], cell_data_structs[cellidx].outputFormat, out_data, &dmy[0],
+                  		-state->global_param.nrecs, state);
+
+          // Skip the rest of this cell if there is an error here.
+          if (putDataError == ERROR) {
+          	cell_data_structs[cellidx].isValid = FALSE;
+            if (state->options.CONTINUEONERROR == TRUE) {
+              fprintf(stderr, "Error initializing storage terms for cell %d (method put_data).  Cell has been marked as invalid and will be skipped for remainder of model run.\n", cell_data_structs[cellidx].soil_con.gridcel);
+              continue;
+            }
+            else {
+              char ErrStr[MAXSTRING];
+              sprintf(ErrStr, "Error initializing storage terms for cell %d (method put_data).  Exiting.\n", cell_data_structs[cellidx].soil_con.gridcel);
+              vicerror(ErrStr);
+            }
+          }
+        }
 
-      // Initialize storage terms on first time step
-      if (rec == 0) {
-        // Initialize the storage terms in the water and energy balances
-        int putDataError = put_data(&cell_data_structs[cellidx], cell_data_structs[cellidx].outputFormat, current_output_data[cellidx], &dmy[0],
-                		-state->global_param.nrecs, state);
+        if (loadForcings && rec == blockStart) {
+          loadForcingWindow(cell_data_structs[cellidx], rec, filep, filenames, dmy, state);
+        }
+
+        // Solver counts are kept per thread; start them fresh so put_data() attributes them to this cell.
+        SolverStats::current.reset();
 
-        // Skip the rest of this cell if there is an error here.
-        if (putDataError == ERROR) {
+        int distPrecError = dist_prec(&cell_data_structs[cellidx], dmy, &filep, cell_data_structs[cellidx].outputFormat, out_data, rec, FALSE, state);
+
+        if (distPrecError == ERROR) {
         	cell_data_structs[cellidx].isValid = FALSE;
           if (state->options.CONTINUEONERROR == TRUE) {
-            fprintf(stderr, "Error initializing storage terms for cell %d (method put_data).  Cell has been marked as invalid and will be skipped for remainder of model run.\n", cell_data_structs[cellidx].soil_con.gridcel);
-            continue;
-          }
-          else {
-            sprintf(cell_data_structs[cellidx].ErrStr, "Error initializing storage terms for cell %d (method put_data).  Exiting.\n", cell_data_structs[cellidx].soil_con.gridcel);
-            vicerror(cell_data_structs[cellidx].ErrStr);
+            // Handle grid cell solution error
+            fprintf(stderr,
+                "Error processing cell %d (method dist_prec) at record (time step) %d.  Cell has been marked as invalid and will be skipped for remainder of model run.  An incomplete output file has been generated, check your inputs before re-running the simulation.\n",
+                cell_data_structs[cellidx].soil_con.gridcel, rec);
+          } else {
+            // Else exit program on cell solution error as in previous versions
+            char ErrStr[MAXSTRING];
+            sprintf(ErrStr,
+                "Error processing cell %d (method dist_prec) at record (time step) %d so the simulation has ended. Check your inputs before re-running the simulation.\n",
+                cell_data_structs[cellidx].soil_con.gridcel, rec);
+            vicerror(ErrStr);
           }
         }
-      }
 
-      int distPrecError = dist_prec(&cell_data_structs[cellidx], dmy, &filep, cell_data_structs[cellidx].outputFormat, current_output_data[cellidx], rec, FALSE, state);
-
-      if (distPrecError == ERROR) {
-      	cell_data_structs[cellidx].isValid = FALSE;
-        if (state->options.CONTINUEONERROR == TRUE) {
-          // Handle grid cell solution error
-          fprintf(stderr,
-              "Error processing cell %d (method dist_prec) at record (time step) %d.  Cell has been marked as invalid and will be skipped for remainder of model run.  An incomplete output file has been generated, check your inputs before re-running the simulation.\n",
-              cell_data_structs[cellidx].soil_con.gridcel, rec);
-        } else {
-          // Else exit program on cell solution error as in previous versions
-          sprintf(cell_data_structs[cellidx].ErrStr,
-              "Error processing cell %d (method dist_prec) at record (time step) %d so the simulation has ended. Check your inputs before re-running the simulation.\n",
-              cell_data_structs[cellidx].soil_con.gridcel, rec);
-          vicerror(cell_data_structs[cellidx].ErrStr);
-        }
-      }
-
-      // FIXME: should accumulateGlacierMassBalance have error checking?
-      if (cell_data_structs[cellidx].isValid)
-        accumulateGlacierMassBalance(&(cell_data_structs[cellidx].gmbEquation), dmy, rec, &(cell_data_structs[cellidx].prcp), &(cell_data_structs[cellidx].soil_con), state);
+        // FIXME: should accumulateGlacierMassBalance have error checking?
+        if (cell_data_structs[cellidx].isValid)
+          accumulateGlacierMassBalance(&(cell_data_structs[cellidx].gmbEquation), dmy, rec, &(cell_data_structs[cellidx].prcp), &(cell_data_structs[cellidx].soil_con), state);
 
+        /************************************
+         Gather model state at assigned date
+         ************************************/
+        if (rec == stateRec) {
 #if PARALLEL_AVAILABLE
-#pragma omp critical(write_state)
+          StateIOBuffer& stateBuffer = stateBuffers[omp_get_thread_num()];
+#else
+          StateIOBuffer& stateBuffer = stateBuffers[0];
 #endif
-      /************************************
-       Save model state at assigned date
-       (after the final time step of the assigned date)
-       ************************************/
-      if (state->options.SAVE_STATE == TRUE
-          && (dmy[rec].year == state->global_param.stateyear
-          && dmy[rec].month == state->global_param.statemonth
-          && dmy[rec].day == state->global_param.stateday
-          && (rec + 1 == state->global_param.nrecs
-          || dmy[rec + 1].day != state->global_param.stateday)))
-      {
-        write_model_state(&cell_data_structs[cellidx], filenames.statefile, state);
-      }
-
-#if QUICK_FS
-      if(options.FROZEN_SOIL) {
-        for(int i=0;i<MAX_LAYERS;i++) {
-          for(int j=0;j<6;j++)
-          free((char *)cell_data_structs[cellidx].soil_con.ufwc_table_layer[i][j]);
-          free((char *)cell_data_structs[cellidx].soil_con.ufwc_table_layer[i]);
+          stateBuffer.beginCell(cellidx);
+          write_model_state(&cell_data_structs[cellidx], &stateBuffer, state);
         }
-        for(int i=0;i<MAX_NODES;i++) {
-          for(int j=0;j<6;j++)
-          free((char *)cell_data_structs[cellidx].soil_con.ufwc_table_node[i][j]);
-          free((char *)cell_data_structs[cellidx].soil_con.ufwc_table_node[i]);
-        }
-      }
-#endif /* QUICK_FS */
+      } // for - time steps of the block
+
+      scheduler.record(cellidx, std::chrono::duration<double>(std::chrono::steady_clock::now() - cell_start).count());
     } // for - grid cell loop
 
-    // Write output data for all cells to file if we have completed an output interval (OUT_STEP)
-    if((rec >= state->global_param.skipyear) && (state->step_count == state->out_step_ratio)) {
-    	outputwriter->write_data_all_cells(current_output_data, out_data_files_template, rec/state->out_step_ratio, state);
+    scheduler.update(blockEnd - 1);
+
+    if (saveState) {
+      outputwriter->waitForWrites();
+      write_buffered_model_state(stateBuffers, filenames.statefile, state);
+    }
+
+    // Write output data for all cells to file for each output interval (OUT_STEP) completed in this block
+    int outputRecord = firstOutputRecord;
+    for (; (outputRecord + 1) * state->out_step_ratio <= blockEnd; outputRecord++) {
+      std::vector<OutputData*>& record_output_data = output_records[outputRecord - firstOutputRecord];
+      if ((outputRecord + 1) * state->out_step_ratio - 1 >= state->global_param.skipyear) {
+        outputwriter->write_data_all_cells(record_output_data, out_data_files_template, outputRecord, state);
+      }
 
       // Reset the aggdata for all variables (even those not necessarily being written, as some variables' aggdata values are derived from other variables)
-    	for (int var_idx=0; var_idx<N_OUTVAR_TYPES; var_idx++) {
-    		for (unsigned int cell_idx = 0; cell_idx < current_output_data.size(); cell_idx++) {
-    			for (int elem=0; elem<out_data_list[var_idx].nelem; elem++) {
-    				current_output_data[cell_idx][var_idx].aggdata[elem] = 0;
-    			}
-    		}
-    	}
-		  // Reset the step count
-			state->step_count = 0;
+#if PARALLEL_AVAILABLE
+#pragma omp parallel for
+#endif
+      for (unsigned int cell_idx = 0; cell_idx < record_output_data.size(); cell_idx++) {
+        for (int var_idx=0; var_idx<N_OUTVAR_TYPES; var_idx++) {
+          for (int elem=0; elem<out_data_list[var_idx].nelem; elem++) {
+            record_output_data[cell_idx][var_idx].aggdata[elem] = 0;
+          }
+        }
+      }
+    }
+    // The output interval still being aggregated is continued by the next block.
+    if (outputRecord > firstOutputRecord && outputRecord * state->out_step_ratio < blockEnd) {
+      output_records[0].swap(output_records[outputRecord - firstOutputRecord]);
     }
   } // for - time loop
 
+  for (unsigned int i = 0; i < output_records.size(); i++) {
+    for (unsigned int cellidx = 0; cellidx < output_records[i].size(); cellidx++) {
+      delete [] output_records[i][cellidx];
+    }
+  }
+
+	// Write the output records still held in the output buffers, and stop the output writer thread.
+	outputwriter->flush();
+
+	if (!state->options.OUTPUT_FORCE) print_solver_summary(cell_data_structs);
+
 //	delete outputwriter;
 
 	end = std::chrono::system_clock::now();
@@ -628,9 +822,13 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
 #else
 		fprintf(stderr, "\nVIC model run done. Model execution time (serial): %.3f seconds\n", elapsed_total.count());
 #endif
-	} // Disagg mode does not use multithreading
+	}
 	else {
+#if PARALLEL_AVAILABLE
+		fprintf(stderr, "\nVIC disaggregated forcings generation done. Total processing time (%d threads): %.3f seconds\n", state->global_param.num_threads, elapsed_total.count());
+#else
 		fprintf(stderr, "\nVIC disaggregated forcings generation done. Total processing time (serial): %.3f seconds\n", elapsed_total.count());
+#endif
 	}
 #endif // VERBOSE
 
@@ -644,6 +842,7 @@ void runModel(std::vector<cell_info_struct>& cell_data_structs,
     if (!state->options.OUTPUT_FORCE) { // this will have been already freed otherwise
     	free_atmos(state->global_param.nrecs, &cell_data_structs[cellidx].atmos);
     	delete cell_data_structs[cellidx].outputFormat;
+    	free_cell_state(&cell_data_structs[cellidx]);
     }
     free_vegcon(cell_data_structs[cellidx]);
     free(cell_data_structs[cellidx].soil_con.AreaFract);
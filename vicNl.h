@@ -116,6 +116,8 @@
 #include "SnowPackEnergyBalance.h"
 #include "StateIO.h"
 #include "VegConditions.h"
+#include "EnergyWorkspace.h"
+#include "CellScheduler.h"
 #include "WriteOutputContext.h"
 #include "OutputData.h"
 
@@ -123,6 +125,8 @@
 void accumulateGlacierMassBalance(GraphingEquation* gmbEquation, const dmy_struct* dmy, int rec, dist_prcp_struct* prcp, const soil_con_struct* soil, ProgramState* state);
 double advected_sensible_heat(double, double, double, double, double);
 atmos_data_struct * alloc_atmos(int, int);
+void alloc_cell_state(cell_info_struct *, const ProgramState *);
+char * attach_energy_nodes(energy_bal_struct *, char *, int);
 double arno_evap(layer_data_struct *, layer_data_struct *, double, double, 
 		 double, double, double, double, double, double, double, double, double, const double *, const ProgramState*);
 
@@ -152,7 +156,7 @@ double calc_snow_ground_flux(int, int, int, int, double, double, double,
 int calc_soil_thermal_fluxes(int, double *, double *, char *, int *, double *,
     const double *, double *, const double *, const double *, const double *,
     const double *, double *, double *, double *, double *, double *,
-    double ** const *, int, int, int, int, const ProgramState*);
+    const UfwcTable * const *, int, int, int, int, const ProgramState*);
 
 double CalcBlowingSnow(double Dt, double Tair, int LastSnow,
     double SurfaceLiquidWater, double Wind, double Ls, double AirDens,
@@ -211,7 +215,7 @@ void collect_eb_terms(const energy_bal_struct& energy,
     OutputData *out_data, const ProgramState* state);
 void collect_wb_terms(const hru_data_struct& cell,
     const veg_var_struct& veg_var, const snow_data_struct& snow,
-    const glac_data_struct& glacier, const lake_var_struct& lake_var,
+    const glac_data_struct& glacier,
     double precipitation_mu, double Cv,
     double TreeAdjustFactor, bool HasVeg, bool HasGlac, bool IsWet,
     double lakefactor, int overstory, double *depth, double *frost_fract,
@@ -224,6 +228,7 @@ void   compute_runoff_and_asat(const soil_con_struct *, double *, double, double
 void   compute_soil_layer_thermal_properties(layer_data_struct *, const soil_con_struct*, int);
 void   compute_treeline(atmos_data_struct *, const dmy_struct *, double, double *, char *, const ProgramState*);
 double compute_zwt(const soil_con_struct *, int, double);
+void   copy_atmos(atmos_data_struct *, const atmos_data_struct *, int, int);
 void copy_output_data(std::vector<OutputData*>&current_output_data, OutputData *out_data_list, const ProgramState *state);
 
 OutputData *create_output_list(const ProgramState*);
@@ -239,6 +244,7 @@ void   distribute_soil_property(double *,double,double,
 				double **l_param,
 				int, int, double *, double *);
 
+size_t energy_nodes_size(int);
 double error_print_atmos_energy_bal(double Tcanopy, double LatentHeat,
     double NetRadiation, double Ra, double Tair, double atmos_density,
     double InSensible, double *SensibleHeat, char *ErrorString);
@@ -337,6 +343,7 @@ layer_data_struct find_average_layer(layer_data_struct *, layer_data_struct *,
 void   find_sublayer_temperatures(layer_data_struct *, double *, double *,
 				  double *, double, double, int, int);
 void   free_atmos(int nrecs, atmos_data_struct **atmos);
+void   free_cell_state(cell_info_struct *cell);
 void   free_dmy(dmy_struct **dmy);
 void   free_vegcon(cell_info_struct& cell);
 void   free_veglib(veg_lib_struct **);
@@ -359,9 +366,10 @@ void   HourlyT(int, int, int *, double *, int *, double *, double *);
 void copy_data_file_format(const out_data_file_struct* out_template, std::vector<out_data_file_struct*>& list, const ProgramState* state);
 void copy_output_format(const WriteOutputFormat* context, std::vector<WriteOutputFormat*>& format, const ProgramState* state);
 void   init_output_list(OutputData *, int, const char *, int, float);
-void   initialize_atmos(atmos_data_struct *, const dmy_struct *, FILE **, int *ncids, soil_con_struct *, const ProgramState*);
+void   initialize_atmos(atmos_data_struct *, const dmy_struct *, FILE **, NetCDFForcingReader **, soil_con_struct *, const global_param_struct *, const ProgramState*);
 
 int initialize_model_state(cell_info_struct*, dmy_struct, filep_struct, int, const char*, const ProgramState *);
+void update_active_hrus(dist_prcp_struct *, const soil_con_struct *, const ProgramState *);
 
 int    initialize_new_storm(HRU&, int, double, const ProgramState*);
 void   initialize_snow(std::vector<HRU>&);
@@ -385,7 +393,8 @@ void make_in_files(filep_struct *, filenames_struct *, soil_con_struct *, const
 void make_out_files(filep_struct *, filenames_struct *, soil_con_struct *, WriteOutputFormat *, const ProgramState*);
 void   MassRelease(double *,double *,double *,double *);
 double maximum_unfrozen_water(double, double, double, double);
-double maximum_unfrozen_water_quick(double, double, double **);
+double maximum_unfrozen_water_dT(double, double, double, double);
+double maximum_unfrozen_water_quick(double, double, const UfwcTable *);
 double modify_Ksat(double, const ProgramState*);
 void mtclim_wrapper(int, int, double, const soil_con_struct*,
                     int, /* MPN: separate instance; should probably be const */ dmy_struct *, double *,
@@ -400,19 +409,20 @@ void parse_output_info(const char*, out_data_file_struct *, OutputData *, Progra
 double penman(double, double, double, double, double, double, double);
 void   prepare_full_energy(HRU&, int, const soil_con_struct *, double *, double *, const ProgramState*);
 double priestley(double, double);
+void print_solver_summary(const std::vector<cell_info_struct>&);
 int put_data(cell_info_struct *, WriteOutputFormat*, OutputData*, const dmy_struct *, int, const ProgramState*);
 double read_arcinfo_value(char *, double, double);
 int    read_arcinfo_info(char *, double **, double **, int **);
-void   read_atmos_data(FILE *, int ncid, int, int, double **, soil_con_struct *, const ProgramState*);
-double **read_forcing_data(FILE **, int *ncids, global_param_struct, soil_con_struct *, const ProgramState*);
+void   read_atmos_data(FILE *, NetCDFForcingReader *, int, int, const global_param_struct *, double **, soil_con_struct *, const ProgramState*);
+double **read_forcing_data(FILE **, NetCDFForcingReader **, global_param_struct, soil_con_struct *, const ProgramState*);
 void read_initial_model_state(const char* initStateFilename, cell_info_struct *cell, int Nveg, int Ndist, const ProgramState *state);
-void   read_snowband(FILE *, soil_con_struct *, const int);
+void   read_snowband(FILE *, const ParamFileIndex *, soil_con_struct *, const int);
 void   read_snowmodel(atmos_data_struct *, FILE *, int, int, int, int);
 soil_con_struct read_soilparam(FILE *, char *, char *, char *, ProgramState*);
 soil_con_struct read_soilparam_arc(FILE *, char *, int *, char *, int,
     double *lat, double *lng, int *cellnum, ProgramState*);
 veg_lib_struct *read_veglib(FILE *, int *, char);
-int read_vegparam(FILE *, cell_info_struct&, const ProgramState*);
+int read_vegparam(FILE *, const ParamFileIndex *, cell_info_struct&, const ProgramState*);
 int redistribute_during_storm(HRU& hru, int rec, double Wdmax, double new_mu,
     double *max_moist, const ProgramState* state);
 void   redistribute_moisture(layer_data_struct *, double *, double *,
@@ -427,7 +437,7 @@ void set_max_min_hour(double *, int, int *, int *);
 
 void set_node_parameters(double *, double *, double *, double *, double *,
     double *, double *, double *, double *, double *, double *, double *,
-    double *, double ***, double *, double *, double *, double *, int, int,
+    double *, const UfwcTable **, double *, double *, double *, double *, int, int,
     char, const ProgramState*);
 out_data_file_struct *set_output_defaults(OutputData *, const ProgramState* state);
 
@@ -477,6 +487,7 @@ int glacier_melt(double Le, double NetShort, double Tgrnd, VegConditions& roughn
     glac_data_struct *glacier, const soil_con_struct*, const ProgramState *state);
 
 double soil_conductivity(double, double, double, double, double, double, double, double);
+double soil_conductivity_dWu(double, double, double, double, double, double, double, double);
 
 void   soil_thermal_calc(soil_con_struct *, layer_data_struct *,
 			 energy_bal_struct, double *, double *, double *,
@@ -526,7 +537,7 @@ double solve_glacier(double BareAlbedo,	double Tgrnd, double air_temp, double *A
 
 int solve_T_profile(double *T, double *T0, char *Tfbflag, int *Tfbcount,
     double *kappa, double *Cs, double *moist, double deltat, double *ice,
-    double Dp, double ** const * ufwc_table_node, int Nnodes, int *FIRST_SOLN,
+    double Dp, const UfwcTable * const * ufwc_table_node, int Nnodes, int *FIRST_SOLN,
     int NOFLUX, int EXP_TRANS, int veg_class, const soil_con_struct* soil_con,
     const ProgramState* state);
 
@@ -537,6 +548,7 @@ int solve_T_profile_implicit(double *, double *, double *, double *,
 double StabilityCorrection(double, double, double, double, double, double);
 void   store_moisture_for_debug(const HRU&, const soil_con_struct *, const ProgramState*);
 
+void copy_energy_bal(energy_bal_struct *, const energy_bal_struct *, int);
 int surface_fluxes(char, double, double, double, double, int, double*, double*,
     HRU&, double, double *, double *, VegConditions *,
     VegConditions &, double *, double *, double *, double *, VegConditions &,
@@ -558,6 +570,8 @@ int surface_fluxes_glac(double BareAlbedo, double height, double ice0,
     float fetch, const ProgramState *state);
 
 double svp(double);
+double svp_fast(double);
+double svp_reference(double);
 double svp_slope(double);
 
 void transpiration(layer_data_struct *, int, int, double, double, double,
@@ -578,7 +592,8 @@ void write_atmosdata(atmos_data_struct *, int, const ProgramState*);
 void write_dist_prcp(dist_prcp_struct *);
 void write_forcing_file(cell_info_struct*, int, WriteOutputFormat *, OutputData *, const ProgramState*, dmy_struct*);
 void write_layer(layer_data_struct *, int, int, const double*);
-void write_model_state(cell_info_struct* cell, const char* filename, const ProgramState  *state);
+void write_model_state(cell_info_struct* cell, StateIO* writer, const ProgramState  *state);
+void write_buffered_model_state(std::vector<StateIOBuffer>& buffers, const char* filename, const ProgramState *state);
 void processCellForStateFile(cell_info_struct* cell, StateIO* stream, const ProgramState *state);
 void write_snow_data(snow_data_struct, int, int);
 void write_soilparam(soil_con_struct *, const ProgramState*);
@@ -134,6 +134,8 @@
 #include <map>
 #include "GraphingEquation.h"
 #include "OutputData.h"
+#include "root_brent.h"
+#include "UfwcTable.h"
 
 /***** Model Constants *****/
 #define MAXSTRING    2048
@@ -163,6 +165,9 @@ inline bool IS_VALID(int a) { return (!IS_INVALID(a)); }
 #define BINARY 2
 #define NETCDF 3
 
+/***** Days of forcings processed on either side of a FORCING_WINDOW (MTCLIM's 30 day boxcar) *****/
+#define FORCING_WINDOW_MARGIN 30
+
 /***** Snow Albedo parametrizations *****/
 #define USACE   0
 #define SUN1999 1
@@ -561,6 +566,11 @@ OUT_GLAC_SUB_BAND       ,   /* Net sublimation of glacier ice [mm] */
 OUT_GLAC_INFLOW_BAND    ,   /* glacier water inflow from snow melt, ice melt and rainfall [mm] */
 OUT_GLAC_OUTFLOW_BAND   ,   /* glacier water outflow [mm] */
 
+// Solver Diagnostics (one element per SolverType, see SolverStats.h)
+OUT_SOLVER_CALLS        ,   /* number of solver calls */
+OUT_SOLVER_ITER         ,   /* number of solver iterations (function evaluations for root_brent) */
+OUT_SOLVER_FAIL         ,   /* number of solver calls which failed to converge or bracket the root */
+OUT_SOLVER_TIME         ,   /* wall time spent in the solver [s] */
 
 N_OUTVAR_TYPES          /* This term is always at the end of the enum so that it automatically counts the number of variables */
 };
@@ -606,6 +616,8 @@ DISP_ALL,
 
 /***** Data Structures *****/
 class WriteOutputFormat;
+class ParamFileIndex;
+class NetCDFForcingReader;
 
 /* The types of (stability-corrected) aerodynamic resistance (s/m) that were actually used in flux calculations. */
 struct AeroResistUsed {
@@ -617,13 +629,16 @@ struct AeroResistUsed {
 /** file structures **/
 typedef struct {
   FILE *forcing[2];     /* atmospheric forcing data files */
-  int forcing_ncid[2];
+  NetCDFForcingReader *forcing_reader[2]; /* readers for NetCDF forcing files, shared by all cells */
   FILE *globalparam;    /* global parameters file */
   FILE *lakeparam;      /* lake parameter file */
   FILE *snowband;       /* snow elevation band data file */
   FILE *soilparam;      /* soil parameters for all grid cells */
   FILE *veglib;         /* vegetation parameters for all vege types */
   FILE *vegparam;       /* fractional coverage info for grid cell */
+  ParamFileIndex *lakeparam_index; /* grid cell offsets into lakeparam */
+  ParamFileIndex *snowband_index;  /* grid cell offsets into snowband */
+  ParamFileIndex *vegparam_index;  /* grid cell offsets into vegparam */
 } filep_struct;
 
 typedef struct {
@@ -724,6 +739,7 @@ typedef struct {
   float  PREC_EXPT;      /* Exponential that controls the fraction of a grid cell that receives rain during a storm of given intensity */
   int    ROOT_ZONES;     /* Number of root zones used in simulation */
   char   QUICK_FLUX;     /* TRUE = Use Liang et al., 1999 formulation for ground heat flux, if FALSE use explicit finite difference method */
+  char   QUICK_FS;       /* TRUE = Use a linearized maximum unfrozen water content curve with frozen soil (see UfwcTable.h) */
   char   QUICK_SOLVE;    /* TRUE = Use Liang et al., 1999 formulation for iteration, but explicit finite difference method for final step. */
   char   SNOW_ALBEDO;    /* USACE: Use algorithm of US Army Corps of Engineers, 1956; SUN1999: Use algorithm of Sun et al., JGR, 1999 */
   char   SNOW_DENSITY;   /* DENS_BRAS: Use algorithm of Bras, 1990; DENS_SNTHRM: Use algorithm of SNTHRM89 adapted for 1-layer pack */
@@ -737,6 +753,10 @@ typedef struct {
                             FALSE = when iterations fail to converge, report an error
                                     and abort simulation for current grid cell
                             Default = TRUE */
+  char   WARM_START;     /* TRUE = solve for temperatures with a secant iteration started from the
+                                   previous temperature, falling back to Brent's method if it fails;
+                            FALSE = always use Brent's method from fixed bounds
+                            Default = FALSE */
   char   VP_INTERP;      /* How to disaggregate VP from daily to sub-daily;
                             TRUE = linearly interpolate between daily VP values, assuming they occur at the times of Tmin;
                             FALSE = hold VP constant at the daily value */
@@ -868,7 +888,9 @@ typedef struct {
   int    forcemonth[2]; /* month forcing files starts */
   int    forceskip[2];  /* number of model time steps to skip at the start ofthe forcing file */
   int    forceyear[2];  /* year forcing files start */
+  int    forcing_window;  /* Number of days of forcings kept in memory for each cell, 0 = the whole simulation */
   int    nrecs;         /* Number of time steps simulated */
+  int    output_queue_depth;  /* Number of filled NetCDF output buffers that may wait for the output writer thread, 0 = write without a thread */
   int    skipyear;      /* Number of years to skip before writing output data */
   int    startday;      /* Starting day of the simulation */
   int    starthour;     /* Starting hour of the simulation */
@@ -877,6 +899,7 @@ typedef struct {
   int    stateday;      /* Day of the simulation at which to save model state */
   int    statemonth;    /* Month of the simulation at which to save model state */
   int    stateyear;     /* Year of the simulation at which to save model state */
+  int    time_block;    /* Number of time steps each cell is advanced before the next cell, 0 = the output interval */
   int    glacierAccumStartYear;   /* Year of date to start glacier accumulation of mass balance */
   int    glacierAccumStartMonth;  /* Month of date to start glacier accumulation of mass balance */
   int    glacierAccumStartDay;    /* Day of date to start glacier accumulation of mass balance */
@@ -956,8 +979,8 @@ typedef struct {
   double  *Pfactor;                   /* Change in Precipitation due to elevation (fract) in each snow elevation band */
   double  *Tfactor;                   /* Change in temperature due to elevation (C) in each snow elevation band */
   char    *AboveTreeLine;             /* Flag to indicate if band is above the treeline */
-  double **ufwc_table_layer[MAX_LAYERS];
-  double **ufwc_table_node[MAX_NODES]; 
+  const UfwcTable *ufwc_table_layer[MAX_LAYERS]; /* QUICK_FS unfrozen water content table of each layer */
+  const UfwcTable *ufwc_table_node[MAX_NODES];   /* QUICK_FS unfrozen water content table of each node */
   float    elevation;                 /* grid cell elevation (m) */
   float    lat;                       /* grid cell central latitude */
   float    lng;                       /* grid cell central longitude */
@@ -1060,6 +1083,8 @@ typedef struct {
    SNOW_STEPs during the current model step and the value for the entire model
    step.  The latter is referred to by array[NR].  Looping over the SNOW_STEPs
    is done by for (i = 0; i < NF; i++) 
+   The arrays of all records are views into one buffer per variable
+   (nrecs * (NR+1) values, record major), see alloc_atmos().
 ***************************************************************************/
 typedef struct {
   double *air_temp;  /* air temperature (C) */
@@ -1143,18 +1168,11 @@ typedef struct {
   double  AlbedoOver;            /* albedo of intercepted snow (fract) */
   double  AlbedoUnder;           /* surface albedo (fraction) */
   double  Cs[2];                 /* heat capacity for top two layers (J/m^3/K) */
-  double  Cs_node[MAX_NODES];    /* heat capacity of the soil thermal nodes (J/m^3/K) */
   double  fdepth[MAX_FRONTS];    /* all simulated freezing front depths */
   char    frozen;                /* TRUE = frozen soil present */
-  double  ice_content[MAX_NODES];/* thermal node ice content */
   double  kappa[2];              /* soil thermal conductivity for top two layers (W/m/K) */
-  double  kappa_node[MAX_NODES]; /* thermal conductivity of the soil thermal nodes (W/m/K) */
-  double  moist[MAX_NODES];      /* thermal node moisture content */
   int     Nfrost;                /* number of simulated freezing fronts */
   int     Nthaw;                 /* number of simulated thawing fronts */
-  double  T[MAX_NODES];          /* thermal node temperatures (C) */
-  char    T_fbflag[MAX_NODES];   /* flag indicating if previous step's temperature was used */
-  int     T_fbcount[MAX_NODES];  /* running total number of times that previous step's temperature was used */
   int     T1_index;              /* soil node at the bottom of the top layer */
   double  Tcanopy;               /* temperature of the canopy air */
   char    Tcanopy_fbflag;        /* flag indicating if previous step's temperature was used */
@@ -1209,6 +1227,16 @@ typedef struct {
   double  glacier_flux;          /* glacier specific, used in surface_fluxes_glac (Wm-2) */
   double  deltaCC_glac;          /* glacier specific, change in glacier heat storage (Wm-2) */
   double  glacier_melt_energy;   /* energy used to thaw glacier ice (Wm-2) */
+  // Soil thermal node state, Nnode entries each, in the node storage of the cell (see
+  // alloc_cell_state()) or of the thread (EnergyWorkspace::energy_copy()). copy_energy_bal()
+  // copies the structure up to these pointers, so they must stay at the end.
+  double *Cs_node;               /* heat capacity of the soil thermal nodes (J/m^3/K) */
+  double *ice_content;           /* thermal node ice content */
+  double *kappa_node;            /* thermal conductivity of the soil thermal nodes (W/m/K) */
+  double *moist;                 /* thermal node moisture content */
+  double *T;                     /* thermal node temperatures (C) */
+  char   *T_fbflag;              /* flag indicating if previous step's temperature was used */
+  int    *T_fbcount;             /* running total number of times that previous step's temperature was used */
 } energy_bal_struct;
 
 /***********************************************************************
@@ -1398,8 +1426,11 @@ struct HRU {
   cell (for use with the distributed precipitation model).
 *****************************************************************/
 struct dist_prcp_struct{
-  lake_var_struct     lake_var;   /* Stores lake/wetland variables */
+  lake_var_struct    *lake_var = NULL;  /* Stores lake/wetland variables; NULL in cells without a lake */
+  char               *nodeStorage = NULL; /* Soil thermal node arrays of the energy balance structures (see alloc_cell_state()) */
   std::vector<HRU>    hruList;
+  std::vector<int>    activeHRUs;  /* indices into hruList of the HRUs which are solved, in order (see update_active_hrus()) */
+  std::vector<int>    glacierHRUs; /* indices into hruList of the glacier HRUs */
 };
 
 /*******************************************************
@@ -1526,9 +1557,9 @@ class WriteOutputContext; //added
   dynamics model. Previously "cell_data_struct" in vicNL.c
   ***********************************************************/
 struct cell_info_struct {
-  cell_info_struct() : isValid(TRUE), Cv_sum(0), atmos(NULL) {}
+  cell_info_struct() : isValid(TRUE), Cv_sum(0), atmos(NULL), atmos_first_rec(0) {}
   soil_con_struct    soil_con;
-  char               ErrStr[MAXSTRING];
+  std::string        ErrStr;    // error message of a failed cell, reported by the caller
   bool               isValid;   // to indicate if a cell was properly initialized for the model run
   double             Cv_sum;    /* total fraction of vegetation coverage */
   WriteOutputFormat *outputFormat;
@@ -1537,8 +1568,10 @@ struct cell_info_struct {
   lake_con_struct    lake_con;
   save_data_struct   save_data;
   atmos_data_struct *atmos;
+  int                atmos_first_rec; // record of atmos[0]; not 0 only when forcings are streamed (FORCING_WINDOW)
   CellBalanceErrors  cellErrors;
   FallBackStats      fallBackStats;
+  SolverStats        solverStats;  // work done by the iterative solvers for this cell
   GraphingEquation   gmbEquation;
 };
 
@@ -1548,7 +1581,10 @@ struct cell_info_struct {
   ********************************************************/
 class ProgramState {
 public:
-  ProgramState() { veg_lib = NULL; step_count = 0;}
+  ProgramState() : outvar_active(N_OUTVAR_TYPES, true), output_band_terms(true) {
+    veg_lib = NULL;
+    for (int varid = 0; varid < N_OUTVAR_TYPES; varid++) active_outvars.push_back(varid);
+  }
   global_param_struct  global_param;
   veg_lib_struct      *veg_lib;
   option_struct        options;
@@ -1563,13 +1599,15 @@ public:
   int max_num_HRUs = 0; // the greatest number of HRUs within a grid cell, across all grid cells in the current simulation
   int NR;  /* array index for atmos struct that indicates the model step average or sum */
   int NF;  /* array index loop counter limit for atmos struct that indicates the SNOW_STEP values */
-  int step_count; /* running count of how many time record steps have been taken since the last write to file (for temporal aggregation) */
   int dt_sec; /* simulation time step in seconds */
   int out_dt_sec; /* simulation output time step in seconds */
   int out_step_ratio; /* ratio between output time step and simulation time step */
   std::set<std::tuple<double, double>> modeled_cell_coordinates;
   bool *modeled_cell_mask;
   bool glacier_accum_started; /* flag indicating that glacier accumulation has started (after wind-up period) */
+  std::vector<int> active_outvars;  /* output variables written to the output files, plus those they are derived from; only these are aggregated by put_data() */
+  std::vector<bool> outvar_active;  /* outvar_active[varid] is true if varid is in active_outvars */
+  bool output_band_terms;           /* true if any band-specific variable (OUT_*_BAND) is active */
   void initialize_global();
   void initGrid(const std::vector<cell_info_struct>& cells);
   void initCellMask(const std::vector<cell_info_struct>& cells);
@@ -1581,6 +1619,7 @@ public:
   void display_current_settings(int, filenames_struct *);
   void open_debug();
   void update_max_num_HRUs(int numHRUs);
+  void build_output_plan(const out_data_file_struct *out_data_files);
 };
 
 struct VICException : public std::exception
@@ -5,10 +5,11 @@
 
 #include "vicNl.h"
 #include "StateIOContext.h"
+#include "StateIOBuffer.h"
 
 static char vcid[] = "$Id$";
 
-void write_model_state(cell_info_struct* cell, const char* filename, const ProgramState  *state)
+void write_model_state(cell_info_struct* cell, StateIO* writer, const ProgramState  *state)
 /*********************************************************************
   write_model_state      Keith Cherkauer           April 14, 2000
 
@@ -69,14 +70,13 @@ void write_model_state(cell_info_struct* cell, const char* filename, const Progr
 	      lake state data.  Now, if options.LAKES is TRUE, every grid cell
 	      will save lake state data.  If no lake is present, default NULL
 	      values will be stored.						TJB
+  The cell is written to writer, which is normally a StateIOBuffer
+  gathering the state of all cells for write_buffered_model_state().
 *********************************************************************/
 {
   int Nbands = state->options.SNOW_BAND;
   int numHRUs = cell->prcp.hruList.size();
 
-  StateIOContext context(filename, StateIO::Writer, state);
-  StateIO* writer = context.stream;
-
   /* write cell information */
   writer->initializeDimensionIndices();
   writer->notifyDimensionUpdate(StateVariables::LAT_DIM, latitudeToIndex(cell->soil_con.lat, state));
@@ -90,6 +90,25 @@ void write_model_state(cell_info_struct* cell, const char* filename, const Progr
   
 }
 
+/*
+ * Writes the state of all cells gathered (possibly by several threads) in the buffers to the state file,
+ * opening it only once, and then empties the buffers.
+ */
+void write_buffered_model_state(std::vector<StateIOBuffer>& buffers, const char* filename, const ProgramState *state) {
+  std::vector<const StateIOBuffer*> cellBuffers;
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    cellBuffers.push_back(&buffers[i]);
+  }
+
+  StateIOContext context(filename, StateIO::Writer, state);
+  context.stream->writeBuffered(cellBuffers);
+  context.stream->finalizeOutput();
+
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    buffers[i].clear();
+  }
+}
+
 /*
  * The processCellForStateFile function is used for reading and writing state files (depending on the type of StateIO stream).
  * This method is also generic for each different state format type (binary, ascii, netCDF). This means that adding a variable
@@ -286,6 +305,13 @@ void processCellForStateFile(cell_info_struct* cell, StateIO* stream, const Prog
   }
 
   if (state->options.LAKES) {
+    // Cells without a lake have no lake state (see alloc_cell_state()): the state of an empty
+    // lake is stored for them, and read back into it.
+    lake_var_struct noLake = lake_var_struct();
+    double noLakeT[MAX_NODES] = { 0 };
+    noLake.energy.T = noLakeT;
+    lake_var_struct* lake = cell->prcp.lake_var != NULL ? cell->prcp.lake_var : &noLake;
+
     for (int dist = 0; dist < Ndist; dist++) {
       stream->notifyDimensionUpdate(DIST_DIM, dist);
       // Store both wet and dry fractions if using distributed precipitation
@@ -293,11 +319,11 @@ void processCellForStateFile(cell_info_struct* cell, StateIO* stream, const Prog
       /* Write total soil moisture */
       double moistValues [state->options.Nlayer];
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
-        moistValues[lidx] = cell->prcp.lake_var.soil.layer[lidx].moist;   // Write specific.
+        moistValues[lidx] = lake->soil.layer[lidx].moist;   // Write specific.
       }
       stream->process(moistValues, state->options.Nlayer, LAKE_LAYER_MOIST);
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
-        cell->prcp.lake_var.soil.layer[lidx].moist = moistValues[lidx];   // Read specific.
+        lake->soil.layer[lidx].moist = moistValues[lidx];   // Read specific.
       }
 
       /* Write average ice content */
@@ -305,63 +331,63 @@ void processCellForStateFile(cell_info_struct* cell, StateIO* stream, const Prog
       double avgIceContent [state->options.Nlayer * FROST_SUBAREAS];
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
         for (int frost_area = 0; frost_area < FROST_SUBAREAS; frost_area++ ) {
-          avgIceContent[(lidx * FROST_SUBAREAS) + frost_area] = cell->prcp.lake_var.soil.layer[lidx].soil_ice[frost_area];  // Write specific.
+          avgIceContent[(lidx * FROST_SUBAREAS) + frost_area] = lake->soil.layer[lidx].soil_ice[frost_area];  // Write specific.
         }
       }
       stream->process(avgIceContent, state->options.Nlayer * FROST_SUBAREAS, LAKE_LAYER_SOIL_ICE);
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
         for (int frost_area = 0; frost_area < FROST_SUBAREAS; frost_area++ ) {
-          cell->prcp.lake_var.soil.layer[lidx].soil_ice[frost_area] = avgIceContent[(lidx * FROST_SUBAREAS) + frost_area];  // Read specific.
+          lake->soil.layer[lidx].soil_ice[frost_area] = avgIceContent[(lidx * FROST_SUBAREAS) + frost_area];  // Read specific.
         }
       }
 #else
       double avgIceContent [state->options.Nlayer];
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
-        avgIceContent[lidx] = cell->prcp.lake_var.soil.layer[lidx].soil_ice;  // Write specific.
+        avgIceContent[lidx] = lake->soil.layer[lidx].soil_ice;  // Write specific.
       }
       stream->process(avgIceContent, state->options.Nlayer, LAKE_LAYER_ICE_CONTENT);
       for (int lidx = 0; lidx < state->options.Nlayer; lidx++) {
-        cell->prcp.lake_var.soil.layer[lidx].soil_ice = avgIceContent[lidx];  // Read specific.
+        lake->soil.layer[lidx].soil_ice = avgIceContent[lidx];  // Read specific.
       }
 #endif // SPATIAL_FROST
     }
 
     /* Write snow data */
-    stream->process(&cell->prcp.lake_var.snow.last_snow,   1, LAKE_SNOW_LAST_SNOW);
-    stream->process(&cell->prcp.lake_var.snow.MELTING,     1, LAKE_SNOW_MELTING);
-    stream->process(&cell->prcp.lake_var.snow.coverage,    1, LAKE_SNOW_COVERAGE);
-    stream->process(&cell->prcp.lake_var.snow.swq,         1, LAKE_SNOW_SWQ);
-    stream->process(&cell->prcp.lake_var.snow.surf_temp,   1, LAKE_SNOW_SURF_TEMP);
-    stream->process(&cell->prcp.lake_var.snow.surf_water,  1, LAKE_SNOW_SURF_WATER);
-    stream->process(&cell->prcp.lake_var.snow.pack_temp,   1, LAKE_SNOW_PACK_TEMP);
-    stream->process(&cell->prcp.lake_var.snow.pack_water,  1, LAKE_SNOW_PACK_WATER);
-    stream->process(&cell->prcp.lake_var.snow.density,     1, LAKE_SNOW_DENSITY);
-    stream->process(&cell->prcp.lake_var.snow.coldcontent, 1, LAKE_SNOW_COLD_CONTENT);
-    stream->process(&cell->prcp.lake_var.snow.snow_canopy, 1, LAKE_SNOW_CANOPY);
+    stream->process(&lake->snow.last_snow,   1, LAKE_SNOW_LAST_SNOW);
+    stream->process(&lake->snow.MELTING,     1, LAKE_SNOW_MELTING);
+    stream->process(&lake->snow.coverage,    1, LAKE_SNOW_COVERAGE);
+    stream->process(&lake->snow.swq,         1, LAKE_SNOW_SWQ);
+    stream->process(&lake->snow.surf_temp,   1, LAKE_SNOW_SURF_TEMP);
+    stream->process(&lake->snow.surf_water,  1, LAKE_SNOW_SURF_WATER);
+    stream->process(&lake->snow.pack_temp,   1, LAKE_SNOW_PACK_TEMP);
+    stream->process(&lake->snow.pack_water,  1, LAKE_SNOW_PACK_WATER);
+    stream->process(&lake->snow.density,     1, LAKE_SNOW_DENSITY);
+    stream->process(&lake->snow.coldcontent, 1, LAKE_SNOW_COLD_CONTENT);
+    stream->process(&lake->snow.snow_canopy, 1, LAKE_SNOW_CANOPY);
 
     /* Write soil thermal node temperatures */
-    stream->process(cell->prcp.lake_var.energy.T, state->options.Nnode, LAKE_ENERGY_T);
+    stream->process(lake->energy.T, state->options.Nnode, LAKE_ENERGY_T);
 
     /* Write lake-specific variables */
-    stream->process(&cell->prcp.lake_var.activenod, 1, LAKE_ACTIVENOD);
-    stream->process(&cell->prcp.lake_var.dz, 1, LAKE_DZ);
-    stream->process(&cell->prcp.lake_var.surfdz, 1, LAKE_SURFDZ);
-    stream->process(&cell->prcp.lake_var.ldepth, 1, LAKE_LDEPTH);
-    stream->process(cell->prcp.lake_var.surface, cell->prcp.lake_var.activenod, LAKE_SURFACE);
-    stream->process(&cell->prcp.lake_var.sarea, 1, LAKE_SAREA);
-    stream->process(&cell->prcp.lake_var.volume, 1, LAKE_VOLUME);
-    stream->process(cell->prcp.lake_var.temp, cell->prcp.lake_var.activenod, LAKE_TEMP);
-    stream->process(&cell->prcp.lake_var.tempavg, 1, LAKE_TEMPAVG);
-    stream->process(&cell->prcp.lake_var.areai, 1, LAKE_AREAI);
-    stream->process(&cell->prcp.lake_var.new_ice_area, 1, LAKE_NEW_ICE_AREA);
-    stream->process(&cell->prcp.lake_var.ice_water_eq, 1, LAKE_ICE_WATER_EQ);
-    stream->process(&cell->prcp.lake_var.hice, 1, LAKE_HICE);
-    stream->process(&cell->prcp.lake_var.tempi, 1, LAKE_TEMPI);
-    stream->process(&cell->prcp.lake_var.swe, 1, LAKE_SWE);
-    stream->process(&cell->prcp.lake_var.surf_temp, 1, LAKE_SURF_TEMP);
-    stream->process(&cell->prcp.lake_var.pack_temp, 1, LAKE_PACK_TEMP);
-    stream->process(&cell->prcp.lake_var.SAlbedo, 1, LAKE_SALBEDO);
-    stream->process(&cell->prcp.lake_var.sdepth, 1, LAKE_SDEPTH);
+    stream->process(&lake->activenod, 1, LAKE_ACTIVENOD);
+    stream->process(&lake->dz, 1, LAKE_DZ);
+    stream->process(&lake->surfdz, 1, LAKE_SURFDZ);
+    stream->process(&lake->ldepth, 1, LAKE_LDEPTH);
+    stream->process(lake->surface, lake->activenod, LAKE_SURFACE);
+    stream->process(&lake->sarea, 1, LAKE_SAREA);
+    stream->process(&lake->volume, 1, LAKE_VOLUME);
+    stream->process(lake->temp, lake->activenod, LAKE_TEMP);
+    stream->process(&lake->tempavg, 1, LAKE_TEMPAVG);
+    stream->process(&lake->areai, 1, LAKE_AREAI);
+    stream->process(&lake->new_ice_area, 1, LAKE_NEW_ICE_AREA);
+    stream->process(&lake->ice_water_eq, 1, LAKE_ICE_WATER_EQ);
+    stream->process(&lake->hice, 1, LAKE_HICE);
+    stream->process(&lake->tempi, 1, LAKE_TEMPI);
+    stream->process(&lake->swe, 1, LAKE_SWE);
+    stream->process(&lake->surf_temp, 1, LAKE_SURF_TEMP);
+    stream->process(&lake->pack_temp, 1, LAKE_PACK_TEMP);
+    stream->process(&lake->SAlbedo, 1, LAKE_SALBEDO);
+    stream->process(&lake->sdepth, 1, LAKE_SDEPTH);
 
     stream->processNewline();
 